@@ -0,0 +1,502 @@
+#include "scatter_plot.h"
+#include "line_plot.h"
+#include "histogram_plot.h"
+#include "render_cache.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <functional>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+// Micro-benchmarks for individual rendering primitives
+//
+// Methodology:
+// - Every benchmark runs a fixed ("pinned") number of iterations per sample, so
+//   results of different builds are directly comparable
+// - Warm-up samples are executed and discarded before measuring
+// - Samples further than OUTLIER_MADS median absolute deviations from the
+//   median are rejected; the median of the remaining samples is reported
+//
+// Usage: micro_benchmarks [filter] [--samples N] [--cpu N] [--csv]
+
+using namespace plotlib;
+
+namespace {
+
+const int WARMUP_SAMPLES = 3;
+const int DEFAULT_SAMPLES = 15;
+const double OUTLIER_MADS = 3.0;
+
+/**
+ * @brief Prevent the compiler from optimizing away a computed value
+ */
+template<typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct Benchmark {
+    std::string name;
+    size_t iterations;                      ///< Pinned iterations per sample
+    std::function<void(size_t)> run;        ///< Runs the given number of iterations
+};
+
+struct BenchmarkResult {
+    double median_ns = 0.0;   ///< Median time per iteration of the kept samples
+    double min_ns = 0.0;      ///< Fastest kept sample, per iteration
+    double mad_ns = 0.0;      ///< Median absolute deviation of all samples, per iteration
+    int kept = 0;             ///< Samples used for the result
+    int rejected = 0;         ///< Samples rejected as outliers
+};
+
+double median_of(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    size_t mid = values.size() / 2;
+    return (values.size() % 2) ? values[mid] : 0.5 * (values[mid - 1] + values[mid]);
+}
+
+BenchmarkResult measure(const Benchmark& benchmark, int sample_count) {
+    for (int i = 0; i < WARMUP_SAMPLES; ++i) {
+        benchmark.run(benchmark.iterations);
+    }
+
+    std::vector<double> samples;
+    samples.reserve(sample_count);
+    for (int i = 0; i < sample_count; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        benchmark.run(benchmark.iterations);
+        auto end = std::chrono::steady_clock::now();
+        double total_ns = std::chrono::duration<double, std::nano>(end - start).count();
+        samples.push_back(total_ns / benchmark.iterations);
+    }
+
+    double median = median_of(samples);
+    std::vector<double> deviations;
+    for (double sample : samples) {
+        deviations.push_back(std::abs(sample - median));
+    }
+    double mad = median_of(deviations);
+
+    std::vector<double> kept;
+    for (double sample : samples) {
+        if (mad == 0.0 || std::abs(sample - median) <= OUTLIER_MADS * mad) {
+            kept.push_back(sample);
+        }
+    }
+
+    BenchmarkResult result;
+    result.median_ns = median_of(kept);
+    result.min_ns = *std::min_element(kept.begin(), kept.end());
+    result.mad_ns = mad;
+    result.kept = static_cast<int>(kept.size());
+    result.rejected = sample_count - result.kept;
+    return result;
+}
+
+// Expose the protected hot paths of each plot type to the benchmarks
+
+class BenchScatterPlot : public ScatterPlot {
+public:
+    using ScatterPlot::ScatterPlot;
+    using ScatterPlot::calculate_bounds;
+    using ScatterPlot::transform_point;
+    using ScatterPlot::draw_marker;
+    using ScatterPlot::format_number;
+    using ScatterPlot::generate_nice_ticks;
+    using ScatterPlot::collect_legend_items;
+    using ScatterPlot::screen_coordinates;
+    using ScatterPlot::draw_marker_run;
+    using ScatterPlot::set_bounds;
+};
+
+class BenchLinePlot : public LinePlot {
+public:
+    using LinePlot::LinePlot;
+    using LinePlot::calculate_bounds;
+    using LinePlot::collect_legend_items;
+    using LinePlot::draw_reference_lines;
+    using LinePlot::draw_annotations;
+};
+
+class BenchHistogramPlot : public HistogramPlot {
+public:
+    using HistogramPlot::HistogramPlot;
+    using HistogramPlot::calculate_bins;
+    using HistogramPlot::calculate_counts;
+    using HistogramPlot::collect_legend_items;
+    using HistogramPlot::draw_data;
+    using HistogramPlot::render_cache_key;
+};
+
+std::vector<double> wave(size_t count, double frequency, double scale) {
+    std::vector<double> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = scale * std::sin(frequency * i) + 0.3 * scale * std::sin(7.3 * frequency * i);
+    }
+    return values;
+}
+
+const char* marker_name(MarkerType type) {
+    switch (type) {
+        case MarkerType::CIRCLE: return "circle";
+        case MarkerType::CROSS: return "cross";
+        case MarkerType::SQUARE: return "square";
+        case MarkerType::TRIANGLE: return "triangle";
+    }
+    return "unknown";
+}
+
+std::vector<Benchmark> build_benchmarks(cairo_t* cr) {
+    std::vector<Benchmark> benchmarks;
+
+    // Shared fixtures; captured by reference from static storage so setup is not timed
+    static BenchScatterPlot scatter(800, 600);
+    static BenchLinePlot line(800, 600);
+    static BenchLinePlot annotated(800, 600);
+    static BenchHistogramPlot histogram(800, 600);
+    static std::vector<double> histogram_data = wave(100000, 0.37, 3.0);
+    static std::vector<double> histogram_bins;
+    static BenchHistogramPlot fine_histogram(800, 600);
+    static BenchHistogramPlot sub_pixel_histogram(800, 600);
+
+    scatter.add_scatter(wave(1000, 0.01, 5.0), wave(1000, 0.013, 3.0), "Points", "blue");
+    for (int i = 0; i < 7; ++i) {
+        scatter.add_scatter({0.0, 1.0}, {0.0, 1.0}, "Series " + std::to_string(i));
+    }
+    std::vector<int> labels(600);
+    for (size_t i = 0; i < labels.size(); ++i) {
+        labels[i] = (i % 17 == 0) ? -1 : static_cast<int>(i % 5);
+    }
+    scatter.add_clusters(wave(600, 0.05, 4.0), wave(600, 0.031, 4.0), labels);
+    scatter.calculate_bounds();
+
+    for (int i = 0; i < 8; ++i) {
+        line.add_line({0.0, 1.0, 2.0}, {1.0, 0.0, 1.0}, "Line " + std::to_string(i));
+    }
+    line.add_horizontal_line(0.5, "Threshold", "red");
+    annotated.add_line(wave(2000, 0.01, 5.0), wave(2000, 0.013, 3.0), "Signal", "blue");
+    const char* event_colors[] = {"red", "orange", "purple", "black"};
+    for (int i = 0; i < 2000; ++i) {
+        annotated.add_vertical_line(-5.0 + i * 0.005, "Event", event_colors[i % 4]);
+        annotated.add_annotation(-5.0 + i * 0.005, 3.0 * std::sin(i * 0.1), "Event " + std::to_string(i),
+                                 event_colors[i % 4]);
+    }
+    annotated.calculate_bounds();
+    histogram.add_histogram(histogram_data, "Values", "green", 40);
+    histogram_bins = histogram.calculate_bins(histogram_data, 40);
+    fine_histogram.add_histogram(histogram_data, "Values", "blue", 4096);
+    sub_pixel_histogram.add_histogram(histogram_data, "Values", "blue", 100000);
+
+    const MarkerType marker_types[] = {MarkerType::CIRCLE, MarkerType::CROSS, MarkerType::SQUARE, MarkerType::TRIANGLE};
+    for (MarkerType type : marker_types) {
+        benchmarks.push_back({std::string("draw_marker/") + marker_name(type), 20000, [cr, type](size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                double x = 40.0 + static_cast<double>(i % 720);
+                double y = 40.0 + static_cast<double>((i * 7) % 520);
+                scatter.draw_marker(cr, x, y, type, 3.0, 0.0, 0.0, 1.0, 0.7);
+            }
+        }});
+    }
+
+    benchmarks.push_back({"transform_point", 1000000, [](size_t n) {
+        double sx = 0.0, sy = 0.0, sum = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            scatter.transform_point(static_cast<double>(i % 1000) * 0.01, static_cast<double>(i % 777) * 0.01, sx, sy);
+            sum += sx + sy;
+        }
+        do_not_optimize(sum);
+    }});
+
+    benchmarks.push_back({"generate_nice_ticks", 100000, [](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            double span = 1.0 + static_cast<double>(i % 100) * 13.7;
+            std::vector<double> ticks = scatter.generate_nice_ticks(-span * 0.3, span);
+            do_not_optimize(ticks);
+        }
+    }});
+
+    benchmarks.push_back({"format_number", 200000, [](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            std::string text = scatter.format_number(static_cast<double>(i % 2000) * 0.25 - 100.0);
+            do_not_optimize(text);
+        }
+    }});
+
+    benchmarks.push_back({"calculate_bins/100k", 200, [](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            std::vector<double> bins = histogram.calculate_bins(histogram_data, 40);
+            do_not_optimize(bins);
+        }
+    }});
+
+    benchmarks.push_back({"calculate_counts/100k", 200, [](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            std::vector<int> counts = histogram.calculate_counts(histogram_data, histogram_bins);
+            do_not_optimize(counts);
+        }
+    }});
+
+    static std::vector<uint16_t> integer_data_u16(1000000);
+    static std::vector<int32_t> integer_data_i32(1000000);
+    for (size_t i = 0; i < integer_data_u16.size(); ++i) {
+        integer_data_u16[i] = static_cast<uint16_t>((i * 7919) % 4096);
+        integer_data_i32[i] = static_cast<int32_t>((i * 7919) % 100000) - 50000;
+    }
+
+    benchmarks.push_back({"add_integer_histogram/uint16_1m", 20, [](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            HistogramPlot plot(800, 600);
+            plot.add_integer_histogram(integer_data_u16, "Values", "blue", 40);
+            do_not_optimize(plot);
+        }
+    }});
+
+    benchmarks.push_back({"add_integer_histogram/int32_1m", 20, [](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            HistogramPlot plot(800, 600);
+            plot.add_integer_histogram(integer_data_i32, "Values", "blue", 40);
+            do_not_optimize(plot);
+        }
+    }});
+
+    benchmarks.push_back({"color_to_style", 200000, [](size_t n) {
+        static const char* names[] = {"blue", "green", "orange", "purple", "cyan", "magenta", "yellow", "red", "black", "unknown"};
+        for (size_t i = 0; i < n; ++i) {
+            PlotStyle style = PlotManager::color_to_style(names[i % 10]);
+            do_not_optimize(style);
+        }
+    }});
+
+    benchmarks.push_back({"collect_legend_items/scatter_clusters", 20000, [](size_t n) {
+        std::vector<LegendItem> items;
+        for (size_t i = 0; i < n; ++i) {
+            items.clear();
+            scatter.collect_legend_items(items);
+            do_not_optimize(items);
+        }
+    }});
+
+    benchmarks.push_back({"collect_legend_items/line", 20000, [](size_t n) {
+        std::vector<LegendItem> items;
+        for (size_t i = 0; i < n; ++i) {
+            items.clear();
+            line.collect_legend_items(items);
+            do_not_optimize(items);
+        }
+    }});
+
+    static CompressedSeries telemetry;
+    {
+        std::vector<double> timestamps(1000000);
+        std::vector<double> values = wave(timestamps.size(), 0.001, 20.0);
+        for (size_t i = 0; i < timestamps.size(); ++i) {
+            timestamps[i] = 1700000000.0 + i * 10.0;
+            values[i] = std::round(values[i] * 100.0) / 100.0;
+        }
+        telemetry.append(timestamps.data(), values.data(), timestamps.size());
+    }
+
+    // Streaming decode of all blocks, the per-render cost of a compressed line before transforms
+    benchmarks.push_back({"decode_block/telemetry_1m", 20, [](size_t n) {
+        std::vector<double> xs(CompressedSeries::BLOCK_POINTS), ys(CompressedSeries::BLOCK_POINTS);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t b = 0; b < telemetry.block_count(); ++b) {
+                telemetry.decode_block(b, xs.data(), ys.data());
+            }
+            do_not_optimize(ys);
+        }
+    }});
+
+    // Vector export path of a dense line: 1M samples across 700 device units
+    static std::vector<float> dense_path;
+    for (size_t i = 0; i < 1000000; ++i) {
+        dense_path.push_back(static_cast<float>(50.0 + i * 0.0007));
+        dense_path.push_back(static_cast<float>(300.0 + 120.0 * std::sin(i * 0.00005) + 30.0 * std::sin(i * 0.00041)));
+    }
+    benchmarks.push_back({"simplify_path/1m_tolerance_0.1", 10, [](size_t n) {
+        static PathSimplifier simplifier;
+        for (size_t i = 0; i < n; ++i) {
+            const std::vector<size_t>& kept = simplifier.simplify(dense_path.data(), dense_path.size() / 2, 0.1);
+            do_not_optimize(kept);
+        }
+    }});
+
+    static std::vector<double> screen_x = wave(100000, 0.01, 5.0);
+    static std::vector<double> screen_y = wave(100000, 0.013, 3.0);
+
+    // Re-render with an unchanged view (style or label change) versus a changed view
+    benchmarks.push_back({"screen_coordinates/100k_cached", 2000, [](size_t n) {
+        static ScreenCoordinates cache;
+        for (size_t i = 0; i < n; ++i) {
+            const float* xy = scatter.screen_coordinates(cache, screen_x.data(), screen_y.data(), screen_x.size());
+            do_not_optimize(xy);
+        }
+    }});
+
+    benchmarks.push_back({"screen_coordinates/100k_view_change", 200, [](size_t n) {
+        static ScreenCoordinates cache;
+        for (size_t i = 0; i < n; ++i) {
+            scatter.set_bounds(-6.0 - (i & 1), 6.0, -4.0, 4.0);
+            const float* xy = scatter.screen_coordinates(cache, screen_x.data(), screen_y.data(), screen_x.size());
+            do_not_optimize(xy);
+        }
+        scatter.calculate_bounds();
+    }});
+
+    // Dense scatter of quantized readings: 100k markers on about 10k distinct positions
+    static std::vector<float> dense_screen;
+    for (size_t i = 0; i < screen_x.size(); ++i) {
+        double x, y;
+        scatter.transform_point(std::round(screen_x[i] * 10.0) / 10.0, std::round(screen_y[i] * 10.0) / 10.0, x, y);
+        dense_screen.push_back(static_cast<float>(x));
+        dense_screen.push_back(static_cast<float>(y));
+    }
+    const double marker_alphas[] = {0.8, 1.0};
+    for (double alpha : marker_alphas) {
+        std::string name = alpha < 1.0 ? "draw_marker_run/100k_dense_translucent" : "draw_marker_run/100k_dense_opaque";
+        benchmarks.push_back({name, 20, [cr, alpha](size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                scatter.draw_marker_run(cr, dense_screen.data(), 0, dense_screen.size() / 2, 1, MarkerType::CIRCLE,
+                                        3.0, 0.0, 0.0, 1.0, alpha);
+            }
+        }});
+    }
+
+    // Line markers of the same dense scatter, thinned to one marker diameter
+    benchmarks.push_back({"draw_marker_run/100k_thinned", 20, [cr](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            scatter.draw_marker_run(cr, dense_screen.data(), 0, dense_screen.size() / 2, 1, MarkerType::CIRCLE,
+                                    3.0, 0.0, 0.0, 1.0, 0.8, 6.0);
+        }
+    }});
+
+    benchmarks.push_back({"draw_reference_lines/2000_lines_4_styles", 200, [cr](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            annotated.draw_reference_lines(cr);
+        }
+    }});
+
+    benchmarks.push_back({"draw_annotations/2000_labels", 50, [cr](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            annotated.draw_annotations(cr);
+        }
+    }});
+
+    benchmarks.push_back({"draw_data/histogram_4096_bins", 200, [cr](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            fine_histogram.draw_data(cr);
+        }
+    }});
+
+    benchmarks.push_back({"draw_data/histogram_100k_bins", 50, [cr](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            sub_pixel_histogram.draw_data(cr);
+        }
+    }});
+
+    // Compare with draw_data/histogram_100k_bins: a cache key must cost far less than a render
+    benchmarks.push_back({"render_cache_key/histogram_100k_bins", 200, [](size_t n) {
+        RenderKey key;
+        for (size_t i = 0; i < n; ++i) {
+            sub_pixel_histogram.render_cache_key(RenderFormat::PNG, key);
+            do_not_optimize(key);
+        }
+    }});
+
+    benchmarks.push_back({"collect_legend_items/histogram", 20000, [](size_t n) {
+        std::vector<LegendItem> items;
+        for (size_t i = 0; i < n; ++i) {
+            items.clear();
+            histogram.collect_legend_items(items);
+            do_not_optimize(items);
+        }
+    }});
+
+    return benchmarks;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string filter;
+    int sample_count = DEFAULT_SAMPLES;
+    int cpu = -1;
+    bool csv = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--samples" && i + 1 < argc) {
+            sample_count = std::max(3, std::atoi(argv[++i]));
+        } else if (arg == "--cpu" && i + 1 < argc) {
+            cpu = std::atoi(argv[++i]);
+        } else if (arg == "--csv") {
+            csv = true;
+        } else if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: " << argv[0] << " [filter] [--samples N] [--cpu N] [--csv]" << std::endl;
+            return 0;
+        } else {
+            filter = arg;
+        }
+    }
+
+    if (cpu >= 0) {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            std::cerr << "Warning: Cannot pin to CPU " << cpu << std::endl;
+        }
+#else
+        std::cerr << "Warning: CPU pinning is only supported on Linux" << std::endl;
+#endif
+    }
+
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 800, 600);
+    cairo_t* cr = cairo_create(surface);
+
+    if (csv) {
+        std::cout << "benchmark,iterations,median_ns,min_ns,mad_ns,kept,rejected" << std::endl;
+    } else {
+        std::cout << "=== PlotLib Micro-Benchmarks ===" << std::endl;
+        std::cout << sample_count << " samples, " << WARMUP_SAMPLES << " warm-up, outliers beyond "
+                  << OUTLIER_MADS << " MAD rejected\n" << std::endl;
+        std::cout << std::left << std::setw(40) << "Benchmark" << std::right
+                  << std::setw(12) << "median ns" << std::setw(12) << "min ns"
+                  << std::setw(10) << "MAD ns" << std::setw(10) << "outliers" << std::endl;
+    }
+
+    for (const auto& benchmark : build_benchmarks(cr)) {
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos) continue;
+
+        BenchmarkResult result = measure(benchmark, sample_count);
+        if (csv) {
+            std::cout << benchmark.name << "," << benchmark.iterations << "," << result.median_ns << ","
+                      << result.min_ns << "," << result.mad_ns << "," << result.kept << ","
+                      << result.rejected << std::endl;
+        } else {
+            std::cout << std::left << std::setw(40) << benchmark.name << std::right << std::fixed
+                      << std::setprecision(1) << std::setw(12) << result.median_ns
+                      << std::setw(12) << result.min_ns << std::setw(10) << result.mad_ns
+                      << std::setw(10) << result.rejected << std::endl;
+        }
+    }
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+    return 0;
+}
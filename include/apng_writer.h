@@ -0,0 +1,145 @@
+/**
+ * @file apng_writer.h
+ * @brief Animated PNG export for sequences of rendered frames
+ * @author PlotLib Contributors
+ * @version 1.0.0
+ * @date 2025-06-08
+ *
+ * This file contains the ApngWriter class which writes a sequence of renders
+ * into one animated PNG file. Each frame is compared with the previous one
+ * and only the bounding rectangle of the changed pixels is stored, so static
+ * parts such as axes, titles and legends cost nothing after the first frame.
+ * Frames are filtered and deflated on worker threads while the caller
+ * renders the next frame.
+ *
+ * Viewers without APNG support show the first frame as a still image.
+ */
+
+#ifndef PLOTLIB_APNG_WRITER_H
+#define PLOTLIB_APNG_WRITER_H
+
+#include "plot_manager.h"
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace plotlib {
+
+/**
+ * @brief Streaming APNG writer
+ *
+ * @example
+ * @code
+ * LinePlot plot(800, 600);
+ * ApngWriter writer("animation.png", 800, 600, 40);  // 25 frames per second
+ * for (int step = 0; step < 250; ++step) {
+ *     double t = step * 0.1;
+ *     plot.append_to_series(0, {t}, {std::sin(t)});
+ *     writer.add_frame(plot);
+ * }
+ * writer.finish();
+ * @endcode
+ */
+class ApngWriter {
+private:
+    /**
+     * @brief Frame waiting for, or finished with, compression
+     */
+    struct PendingFrame {
+        uint32_t x_offset = 0;
+        uint32_t y_offset = 0;
+        uint32_t frame_width = 0;
+        uint32_t frame_height = 0;
+        uint32_t delay_ms = 0;
+        std::future<std::vector<unsigned char>> compressed; ///< Deflated, filtered scanlines
+    };
+
+    std::string filename;
+    FILE* file = nullptr;
+    int width;
+    int height;
+    int default_delay_ms;
+    uint32_t loops;
+    uint32_t frame_count = 0;
+    uint32_t sequence_number = 0;
+    size_t max_pending;
+    std::vector<uint32_t> previous;       ///< Previous frame, ARGB32 words
+    std::deque<PendingFrame> pending;     ///< Frames in submission order, oldest first
+    bool failed = false;
+    bool finished = false;
+
+    bool write_chunk(const char type[4], const unsigned char* data, size_t size);
+    bool write_frame(PendingFrame& frame);
+    bool write_oldest();
+
+public:
+    /**
+     * @brief Create a writer and write the PNG header
+     * @param filename Output file
+     * @param width Frame width in pixels
+     * @param height Frame height in pixels
+     * @param delay_ms Default display time of each frame in milliseconds (default: 40)
+     * @param loops Number of times the animation plays, 0 for endless (default: 0)
+     */
+    ApngWriter(const std::string& filename, int width, int height, int delay_ms = 40, int loops = 0);
+
+    /**
+     * @brief Finishes the file if finish() was not called explicitly
+     */
+    ~ApngWriter();
+
+    ApngWriter(const ApngWriter&) = delete;
+    ApngWriter& operator=(const ApngWriter&) = delete;
+
+    /**
+     * @brief Check whether the output file could be opened
+     * @return true if the writer is usable
+     */
+    bool is_open() const { return file != nullptr && !failed; }
+
+    /**
+     * @brief Append a frame from a raw pixel buffer
+     * @param pixels width * height ARGB32 pixels, as produced by render_to_buffer
+     * @param delay_ms Display time in milliseconds, negative for the default
+     * @return true if successful, false otherwise
+     *
+     * A frame identical to the previous one extends the previous frame's
+     * display time instead of being stored.
+     */
+    bool add_frame(const std::vector<unsigned char>& pixels, int delay_ms = -1);
+
+    /**
+     * @brief Render a plot and append it as a frame
+     * @param plot Plot with the writer's width and height
+     * @param delay_ms Display time in milliseconds, negative for the default
+     * @return true if successful, false otherwise
+     */
+    bool add_frame(PlotManager& plot, int delay_ms = -1);
+
+    /**
+     * @brief Render a subplot grid and append it as a frame
+     * @param manager Subplot manager with the writer's width and height
+     * @param delay_ms Display time in milliseconds, negative for the default
+     * @return true if successful, false otherwise
+     */
+    bool add_frame(SubplotManager& manager, int delay_ms = -1);
+
+    /**
+     * @brief Write all pending frames and complete the file
+     * @return true if the file was written completely, false otherwise
+     */
+    bool finish();
+
+    /**
+     * @brief Number of frames stored so far (merged identical frames count once)
+     * @return Frame count
+     */
+    uint32_t get_frame_count() const { return frame_count; }
+};
+
+} // namespace plotlib
+
+#endif // PLOTLIB_APNG_WRITER_H
@@ -0,0 +1,153 @@
+/**
+ * @file compressed_series.h
+ * @brief Compressed in-memory storage for long line series
+ * @author PlotLib Contributors
+ * @version 1.0.0
+ * @date 2025-06-08
+ *
+ * This file contains the CompressedSeries class which stores a line series
+ * in blocks of up to BLOCK_POINTS points using the Gorilla time series
+ * encoding: X values that are whole numbers (timestamps, sample indices) are
+ * stored as delta-of-deltas, other X values and all Y values as the XOR of
+ * consecutive IEEE doubles. The encoding is lossless. Regularly sampled
+ * telemetry typically needs a few bytes per point instead of sixteen.
+ *
+ * Rendering decodes one block at a time into a small scratch buffer and
+ * feeds it straight into the transform and decimation pipeline, so the
+ * decoded series never exists in memory as a whole.
+ *
+ * Bit stream per block (most significant bit first):
+ * - First point: X and Y as raw 64-bit patterns
+ * - Integer X: '0' for an unchanged delta, else '10' + 7 bits, '110' + 9 bits,
+ *   '1110' + 12 bits or '1111' + 64 bits of delta-of-delta
+ * - XOR-coded values: '0' for a repeated value, '10' + bits within the
+ *   previous leading/trailing zero window, or '11' + 6 bits leading zeros +
+ *   6 bits length - 1 + the meaningful bits
+ */
+
+#ifndef PLOTLIB_COMPRESSED_SERIES_H
+#define PLOTLIB_COMPRESSED_SERIES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace plotlib {
+
+/**
+ * @brief Index entry of one compressed block
+ */
+struct CompressedBlock {
+    uint64_t bit_offset = 0;        ///< Start of the block in the bit stream
+    uint32_t count = 0;             ///< Number of points in the block
+    uint32_t integer_x = 0;         ///< 1 if X is delta-of-delta coded, 0 if XOR coded
+    double min_x = 0, max_x = 0;    ///< X range of the block
+    double min_y = 0, max_y = 0;    ///< Y range of the block
+};
+
+/**
+ * @brief Append-only, block-compressed line series
+ *
+ * @example
+ * @code
+ * CompressedSeries series;
+ * series.append(timestamps.data(), values.data(), timestamps.size());
+ * std::vector<double> xs(CompressedSeries::BLOCK_POINTS), ys(CompressedSeries::BLOCK_POINTS);
+ * for (size_t b = 0; b < series.block_count(); ++b) {
+ *     size_t count = series.decode_block(b, xs.data(), ys.data());
+ *     ...
+ * }
+ * @endcode
+ */
+class CompressedSeries {
+public:
+    static constexpr uint32_t BLOCK_POINTS = 1024; ///< Maximum points per block
+
+private:
+    std::vector<uint64_t> words;          ///< Bit stream, most significant bit first
+    uint64_t bit_count = 0;               ///< Bits used in words
+    std::vector<CompressedBlock> blocks;  ///< Block index
+    uint64_t point_count = 0;             ///< Total number of points
+    bool sorted = true;                   ///< Whether X is non-decreasing over the whole series
+
+    // Encoder state of the last block
+    bool block_open = false;              ///< Whether the last block accepts more points
+    int64_t previous_x = 0;               ///< Last integer X
+    int64_t previous_delta = 0;           ///< Last integer X delta
+    uint64_t previous_x_bits = 0;         ///< Last X bit pattern
+    uint64_t previous_y_bits = 0;         ///< Last Y bit pattern
+    int x_leading = -1, x_trailing = 0;   ///< XOR window of X, leading -1 if none yet
+    int y_leading = -1, y_trailing = 0;   ///< XOR window of Y, leading -1 if none yet
+
+    void write_bits(uint64_t value, int bits);
+    void write_xor(uint64_t value_bits, uint64_t& previous_bits, int& leading, int& trailing);
+    void start_block(double x, double y, bool integer_x);
+
+public:
+    /**
+     * @brief Append points
+     * @param x X values
+     * @param y Y values
+     * @param count Number of points
+     */
+    void append(const double* x, const double* y, size_t count);
+
+    /**
+     * @brief Decode one block
+     * @param block Block index
+     * @param x Output, room for BLOCK_POINTS values
+     * @param y Output, room for BLOCK_POINTS values
+     * @return Number of points written
+     */
+    size_t decode_block(size_t block, double* x, double* y) const;
+
+    /**
+     * @brief Replace the contents with a stored block index and bit stream
+     * @param stored_blocks Block index, e.g. from a snapshot
+     * @param stored_words Bit stream
+     * @param stored_sorted Whether X is non-decreasing, see is_sorted()
+     * @return false if the block index is inconsistent (contents are then cleared)
+     *
+     * Later appends start a new block.
+     */
+    bool restore(std::vector<CompressedBlock> stored_blocks, std::vector<uint64_t> stored_words,
+                 bool stored_sorted);
+
+    /**
+     * @brief Remove all points
+     */
+    void clear();
+
+    /**
+     * @brief Release spare capacity left by growing the bit stream
+     */
+    void shrink_to_fit() {
+        words.shrink_to_fit();
+        blocks.shrink_to_fit();
+    }
+
+    size_t size() const { return point_count; }
+    bool empty() const { return point_count == 0; }
+    size_t block_count() const { return blocks.size(); }
+    const CompressedBlock& block(size_t index) const { return blocks[index]; }
+    const std::vector<CompressedBlock>& block_index() const { return blocks; }
+    const std::vector<uint64_t>& bit_stream() const { return words; }
+
+    /**
+     * @brief Check whether X is non-decreasing, which allows block culling and decimation
+     * @return true if sorted by X
+     */
+    bool is_sorted() const { return sorted; }
+
+    /**
+     * @brief Get the heap memory used by the encoded data
+     * @return Size in bytes, including spare capacity
+     */
+    size_t memory_bytes() const {
+        return words.capacity() * sizeof(uint64_t) + blocks.capacity() * sizeof(CompressedBlock);
+    }
+};
+
+} // namespace plotlib
+
+#endif // PLOTLIB_COMPRESSED_SERIES_H
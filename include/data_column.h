@@ -0,0 +1,128 @@
+/**
+ * @file data_column.h
+ * @brief Reference-counted data columns shared between series and plots
+ * @author PlotLib Contributors
+ * @version 1.0.0
+ * @date 2025-06-08
+ *
+ * This file contains the DataColumn class, a cheap-to-copy handle to an
+ * immutable array of doubles. Passing the same column to several add_*
+ * calls stores its values once, however many series, plots and subplots
+ * use it; e.g. N y series plotted against one timestamp column keep a
+ * single copy of the timestamps.
+ */
+
+#ifndef PLOTLIB_DATA_COLUMN_H
+#define PLOTLIB_DATA_COLUMN_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace plotlib {
+
+/**
+ * @brief Shared immutable column of values
+ *
+ * Copies share the underlying storage. Columns never change once shared:
+ * append() (used by streaming series) copies the values first if any other
+ * holder references them.
+ *
+ * @example
+ * @code
+ * DataColumn time(std::move(timestamps));  // Takes ownership, no copy
+ * LinePlot plot(800, 600);
+ * plot.add_line(time, DataColumn(cpu), "CPU", "blue");
+ * plot.add_line(time, DataColumn(memory), "Memory", "red");  // time is stored once
+ *
+ * HistogramPlot histogram(800, 600);
+ * histogram.add_histogram(DataColumn(cpu), "CPU", "blue");
+ * @endcode
+ */
+class DataColumn {
+private:
+    std::shared_ptr<std::vector<double>> values; ///< Null for an empty column
+
+public:
+    /**
+     * @brief Create an empty column
+     */
+    DataColumn() = default;
+
+    /**
+     * @brief Create a column from values
+     * @param column_values Values; pass an rvalue to take ownership without copying
+     */
+    explicit DataColumn(std::vector<double> column_values)
+        : values(std::make_shared<std::vector<double>>(std::move(column_values))) {}
+
+    /**
+     * @brief Get the number of values
+     * @return Column length
+     */
+    size_t size() const { return values ? values->size() : 0; }
+
+    /**
+     * @brief Check whether the column has no values
+     * @return true if empty
+     */
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief Get the values as a contiguous array
+     * @return Pointer to size() values, nullptr for an empty column
+     */
+    const double* data() const { return values ? values->data() : nullptr; }
+
+    const double* begin() const { return data(); }
+    const double* end() const { return data() + size(); }
+    double operator[](size_t index) const { return (*values)[index]; }
+
+    /**
+     * @brief Get the values as a vector, e.g. for APIs taking std::vector
+     * @return Column values
+     */
+    const std::vector<double>& vector() const {
+        static const std::vector<double> empty_values;
+        return values ? *values : empty_values;
+    }
+
+    /**
+     * @brief Check whether two columns share storage
+     * @param other Column to compare with
+     * @return true if both refer to the same non-empty values
+     */
+    bool shares_storage_with(const DataColumn& other) const { return values && values == other.values; }
+
+    /**
+     * @brief Get the number of handles sharing this column's storage
+     * @return Reference count, 0 for an empty column
+     */
+    long use_count() const { return values.use_count(); }
+
+    /**
+     * @brief Append values, detaching from other holders first
+     * @param first Values to append
+     * @param count Number of values
+     *
+     * Other copies of the column keep seeing the old values. A column that
+     * is not shared grows in place.
+     */
+    void append(const double* first, size_t count) {
+        if (!values) {
+            values = std::make_shared<std::vector<double>>(first, first + count);
+            return;
+        }
+        if (values.use_count() > 1) {
+            auto detached = std::make_shared<std::vector<double>>();
+            detached->reserve(values->size() + count);
+            detached->assign(values->begin(), values->end());
+            values = std::move(detached);
+        }
+        values->insert(values->end(), first, first + count);
+    }
+};
+
+} // namespace plotlib
+
+#endif // PLOTLIB_DATA_COLUMN_H
@@ -0,0 +1,78 @@
+/**
+ * @file fonts.h
+ * @brief Shared font faces and explicit font file registration
+ * @author PlotLib Contributors
+ * @version 1.0.0
+ * @date 2025-06-08
+ *
+ * All text in PlotLib is drawn with one shared face per weight. By default
+ * these are Cairo toy faces for "Arial", which are resolved through
+ * fontconfig the first time they are used. Registering a TTF/OTF file loads it
+ * directly through FreeType and bypasses fontconfig entirely:
+ * @code
+ * plotlib::fonts::register_font_file("/opt/fonts/DejaVuSans.ttf");
+ * plotlib::fonts::register_font_file("/opt/fonts/DejaVuSans-Bold.ttf", CAIRO_FONT_WEIGHT_BOLD);
+ * @endcode
+ * The environment variables PLOTLIB_FONT and PLOTLIB_FONT_BOLD register files
+ * the same way before the first text is drawn.
+ */
+
+#ifndef PLOTLIB_FONTS_H
+#define PLOTLIB_FONTS_H
+
+#include <cstdint>
+#include <string>
+#include <cairo.h>
+
+namespace plotlib {
+namespace fonts {
+
+/**
+ * @brief Load a font file and use it for all text of the given weight
+ * @param filename Path to a TrueType or OpenType font file
+ * @param weight CAIRO_FONT_WEIGHT_NORMAL or CAIRO_FONT_WEIGHT_BOLD
+ * @return true if the font was loaded, false on error or without FreeType support
+ *
+ * A regular font also serves bold text, emboldened synthetically, until a
+ * bold file is registered.
+ */
+bool register_font_file(const std::string& filename, cairo_font_weight_t weight = CAIRO_FONT_WEIGHT_NORMAL);
+
+/**
+ * @brief Check whether PlotLib was built with FreeType font loading
+ * @return true if register_font_file() can load font files
+ */
+bool has_freetype();
+
+/**
+ * @brief Forget registered fonts and return to the default toy faces
+ */
+void reset();
+
+/**
+ * @brief Describe the registered font files for render cache keys
+ * @return Path, size and modification time of each registered file; empty parts for toy faces
+ *
+ * Registers PLOTLIB_FONT / PLOTLIB_FONT_BOLD first, as drawing text would.
+ */
+std::string registration_key();
+
+/**
+ * @brief Counter that changes whenever a face is registered or reset
+ * @return Current font generation
+ *
+ * Lets cached rasters that contain text detect a font change cheaply.
+ */
+uint64_t generation();
+
+/**
+ * @brief Set the shared face for a weight on a Cairo context
+ * @param cr Cairo context
+ * @param weight Font weight
+ */
+void select_font_face(cairo_t* cr, cairo_font_weight_t weight);
+
+} // namespace fonts
+} // namespace plotlib
+
+#endif // PLOTLIB_FONTS_H
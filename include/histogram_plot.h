@@ -20,19 +20,44 @@ namespace plotlib {
  * @brief Structure representing histogram data
  */
 struct HistogramData {
-    std::vector<double> values;         ///< Raw data values (for continuous data)
+    DataColumn values;                  ///< Raw data values (for continuous data), possibly shared
     std::vector<double> bins;           ///< Bin edges (n+1 edges for n bins, for continuous data)
     std::vector<int> counts;            ///< Frequency counts for each bin
     std::string name;                   ///< Series name
     PlotStyle style;                    ///< Visual style
     
     // Discrete histogram data
-    std::vector<std::string> categories; ///< Category names (for discrete data)
-    std::vector<PlotStyle> styles;       ///< Individual styles for each category (for discrete data)
-    bool is_discrete = false;            ///< Flag to indicate if this is discrete data
-    std::string category_prefix = "";    ///< Prefix for category labels (e.g., "structure")
+    std::vector<std::string> categories;   ///< Category names, empty if generated from category_prefix
+    std::vector<PlotStyle> palette;        ///< Distinct category styles (for discrete data)
+    std::vector<uint16_t> palette_indices; ///< Palette entry of each category (for discrete data)
+    bool is_discrete = false;              ///< Flag to indicate if this is discrete data
+    std::string category_prefix = "";      ///< Prefix for generated category labels (e.g., "idx")
+    std::vector<float> label_widths;       ///< Cached category label widths, negative until measured
     
     HistogramData(const std::string& series_name = "Default") : name(series_name) {}
+    
+    /**
+     * @brief Get the style of a category
+     * @param index Category index
+     * @return Palette style of the category
+     */
+    const PlotStyle& category_style(size_t index) const { return palette[palette_indices[index]]; }
+    
+    /**
+     * @brief Get the name of a category, generating "<prefix> <index + 1>" if needed
+     * @param index Category index
+     * @return Category name
+     */
+    std::string category_name(size_t index) const;
+    
+    /**
+     * @brief Get the name of a category without allocating
+     * @param index Category index
+     * @param buffer Storage for generated names
+     * @param buffer_size Size of buffer in bytes
+     * @return Category name, valid while buffer and the series are unchanged
+     */
+    const char* category_label(size_t index, char* buffer, size_t buffer_size) const;
 };
 
 /**
@@ -63,6 +88,8 @@ class HistogramPlot : public PlotManager {
 private:
     std::vector<HistogramData> histogram_series; ///< Collection of histogram data series
     int default_bin_count = 20;                  ///< Default number of bins for auto-binning
+    bool show_bin_envelope = false;              ///< Shade the min/max range of merged sub-pixel bins
+    static constexpr size_t MAX_CATEGORY_LEGEND_ITEMS = 32; ///< Larger discrete series get one legend entry
     
     /**
      * @brief Check if mixing histogram types is allowed
@@ -77,22 +104,6 @@ private:
      */
     bool has_discrete_histograms() const;
     
-    /**
-     * @brief Calculate optimal bin edges using Sturges' rule or custom count
-     * @param data Input data values
-     * @param bin_count Number of bins (0 for automatic)
-     * @return Vector of bin edges
-     */
-    std::vector<double> calculate_bins(const std::vector<double>& data, int bin_count = 0);
-    
-    /**
-     * @brief Calculate histogram counts for given data and bins
-     * @param data Input data values
-     * @param bins Bin edges
-     * @return Vector of frequency counts
-     */
-    std::vector<int> calculate_counts(const std::vector<double>& data, const std::vector<double>& bins);
-    
     /**
      * @brief Calculate cumulative counts from frequency counts
      * @param counts Frequency counts
@@ -107,9 +118,16 @@ private:
      * @param style Visual style for the histogram
      * @param bin_count Number of bins (0 for automatic)
      */
-    void add_data(const std::string& name, const std::vector<double>& data, 
+    void add_data(const std::string& name, const DataColumn& data, 
                   const PlotStyle& style, int bin_count = 0);
     
+    /**
+     * @brief Number of bins used when none is requested (Sturges' rule, capped at default_bin_count)
+     * @param value_count Number of values in the series
+     * @return Bin count
+     */
+    int auto_bin_count(size_t value_count) const;
+    
     /**
      * @brief Internal method to add discrete histogram data (used by public methods)
      * @param name Series name
@@ -129,6 +147,21 @@ private:
      */
     void add_discrete_data_simplified(const std::string& name, const std::vector<int>& counts, 
                                      const std::vector<std::string>& names, const std::vector<PlotStyle>& styles);
+    
+    /**
+     * @brief Internal method storing a discrete series in compact form
+     * @param hist_data Series with name, categories or category_prefix, palette and palette_indices set
+     * @param counts Frequency counts for each category
+     */
+    void add_compact_discrete_data(HistogramData& hist_data, const std::vector<int>& counts);
+    
+    /**
+     * @brief Find or append a style in a series palette
+     * @param palette Palette of distinct styles
+     * @param style Style to look up
+     * @return Palette index of the style
+     */
+    static uint16_t palette_index(std::vector<PlotStyle>& palette, const PlotStyle& style);
 
 public:
     /**
@@ -161,6 +194,26 @@ public:
      */
     void add_histogram(const std::vector<double>& values, const std::string& name, int bin_count = 0);
     
+    /**
+     * @brief Add continuous histogram data from a shared column with custom color and bin count
+     * @param values Column of raw values, e.g. one also plotted in a ScatterPlot
+     * @param name Series name for legend
+     * @param color_name Color name {"blue", "green", "orange", "purple", "cyan", "magenta", "yellow", "red"}
+     * @param bin_count Number of bins (0 for automatic)
+     * 
+     * The series references the column instead of copying it.
+     */
+    void add_histogram(const DataColumn& values, const std::string& name, 
+                      const std::string& color_name, int bin_count = 0);
+    
+    /**
+     * @brief Add continuous histogram data from a shared column with automatic styling
+     * @param values Column of raw values
+     * @param name Series name for legend
+     * @param bin_count Number of bins (0 for automatic)
+     */
+    void add_histogram(const DataColumn& values, const std::string& name, int bin_count = 0);
+    
     /**
      * @brief Add continuous histogram data with auto-generated name
      * @param values Raw data values for histogram
@@ -168,6 +221,33 @@ public:
      */
     void add_histogram(const std::vector<double>& values, int bin_count = 0);
     
+    /**
+     * @brief Add continuous histogram of integer values with custom color and bin count
+     * @tparam T int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t or uint64_t
+     * @param values Raw integer values for histogram
+     * @param name Series name for legend
+     * @param color_name Color name {"blue", "green", "orange", "purple", "cyan", "magenta", "yellow", "red"}
+     * @param bin_count Number of bins (0 for automatic)
+     * 
+     * Values are counted exactly without conversion to double. Bins are whole
+     * numbers of integers wide and centred on integers, so a range narrower
+     * than the bin count gets one bin per value. Large arrays are counted on
+     * several threads.
+     */
+    template<typename T>
+    void add_integer_histogram(const std::vector<T>& values, const std::string& name,
+                               const std::string& color_name, int bin_count = 0);
+    
+    /**
+     * @brief Add continuous histogram of integer values with automatic styling
+     * @tparam T int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t or uint64_t
+     * @param values Raw integer values for histogram
+     * @param name Series name for legend
+     * @param bin_count Number of bins (0 for automatic)
+     */
+    template<typename T>
+    void add_integer_histogram(const std::vector<T>& values, const std::string& name, int bin_count = 0);
+    
     /**
      * @brief Add discrete histogram data with custom colors
      * @param counts Frequency counts for each discrete category
@@ -191,18 +271,54 @@ public:
     void add_histogram(const std::vector<int>& counts);
     
     
+    /**
+     * @brief Show the min/max envelope of continuous bins narrower than a pixel
+     * @param enabled true to shade the range between the lowest and highest bin of each pixel column
+     * 
+     * Bins narrower than one pixel are always merged per pixel column, drawn
+     * at the highest count. With the envelope enabled, the part above the
+     * lowest count of the column is drawn lighter.
+     */
+    void set_bin_envelope(bool enabled);
+    
     // Plot type detection for conditional behavior in PlotManager
     bool is_histogram_plot() const override { return true; }
     bool is_discrete_histogram() const override { return has_discrete_histograms(); }
     
 
 protected:
+    /**
+     * @brief Calculate optimal bin edges using Sturges' rule or custom count
+     * @param data Input data values
+     * @param bin_count Number of bins (0 for automatic)
+     * @return Vector of bin edges
+     */
+    std::vector<double> calculate_bins(const std::vector<double>& data, int bin_count = 0);
+    
+    /**
+     * @brief Calculate histogram counts for given data and bins
+     * @param data Input data values
+     * @param bins Bin edges
+     * @return Vector of frequency counts
+     */
+    std::vector<int> calculate_counts(const std::vector<double>& data, const std::vector<double>& bins);
+    
     /**
      * @brief Draw histogram bars
      * @param cr Cairo context
      */
     void draw_data(cairo_t* cr) override;
     
+    /**
+     * @brief Add one bar per pixel column to the current path, merging the bins in each column
+     * @param cr Cairo context
+     * @param hist_data Continuous histogram series
+     * @param pixel_width Width of one device pixel in user units
+     * @param use_min Bar height from the lowest instead of the highest count in a column
+     * @return Number of bars added
+     */
+    virtual size_t add_pixel_column_bars(cairo_t* cr, const HistogramData& hist_data, double pixel_width, bool use_min);
+    
     /**
      * @brief Calculate bounds from histogram data
      */
@@ -219,6 +335,13 @@ protected:
      */
     void draw_axis_labels(cairo_t* cr) override;
     
+    /**
+     * @brief Draw the category labels of a discrete series, skipping labels that would overlap
+     * @param cr Cairo context
+     * @param hist_data Discrete series; its label width cache is filled as labels are measured
+     */
+    void draw_category_labels(cairo_t* cr, HistogramData& hist_data);
+    
     /**
      * @brief Draw custom axis ticks for discrete histograms (disable x-axis numeric ticks)
      * @param cr Cairo context
@@ -231,6 +354,14 @@ protected:
      */
     void collect_legend_items(std::vector<LegendItem>& items) override;
     
+    /**
+     * @brief Snapshot support: histogram series with their bins, counts and
+     *        category palettes (label width caches are rebuilt on render)
+     */
+    SnapshotPlotType snapshot_type() const override;
+    void write_snapshot(SnapshotWriter& writer) const override;
+    bool read_snapshot(SnapshotReader& reader) override;
+    
     /**
      * @brief Clear all histogram data
      */
@@ -0,0 +1,77 @@
+/**
+ * @file line_decimator.h
+ * @brief Streaming per-pixel-column min/max line decimation
+ * @author PlotLib Contributors
+ * @version 1.0.0
+ * @date 2025-06-08
+ *
+ * This file contains the LineDecimator class which reduces a stream of
+ * screen-space line vertices to at most four vertices per pixel column
+ * (first, minimum, maximum, last) while keeping the rendered line visually
+ * identical to drawing every vertex.
+ */
+
+#ifndef PLOTLIB_LINE_DECIMATOR_H
+#define PLOTLIB_LINE_DECIMATOR_H
+
+#include <cairo.h>
+
+namespace plotlib {
+
+/**
+ * @brief Min/max (M4) decimator that emits a Cairo path column by column
+ *
+ * Points must be fed in non-decreasing screen X order. For every pixel column
+ * the decimator keeps the first, minimum, maximum and last Y value and appends
+ * them to the current Cairo path when the column is complete. The caller is
+ * responsible for setting the source and stroking the path after finish().
+ *
+ * @example
+ * @code
+ * LineDecimator decimator;
+ * decimator.begin(cr, 1.0);
+ * for (...) decimator.add_point(screen_x, screen_y);
+ * decimator.finish();
+ * cairo_stroke(cr);
+ * @endcode
+ */
+class LineDecimator {
+private:
+    cairo_t* cr = nullptr;          ///< Target context receiving the path
+    double column_width = 1.0;      ///< Width of one pixel column in user units
+    bool has_column = false;        ///< Whether a column is currently open
+    bool path_started = false;      ///< Whether move_to has been emitted
+    long long column = 0;           ///< Index of the open column
+    double first_x = 0, first_y = 0; ///< First vertex in the open column
+    double last_x = 0, last_y = 0;   ///< Last vertex in the open column
+    double min_y = 0, max_y = 0;     ///< Y extremes in the open column
+    double min_x = 0, max_x = 0;     ///< X positions of the extremes
+    bool min_before_max = true;      ///< Order in which the extremes occurred
+
+    void emit(double x, double y);
+    void flush_column();
+
+public:
+    /**
+     * @brief Start a new decimated path
+     * @param context Cairo context the path is appended to
+     * @param pixel_width Width of one device pixel in user units
+     */
+    void begin(cairo_t* context, double pixel_width);
+
+    /**
+     * @brief Feed the next screen-space vertex
+     * @param screen_x X coordinate in user units
+     * @param screen_y Y coordinate in user units
+     */
+    void add_point(double screen_x, double screen_y);
+
+    /**
+     * @brief Flush the last open column into the path
+     */
+    void finish();
+};
+
+} // namespace plotlib
+
+#endif // PLOTLIB_LINE_DECIMATOR_H
@@ -14,9 +14,33 @@
 #define PLOTLIB_LINE_PLOT_H
 
 #include "plot_manager.h"
+#include "line_decimator.h"
+#include "path_simplifier.h"
+#include "compressed_series.h"
 
 namespace plotlib {
 
+class SeriesPyramid;
+
+/**
+ * @brief Represents a line series backed by a memory-mapped pyramid file
+ */
+struct PyramidLineSeries {
+    std::shared_ptr<const SeriesPyramid> pyramid; ///< Mapped raw data and min/max pyramid
+    PlotStyle style;                              ///< Visual styling for this series
+    std::string name;                             ///< Series name for legend
+    std::string filename;                         ///< Pyramid file, recorded in snapshots
+};
+
+/**
+ * @brief Represents a line series held in compressed blocks
+ */
+struct CompressedLineSeries {
+    CompressedSeries data;                        ///< Encoded points
+    PlotStyle style;                              ///< Visual styling for this series
+    std::string name;                             ///< Series name for legend
+};
+
 /**
  * @brief Line plot class that extends PlotManager
  * 
@@ -59,6 +83,18 @@ private:
     double default_line_width = 2.0;                ///< Default line width
     bool show_markers = false;                       ///< Whether to show markers at data points
     MarkerType default_marker_type = MarkerType::CIRCLE; ///< Default marker type when enabled
+    bool marker_thinning = true;                     ///< Whether overlapping markers are skipped
+    double vector_tolerance = 0.1;                   ///< Simplification tolerance for vector output, device units
+    PathSimplifier simplifier;                       ///< Simplifies series paths on vector targets
+    std::vector<float> vector_path;                  ///< Screen vertices of a pyramid or compressed series to simplify
+    
+    // Disk-backed series
+    std::vector<PyramidLineSeries> pyramid_series; ///< Series rendered from pyramid files
+    LineDecimator decimator;                       ///< Min/max decimator for pyramid rendering
+    
+    // Compressed series
+    std::vector<CompressedLineSeries> compressed_series; ///< Series stored in compressed blocks
+    std::vector<double> decoded_x, decoded_y;             ///< Scratch buffers holding one decoded block
     
 protected:
     /**
@@ -73,15 +109,104 @@ protected:
     /**
      * @brief Draw lines connecting data points
      * @param cr Cairo context for rendering
+     * 
+     * On SVG, PDF and PostScript targets each path is simplified to the
+     * vector tolerance instead of keeping every vertex.
      */
     void draw_lines(cairo_t* cr);
     
+    /**
+     * @brief Simplification tolerance for the target of a context
+     * @param cr Cairo context for rendering
+     * @return Tolerance in user units on SVG, PDF and PostScript targets, 0 on raster targets
+     */
+    double vector_path_tolerance(cairo_t* cr) const;
+    
+    /**
+     * @brief Add a polyline to the current path, simplified to a tolerance
+     * @param cr Cairo context for rendering
+     * @param xy Interleaved screen x, y of each vertex
+     * @param count Number of vertices
+     * @param tolerance Tolerance in user units
+     */
+    void add_simplified_path(cairo_t* cr, const float* xy, size_t count, double tolerance);
+    
     /**
      * @brief Draw markers at data points (if enabled)
      * @param cr Cairo context for rendering
+     * 
+     * With marker thinning, a marker is drawn only if it is at least one
+     * marker diameter away from the last one drawn in its series.
      */
     void draw_markers(cairo_t* cr);
     
+    /**
+     * @brief Draw all pyramid-backed series
+     * @param cr Cairo context for rendering
+     */
+    void draw_pyramid_lines(cairo_t* cr);
+    
+    /**
+     * @brief Draw the visible window of one pyramid-backed series
+     * @param cr Cairo context for rendering
+     * @param series Series to draw
+     * 
+     * Picks the coarsest pyramid level that still provides two buckets per
+     * pixel column, so only the blocks covering the window are read. The
+     * window is min/max decimated on raster targets and simplified to the
+     * vector tolerance on vector targets.
+     */
+    void draw_pyramid_series(cairo_t* cr, const PyramidLineSeries& series);
+    
+    /**
+     * @brief Draw one compressed series
+     * @param cr Cairo context for rendering
+     * @param series Series to draw
+     * 
+     * Blocks are decoded one at a time and streamed into the transform and,
+     * for dense windows on raster targets, the min/max decimator. On vector
+     * targets the path is simplified to the vector tolerance instead. Blocks
+     * outside the visible X range are skipped when X is sorted.
+     */
+    void draw_compressed_series(cairo_t* cr, const CompressedLineSeries& series);
+    
+    /**
+     * @brief Calculate bounds including pyramid-backed and compressed series
+     */
+    void calculate_bounds() override;
+    
+    /**
+     * @brief Check if line plot is empty (no data series, pyramid series or compressed series)
+     */
+    bool is_plot_empty() const override;
+    
+    /**
+     * @brief Collect legend entries including pyramid-backed and compressed series
+     * @param items Legend items to append to
+     */
+    void collect_legend_items(std::vector<LegendItem>& items) override;
+    
+    /**
+     * @brief Export lines and markers for HTML canvas drawing
+     * @param series Output, in drawing order
+     * @return false if pyramid-backed or compressed series are present (drawn in the static image)
+     */
+    bool collect_html_series(std::vector<HtmlSeries>& series) override;
+    
+    /**
+     * @brief Snapshot support: line defaults, pyramid series, which are
+     *        stored by filename and reopened on load, and compressed series,
+     *        which are stored in their encoded form
+     */
+    SnapshotPlotType snapshot_type() const override;
+    void write_snapshot(SnapshotWriter& writer) const override;
+    bool read_snapshot(SnapshotReader& reader) override;
+    
+    /**
+     * @brief Hash each pyramid file's size, modification time, header and coarsest
+     *        level, so rewritten files produce new render cache keys
+     */
+    void hash_external_inputs(SnapshotWriter& hasher) const override;
     
     /**
      * @brief Set line style for Cairo context
@@ -128,6 +253,37 @@ public:
      */
     void set_default_marker_type(MarkerType marker_type);
     
+    /**
+     * @brief Enable or disable marker thinning
+     * @param enabled Whether markers closer than their diameter to the previous drawn marker are skipped
+     * 
+     * Enabled by default, so dense series show evenly spaced markers rather
+     * than a solid band. Lines are always drawn through every point.
+     */
+    void set_marker_thinning(bool enabled);
+    
+    /**
+     * @brief Check whether marker thinning is enabled
+     * @return true if overlapping markers are skipped
+     */
+    bool is_marker_thinning_enabled() const { return marker_thinning; }
+    
+    /**
+     * @brief Set how far simplified lines may deviate from the data in vector output
+     * @param tolerance Largest deviation in device units (SVG user units); 0 keeps every vertex
+     * 
+     * Applies to SVG, PDF and PostScript targets only; raster output is
+     * unaffected. The default of 0.1 is well below what a viewer can show
+     * without zooming in tenfold.
+     */
+    void set_vector_tolerance(double tolerance);
+    
+    /**
+     * @brief Get the simplification tolerance for vector output
+     * @return Tolerance in device units
+     */
+    double get_vector_tolerance() const { return vector_tolerance; }
+    
     /**
      * @brief Add a line series with custom color (beginner-friendly)
      * @param x_values Vector of X coordinates
@@ -147,12 +303,118 @@ public:
     void add_line(const std::vector<double>& x_values, const std::vector<double>& y_values,
                   const std::string& name);
     
+    /**
+     * @brief Add a line series from shared columns with custom color
+     * @param x_values X column, e.g. a timestamp column shared by several series
+     * @param y_values Y column
+     * @param name Series name for legend
+     * @param color_name Color name {"blue", "green", "orange", "purple", "cyan", "magenta", "yellow", "red"}
+     * 
+     * The series references the columns instead of copying them.
+     */
+    void add_line(const DataColumn& x_values, const DataColumn& y_values,
+                  const std::string& name, const std::string& color_name);
+    
+    /**
+     * @brief Add a line series from shared columns with automatic styling
+     * @param x_values X column
+     * @param y_values Y column
+     * @param name Series name for legend
+     */
+    void add_line(const DataColumn& x_values, const DataColumn& y_values,
+                  const std::string& name);
+    
     /**
      * @brief Add a line series with auto-generated name and styling
      * @param x_values Vector of X coordinates
      * @param y_values Vector of Y coordinates
      */
     void add_line(const std::vector<double>& x_values, const std::vector<double>& y_values);
+    
+    /**
+     * @brief Add a line series stored in a pyramid file with custom color
+     * @param filename Pyramid file written by PyramidFileWriter or save_line_pyramid
+     * @param name Series name for legend
+     * @param color_name Color name {"blue", "green", "orange", "purple", "cyan", "magenta", "yellow", "red"}
+     * @return true if the file could be mapped, false otherwise
+     * 
+     * The file is memory-mapped; rendering reads only the pyramid blocks that
+     * cover the visible window, so the series may be larger than RAM.
+     * Markers are not drawn for pyramid-backed series.
+     */
+    bool add_line_pyramid(const std::string& filename, const std::string& name, const std::string& color_name);
+    
+    /**
+     * @brief Add a line series stored in a pyramid file with automatic styling
+     * @param filename Pyramid file written by PyramidFileWriter or save_line_pyramid
+     * @param name Series name for legend
+     * @return true if the file could be mapped, false otherwise
+     */
+    bool add_line_pyramid(const std::string& filename, const std::string& name);
+    
+    /**
+     * @brief Write an in-memory line series to a pyramid file
+     * @param series_index Index of the series (in order of add_line calls)
+     * @param filename Output pyramid file
+     * @return true if successful, false otherwise
+     * 
+     * X values of the series must be non-decreasing.
+     */
+    bool save_line_pyramid(size_t series_index, const std::string& filename) const;
+    
+    /**
+     * @brief Add a line series stored in compressed blocks with custom color
+     * @param x_values Vector of X coordinates
+     * @param y_values Vector of Y coordinates
+     * @param name Series name for legend
+     * @param color_name Color name {"blue", "green", "orange", "purple", "cyan", "magenta", "yellow", "red"}
+     * 
+     * Whole-number X values (timestamps, sample indices) are delta-of-delta
+     * coded and Y values XOR coded, losslessly. Regular telemetry shrinks
+     * several-fold compared with add_line. Markers are not drawn for
+     * compressed series. Rendering is fastest when X is non-decreasing.
+     */
+    void add_compressed_line(const std::vector<double>& x_values, const std::vector<double>& y_values,
+                             const std::string& name, const std::string& color_name);
+    
+    /**
+     * @brief Add a line series stored in compressed blocks with automatic styling
+     * @param x_values Vector of X coordinates
+     * @param y_values Vector of Y coordinates
+     * @param name Series name for legend
+     */
+    void add_compressed_line(const std::vector<double>& x_values, const std::vector<double>& y_values,
+                             const std::string& name);
+    
+    /**
+     * @brief Append points to a compressed series
+     * @param series_index Index of the series (in order of add_compressed_line calls)
+     * @param x_values X coordinates to append
+     * @param y_values Y coordinates to append
+     * @return true if successful, false otherwise
+     */
+    bool append_to_compressed_line(size_t series_index, const std::vector<double>& x_values,
+                                   const std::vector<double>& y_values);
+    
+    /**
+     * @brief Get the number of compressed series
+     * @return Number of series added with add_compressed_line
+     */
+    size_t get_compressed_line_count() const { return compressed_series.size(); }
+    
+    /**
+     * @brief Get the encoded data of a compressed series, e.g. for memory_bytes()
+     * @param series_index Index of the series
+     * @return Compressed series
+     */
+    const CompressedSeries& get_compressed_line(size_t series_index) const {
+        return compressed_series.at(series_index).data;
+    }
+    
+    /**
+     * @brief Clear all data including pyramid-backed and compressed series
+     */
+    void clear() override;
 };
 
 } // namespace plotlib
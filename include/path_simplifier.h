@@ -0,0 +1,62 @@
+/**
+ * @file path_simplifier.h
+ * @brief Tolerance-based polyline simplification for vector output
+ * @author PlotLib Contributors
+ * @version 1.0.0
+ * @date 2025-06-08
+ *
+ * This file contains the PathSimplifier class which removes the vertices of
+ * a screen-space polyline that lie within a given distance of the simplified
+ * line (Ramer-Douglas-Peucker). Unlike the per-pixel-column LineDecimator it
+ * makes no assumption about a raster grid, so SVG and PDF output stays
+ * faithful at any zoom level down to the tolerance.
+ */
+
+#ifndef PLOTLIB_PATH_SIMPLIFIER_H
+#define PLOTLIB_PATH_SIMPLIFIER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace plotlib {
+
+/**
+ * @brief Ramer-Douglas-Peucker simplifier with reusable buffers
+ *
+ * Every dropped vertex lies within the tolerance of the segment that
+ * replaces it; the first and last vertices are always kept. The recursion
+ * runs on an explicit stack, so series with millions of points are safe.
+ *
+ * @example
+ * @code
+ * PathSimplifier simplifier;
+ * const std::vector<size_t>& kept = simplifier.simplify(screen_xy, count, 0.1);
+ * cairo_move_to(cr, screen_xy[2 * kept[0]], screen_xy[2 * kept[0] + 1]);
+ * for (size_t k = 1; k < kept.size(); ++k) cairo_line_to(cr, ...);
+ * @endcode
+ */
+class PathSimplifier {
+private:
+    std::vector<uint8_t> keep;                         ///< Per-vertex keep flags
+    std::vector<std::pair<size_t, size_t>> ranges;     ///< Pending (first, last) vertex ranges
+    std::vector<size_t> kept;                          ///< Indices of the kept vertices
+
+public:
+    /**
+     * @brief Simplify a polyline
+     * @param xy Interleaved x, y of each vertex
+     * @param count Number of vertices
+     * @param tolerance Largest allowed distance of a dropped vertex from the result
+     * @return Indices of the kept vertices in ascending order, valid until the next call
+     *
+     * Vertices with non-finite coordinates are always kept, so the result
+     * breaks the path exactly where the original would.
+     */
+    const std::vector<size_t>& simplify(const float* xy, size_t count, double tolerance);
+};
+
+} // namespace plotlib
+
+#endif // PLOTLIB_PATH_SIMPLIFIER_H
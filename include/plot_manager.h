@@ -15,13 +15,16 @@
 
 #include <vector>
 #include <string>
+#include <cstdint>
 #include <memory>
+#include <functional>
 #include <set>
 #include <stdexcept>
 #include <sstream>
 #include <iomanip>
 #include <cairo.h>
 #include <cairo-svg.h>
+#include "data_column.h"
 
 namespace plotlib {
 
@@ -29,6 +32,12 @@ namespace plotlib {
 class ScatterPlot;
 class LinePlot;
 class HistogramPlot;
+class SnapshotWriter;
+class SnapshotReader;
+enum class SnapshotPlotType : uint32_t;
+class RenderCache;
+struct RenderKey;
+enum class RenderFormat : uint32_t;
 
 /**
  * @brief Represents a 2D point with x and y coordinates
@@ -66,6 +75,22 @@ enum class MarkerType {
     TRIANGLE  ///< Triangular markers
 };
 
+/**
+ * @brief Rendering quality profiles
+ */
+enum class RenderQuality {
+    FINAL,  ///< Full quality: antialiasing, hinted text, every data point (default)
+    DRAFT   ///< Fast previews: no antialiasing, coarser curves, square markers, sampled dense series
+};
+
+/**
+ * @brief Callback invoked after each pass of a progressive render
+ * @param pass Completed pass, counting from 1
+ * @param pass_count Total number of passes
+ * @return true to continue refining, false to cancel the remaining passes
+ */
+using ProgressCallback = std::function<bool(int pass, int pass_count)>;
+
 /**
  * @brief Enumeration of legend symbol types
  */
@@ -96,19 +121,94 @@ struct LegendItem {
         : label(item_label), style(item_style), symbol_type(symbol), marker_type(marker) {}
 };
 
+/**
+ * @brief Series data handed to the browser by save_html()
+ *
+ * Coordinates are offsets from the plot's lower-left data corner (min_x,
+ * min_y), which keeps float32 precision relative to the visible range.
+ */
+struct HtmlSeries {
+    std::vector<float> x;          ///< X offsets from min_x
+    std::vector<float> y;          ///< Y offsets from min_y
+    PlotStyle style;               ///< Color, alpha, marker size and line width
+    bool line = false;             ///< true: connected polyline, false: one marker per point
+    MarkerType marker = MarkerType::CIRCLE; ///< Marker type (markers only)
+    std::vector<double> dashes;    ///< Dash pattern in pixels, empty for solid (lines only)
+};
+
+/**
+ * @brief Screen coordinates of a series, cached between renders
+ * 
+ * Valid while the axis ranges, canvas size and margins stay the same, so
+ * re-renders that only change styles, labels or legend visibility reuse the
+ * coordinates instead of transforming every point again. Each series owns
+ * its cache, and series data only ever grows at the end, so the point count
+ * identifies the data that was transformed.
+ */
+struct ScreenCoordinates {
+    static constexpr int VIEW_FIELDS = 10;    ///< Axis ranges, canvas size and margins
+    std::vector<float> xy;                    ///< Interleaved screen x, y per point
+    double view[VIEW_FIELDS] = {};            ///< View the coordinates were computed for
+    size_t count = 0;                         ///< Number of points transformed
+};
+
+/**
+ * @brief Scratch buffers of annotation collision culling, reused between renders
+ * 
+ * Placed labels are registered in a spatial hash over screen cells: bucket
+ * heads index into a linked list of cell entries, each pointing at the box
+ * of a placed label.
+ */
+struct AnnotationLayout {
+    struct Box {
+        double x0, y0, x1, y1;             ///< Label bounds in screen space
+    };
+    struct CellEntry {
+        uint32_t box;                      ///< Index into boxes
+        int32_t next;                      ///< Next entry in the same bucket, -1 at the end
+    };
+    std::vector<int32_t> buckets;          ///< First cell entry of each hash bucket, -1 if empty
+    std::vector<CellEntry> cells;          ///< Cell entries of all placed labels
+    std::vector<Box> boxes;                ///< Bounds of the placed labels
+    std::vector<std::pair<uint32_t, uint32_t>> visible; ///< (style group, annotation index) of placed labels
+    std::vector<const PlotStyle*> group_styles;          ///< Distinct label styles
+};
+
+/**
+ * @brief Sub-pixel occupancy bitmap for skipping repeated opaque markers
+ * 
+ * One bit per cell of a grid MARKER_SUBPIXELS times finer than the canvas.
+ * A pass clears only the words it set, so its cost follows the number of
+ * markers rather than the canvas size.
+ */
+struct MarkerOccupancy {
+    std::vector<uint64_t> bits;               ///< Occupied cells, row-major
+    std::vector<uint32_t> touched;            ///< Words set by the current pass
+    uint32_t columns = 0;                     ///< Cells per row
+    uint32_t rows = 0;                        ///< Cell rows
+};
+
 /**
  * @brief Represents a named data series with styling information
  */
 struct DataSeries {
-    std::vector<Point2D> points; ///< Collection of 2D data points
+    DataColumn x;                ///< X coordinates, possibly shared with other series and plots
+    DataColumn y;                ///< Y coordinates, possibly shared with other series and plots
     PlotStyle style;             ///< Visual styling for this series
     std::string name;            ///< Series name for legend
+    ScreenCoordinates screen;    ///< Screen coordinates of the last render
     
     /**
      * @brief Constructor for DataSeries
      * @param series_name Name of the data series (default: empty)
      */
     DataSeries(const std::string& series_name = "") : name(series_name) {}
+    
+    /**
+     * @brief Get the number of points
+     * @return Point count
+     */
+    size_t size() const { return x.size(); }
 };
 
 /**
@@ -150,6 +250,26 @@ struct ReferenceLine {
     }
 };
 
+/**
+ * @brief Text label placed at a data coordinate
+ */
+struct Annotation {
+    double x;                   ///< X coordinate of the anchor point
+    double y;                   ///< Y coordinate of the anchor point
+    std::string text;           ///< Label text
+    PlotStyle style;            ///< Text colour and alpha
+    
+    /**
+     * @brief Constructor for Annotation
+     * @param anchor_x X coordinate of the anchor point
+     * @param anchor_y Y coordinate of the anchor point
+     * @param label_text Label text
+     * @param text_style Text colour and alpha
+     */
+    Annotation(double anchor_x, double anchor_y, const std::string& label_text, const PlotStyle& text_style)
+        : x(anchor_x), y(anchor_y), text(label_text), style(text_style) {}
+};
+
 /**
  * @brief Central plot management class that handles all common plotting functionality
  * 
@@ -185,10 +305,13 @@ protected:
     // Data storage
     std::vector<DataSeries> data_series;      ///< Collection of regular data series
     std::vector<ReferenceLine> reference_lines; ///< Collection of reference lines
+    std::vector<Annotation> annotations;      ///< Text labels, earlier ones win collisions
     
     // Data bounds and transformation
     double min_x, max_x, min_y, max_y;        ///< Data range for axis scaling
     bool bounds_set = false;                  ///< Whether bounds were manually set
+    double data_min_x = 0, data_max_x = 0;    ///< Own x range, before any shared-axis override
+    double data_min_y = 0, data_max_y = 0;    ///< Own y range, before any shared-axis override
     
     // Plot labels and titles
     std::string title = "";                   ///< Main plot title
@@ -203,6 +326,13 @@ protected:
     std::set<std::string> hidden_legend_items; ///< Set of legend items to hide
     bool show_legend = true;                  ///< Whether to show legend at all
     
+    // Rendering quality
+    RenderQuality render_quality = RenderQuality::FINAL; ///< Active quality profile
+    static constexpr size_t DRAFT_MAX_POINTS = 20000;    ///< Points drawn per series in draft mode
+    static constexpr double DRAFT_SQUARE_MARKER_SIZE = 4.0; ///< Circles up to this size become squares in draft mode
+    size_t progressive_stride = 1;                       ///< Sampling stride of the current progressive pass
+    static constexpr size_t PROGRESSIVE_MIN_POINTS = 1000; ///< Points a series keeps in the coarsest pass
+    
     // Subplot support
     bool is_subplot = false;                  ///< Whether this plot is part of a subplot grid
     double subplot_x_offset = 0;             ///< X offset for subplot positioning
@@ -210,21 +340,159 @@ protected:
     double subplot_width_scale = 1.0;        ///< Width scaling factor for subplots
     double subplot_height_scale = 1.0;       ///< Height scaling factor for subplots
     
+    // Layered rendering for HTML export
+    enum class RenderLayer {
+        ALL,          ///< Complete plot
+        BELOW_DATA,   ///< Grid, axes and title only
+        ABOVE_DATA    ///< Reference lines and legend only
+    };
+    RenderLayer render_layer = RenderLayer::ALL; ///< Layers drawn by render_to_context
+    
+    // Change tracking for render caches
+    uint64_t revision = 0;                    ///< Bumped by every change to the plot content
+    uint64_t legend_revision = 0;             ///< Bumped by changes that may alter legend entries
+    
+    /**
+     * @brief Cached tick positions and labels for one axis
+     * 
+     * Recomputed only when the axis range or tick target changes, reusing the
+     * existing storage, so steady-state renders do not allocate.
+     */
+    struct TickLayout {
+        double min_val = 0.0, max_val = 0.0;  ///< Axis range the layout was computed for
+        int target_ticks = 0;                 ///< Requested tick count
+        bool valid = false;                   ///< Whether the layout has been computed
+        std::vector<double> ticks;            ///< Tick positions in data units
+        std::vector<std::string> labels;      ///< Formatted tick labels
+    };
+    static constexpr int TARGET_TICKS = 6;    ///< Approximate tick count per axis
+    TickLayout x_tick_layout;                 ///< X-axis ticks shared by grid and tick drawing
+    TickLayout y_tick_layout;                 ///< Y-axis ticks shared by grid and tick drawing
+    bool show_x_tick_labels = true;           ///< False for inner panels of a shared x axis
+    bool show_y_tick_labels = true;           ///< False for inner panels of a shared y axis
+    
+    std::vector<LegendItem> legend_items_cache;   ///< Legend entries of the last render
+    uint64_t legend_cache_revision = UINT64_MAX;  ///< legend_revision the cache was built for
+    
+    std::shared_ptr<RenderCache> render_cache;    ///< Optional cache of encoded outputs, shared between plots
+    
+    // Annotation layer
+    static constexpr double ANNOTATION_FONT_SIZE = 10.0;  ///< Font size of annotation labels
+    static constexpr double ANNOTATION_CELL_SIZE = 32.0;  ///< Spatial hash cell size in pixels
+    std::vector<uint32_t> reference_line_order;   ///< Reference line indices grouped by style
+    std::vector<uint32_t> reference_line_groups;  ///< First index in reference_line_order of each style group
+    uint64_t reference_order_revision = UINT64_MAX; ///< legend_revision the order was built for
+    size_t drawn_annotation_count = 0;            ///< Annotations drawn by the last render
+    AnnotationLayout annotation_layout;           ///< Reused by every draw_annotations call
+    
+    // Opaque marker deduplication
+    static constexpr int MARKER_SUBPIXELS = 4;    ///< Occupancy cells per pixel along each axis
+    MarkerOccupancy marker_occupancy;             ///< Reused by every opaque marker pass
+    size_t skipped_marker_count = 0;              ///< Markers skipped by the last render
+    
+    /**
+     * @brief Record a change to the plot content
+     * @param legend_changed Whether legend entries may have changed (false for e.g. appended points)
+     */
+    void mark_modified(bool legend_changed = true);
+    
+    /**
+     * @brief Get the tick layout for an axis range, recomputing it only if the range changed
+     * @param layout Cache to use (x_tick_layout or y_tick_layout)
+     * @param min_val Axis minimum
+     * @param max_val Axis maximum
+     * @param target_ticks Approximate number of ticks
+     * @return Up-to-date layout
+     */
+    const TickLayout& get_tick_layout(TickLayout& layout, double min_val, double max_val, int target_ticks);
+    
+    /**
+     * @brief Calculate bounds if they are not set and record them as the plot's own range
+     */
+    void ensure_bounds();
+    
+    /**
+     * @brief Override the axis range, e.g. with the range shared by a subplot row or column
+     * @param x_axis true for the x axis, false for the y axis
+     * @param min_val Axis minimum
+     * @param max_val Axis maximum
+     */
+    void set_axis_range(bool x_axis, double min_val, double max_val);
+    
+    /**
+     * @brief Show or hide the numeric tick labels of each axis
+     * @param x_visible Whether x tick labels are drawn
+     * @param y_visible Whether y tick labels are drawn
+     */
+    void set_tick_label_visibility(bool x_visible, bool y_visible);
+    
+    /**
+     * @brief Get the legend entries, collecting them only if the legend changed
+     * @return Cached legend items
+     */
+    const std::vector<LegendItem>& get_legend_items();
+    
     // Core functionality methods
     virtual void calculate_bounds();
     virtual void transform_point(double data_x, double data_y, double& screen_x, double& screen_y);
     
+    /**
+     * @brief Get the screen coordinates of a point array, transforming only what changed
+     * @param cache Cache belonging to the series
+     * @param xs First X value
+     * @param ys First Y value
+     * @param count Number of points
+     * @param stride Distance in bytes between consecutive X (and Y) values
+     * @return Interleaved screen x, y of every point, as float
+     * 
+     * The cache is reused while the view (axis ranges, canvas size, margins)
+     * is unchanged. Points appended since the last call are transformed on
+     * their own.
+     */
+    const float* screen_coordinates(ScreenCoordinates& cache, const double* xs, const double* ys,
+                                    size_t count, size_t stride = sizeof(double));
+    
     // Rendering methods
     virtual void draw_axes(cairo_t* cr);
     virtual void draw_axis_labels(cairo_t* cr);
     virtual void draw_axis_ticks(cairo_t* cr);
     virtual void draw_grid(cairo_t* cr);
     virtual void draw_reference_lines(cairo_t* cr);
+    virtual void draw_annotations(cairo_t* cr);
     virtual void draw_legend(cairo_t* cr);
     virtual void collect_legend_items(std::vector<LegendItem>& items);
+    
+    /**
+     * @brief Add legend entries for reference lines, one per distinct label
+     * @param items Legend items to append to
+     */
+    void collect_reference_legend_items(std::vector<LegendItem>& items) const;
     virtual void draw_title(cairo_t* cr);
     virtual void draw_marker(cairo_t* cr, double x, double y, MarkerType type, double size, 
                            double r, double g, double b, double alpha);
+    
+    /**
+     * @brief Draw markers of one style at cached screen coordinates
+     * @param cr Cairo context for rendering
+     * @param screen Interleaved screen x, y from screen_coordinates()
+     * @param begin First point index
+     * @param end Point index past the last point
+     * @param stride Index step between drawn points
+     * @param type Marker type
+     * @param size Marker size
+     * @param r Red component
+     * @param g Green component
+     * @param b Blue component
+     * @param alpha Alpha component
+     * @param min_spacing Skip markers closer than this to the last drawn one (0 draws all)
+     * 
+     * Opaque markers (alpha 1) falling into a sub-pixel cell that already
+     * holds one are skipped: redrawing the same marker there would only
+     * paint the same pixels again.
+     */
+    void draw_marker_run(cairo_t* cr, const float* screen, size_t begin, size_t end, size_t stride,
+                         MarkerType type, double size, double r, double g, double b, double alpha,
+                         double min_spacing = 0.0);
     virtual void draw_empty_plot_text(cairo_t* cr);
     
     // Plot-specific rendering (to be implemented by derived classes)
@@ -242,9 +510,100 @@ protected:
                                      double width_scale, double height_scale);
     virtual void render_to_context(cairo_t* cr);
     
+    /**
+     * @brief Render the complete plot on white into a pooled image surface
+     * @return Surface to hand back with SurfacePool::instance().release()
+     */
+    cairo_surface_t* render_image_surface();
+    
+    /**
+     * @brief Configure a Cairo context for a quality profile
+     * @param cr Cairo context (callers save/restore its state)
+     * @param quality Profile to apply; FINAL leaves the context untouched
+     */
+    static void apply_render_quality(cairo_t* cr, RenderQuality quality);
+    
+    /**
+     * @brief Step between drawn points of a series for the active quality profile
+     * @param point_count Number of points in the series
+     * @return 1 to draw every point, n to draw every n-th point
+     */
+    size_t series_stride(size_t point_count) const;
+    
+    /**
+     * @brief Size of the largest series drawn through series_stride()
+     * @return Point count, used to decide how many progressive passes are useful
+     */
+    virtual size_t sampled_point_count() const;
+    
+    /**
+     * @brief Export the data drawn by draw_data() for client-side drawing
+     * @param series Output, in drawing order
+     * @return true if the series cover everything draw_data() draws,
+     *         false to keep the data in the static image (the default)
+     */
+    virtual bool collect_html_series(std::vector<HtmlSeries>& series);
+    
+    /**
+     * @brief Render one layer into PNG data
+     * @param layer Layer to draw
+     * @param opaque true to draw on white, false on a transparent background
+     * @param png_data Output buffer receiving the PNG file contents
+     * @return true if successful, false otherwise
+     */
+    bool render_layer_png(RenderLayer layer, bool opaque, std::vector<unsigned char>& png_data);
+    
+    /**
+     * @brief Plot type tag written in front of this plot's snapshot record
+     * @return SnapshotPlotType::NONE for plot types without snapshot support
+     */
+    virtual SnapshotPlotType snapshot_type() const;
+    
+    /**
+     * @brief Write the plot state to a snapshot
+     * @param writer Snapshot writer; derived classes write the base state first
+     */
+    virtual void write_snapshot(SnapshotWriter& writer) const;
+    
+    /**
+     * @brief Hash rendering inputs that live outside the plot, for render cache keys
+     * @param hasher Hashing snapshot writer
+     * 
+     * Called after write_snapshot() when computing render cache keys; plots
+     * drawing from external files hash what identifies their contents.
+     */
+    virtual void hash_external_inputs(SnapshotWriter& hasher) const;
+    
+    /**
+     * @brief Replace the plot state with a snapshot record
+     * @param reader Snapshot reader positioned at a record written by write_snapshot()
+     * @return true if the record was valid, false otherwise
+     */
+    virtual bool read_snapshot(SnapshotReader& reader);
+    
+    /**
+     * @brief Create an empty plot of a snapshot type and read its record
+     * @param type Plot type tag
+     * @param reader Snapshot reader positioned at the plot record
+     * @return Restored plot, or nullptr if the type or record is invalid
+     */
+    static std::unique_ptr<PlotManager> read_snapshot_plot(SnapshotPlotType type, SnapshotReader& reader);
+    
+    /**
+     * @brief Compute the render cache key of the current plot state
+     * @param format Output format the key is for
+     * @param key Output key
+     * @return false if the plot type has no snapshot support and cannot be cached
+     * 
+     * Resolves automatic bounds first, as rendering would, so a plot hashes
+     * the same before and after its first render.
+     */
+    bool render_cache_key(RenderFormat format, RenderKey& key);
+    
     // Utility methods
     std::string format_number(double value, int precision = 2);
     std::vector<double> generate_nice_ticks(double min_val, double max_val, int target_ticks = 5);
+    void generate_nice_ticks(double min_val, double max_val, int target_ticks, std::vector<double>& ticks);
     
 public:
     /**
@@ -315,6 +674,134 @@ public:
      */
     virtual bool save_svg(const std::string& filename);
     
+    /**
+     * @brief Render the plot into a raw pixel buffer
+     * @param pixels Output buffer, resized to width * height * 4 bytes
+     * @return true if successful, false otherwise
+     * 
+     * Pixels are Cairo ARGB32: premultiplied, one native-endian 32-bit word
+     * per pixel, rows packed without padding. The buffer's capacity is reused.
+     */
+    virtual bool render_to_buffer(std::vector<unsigned char>& pixels);
+    
+    /**
+     * @brief Render the plot in successively refined passes
+     * @param pixels Output buffer, holding the latest pass (same format as render_to_buffer)
+     * @param callback Called after each pass; return false to stop refining
+     * @return true if the final pass completed, false if cancelled or rendering failed
+     * 
+     * The first pass draws a stratified subset (every 64th point) of each large
+     * series, later passes every 16th, every 4th and finally every point.
+     * Series small enough to draw quickly are complete from the first pass, so
+     * plots without large series render in a single pass.
+     */
+    virtual bool render_progressive(std::vector<unsigned char>& pixels, const ProgressCallback& callback);
+    
+    /**
+     * @brief Encode the plot as PNG into memory
+     * @param png_data Output buffer receiving the PNG file contents
+     * @return true if successful, false otherwise
+     */
+    virtual bool save_png_to_buffer(std::vector<unsigned char>& png_data);
+    
+    /**
+     * @brief Encode the plot as SVG into memory
+     * @param svg_data Output string receiving the SVG document
+     * @return true if successful, false otherwise
+     */
+    virtual bool save_svg_to_buffer(std::string& svg_data);
+    
+    /**
+     * @brief Save the plot as a self-contained HTML page drawn on a canvas
+     * @param filename Output filename (should end with .html)
+     * @return true if successful, false otherwise
+     * 
+     * Grid, axes, title, reference lines and legend are embedded as two small
+     * PNG layers; scatter and line data are embedded as base64 float32
+     * columns and drawn by the browser. Plot types without client-side
+     * drawing (histograms, pyramid-backed lines) are embedded as one image.
+     */
+    virtual bool save_html(const std::string& filename);
+    
+    /**
+     * @brief Encode the plot as a self-contained HTML page into memory
+     * @param html_data Output string receiving the HTML document
+     * @return true if successful, false otherwise
+     */
+    virtual bool save_html_to_buffer(std::string& html_data);
+    
+    /**
+     * @brief Save the complete plot state as a binary snapshot
+     * @param filename Output filename
+     * @return true if successful, false otherwise
+     * 
+     * Series columns are written in bulk and mapped back by load_snapshot(),
+     * so a plot can be restored and re-rendered in another process without
+     * re-adding its data. Pyramid-backed line series store their pyramid
+     * filename, which must still exist when the snapshot is loaded.
+     */
+    bool save_snapshot(const std::string& filename) const;
+    
+    /**
+     * @brief Restore a plot saved with save_snapshot()
+     * @param filename Snapshot filename
+     * @return Plot of the saved type (ScatterPlot, LinePlot or HistogramPlot),
+     *         or nullptr if the file is missing or invalid
+     */
+    static std::unique_ptr<PlotManager> load_snapshot(const std::string& filename);
+    
+    /**
+     * @brief Attach a render cache, typically shared by many plots
+     * @param cache Cache consulted by save_png, save_svg, render_to_buffer and
+     *              the *_to_buffer methods, or nullptr to disable caching
+     * 
+     * On a hit the cached bytes are returned without rendering. Keys hash the
+     * complete plot state, so any change to data, styles, labels, bounds or
+     * size produces a new key.
+     */
+    void set_render_cache(std::shared_ptr<RenderCache> cache) { render_cache = std::move(cache); }
+    
+    /**
+     * @brief Get the attached render cache
+     * @return Cache, or nullptr if caching is disabled
+     */
+    const std::shared_ptr<RenderCache>& get_render_cache() const { return render_cache; }
+    
+    /**
+     * @brief Get the canvas width
+     * @return Canvas width in pixels
+     */
+    int get_width() const { return width; }
+    
+    /**
+     * @brief Get the canvas height
+     * @return Canvas height in pixels
+     */
+    int get_height() const { return height; }
+    
+    /**
+     * @brief Get the axis range used by the last render
+     * @param x_axis true for the x axis, false for the y axis
+     * @param min_val Output, axis minimum
+     * @param max_val Output, axis maximum
+     */
+    void get_axis_range(bool x_axis, double& min_val, double& max_val) const {
+        min_val = x_axis ? min_x : min_y;
+        max_val = x_axis ? max_x : max_y;
+    }
+    
+    /**
+     * @brief Set the rendering quality profile
+     * @param quality RenderQuality::DRAFT for fast previews, RenderQuality::FINAL for export
+     */
+    virtual void set_render_quality(RenderQuality quality);
+    
+    /**
+     * @brief Get the rendering quality profile
+     * @return Active quality profile
+     */
+    RenderQuality get_render_quality() const { return render_quality; }
+    
     // Utility methods
     
     /**
@@ -412,6 +899,37 @@ public:
      */
     size_t get_reference_line_count() const { return reference_lines.size(); }
     
+    /**
+     * @brief Add a text label at a data coordinate
+     * @param x X coordinate of the anchor point
+     * @param y Y coordinate of the anchor point
+     * @param text Label text
+     * @param color_name Text color (default: "black")
+     * 
+     * Labels are drawn above and to the right of their anchor. A label that
+     * would overlap one added earlier, or whose anchor lies outside the plot
+     * area, is skipped, so thousands of event labels stay readable.
+     * Annotations have no legend entries.
+     */
+    void add_annotation(double x, double y, const std::string& text, const std::string& color_name = "black");
+    
+    /**
+     * @brief Clear all annotations
+     */
+    void clear_annotations();
+    
+    /**
+     * @brief Get the number of annotations
+     * @return Number of annotations, drawn or not
+     */
+    size_t get_annotation_count() const { return annotations.size(); }
+    
+    /**
+     * @brief Get the number of annotations drawn by the last render
+     * @return Annotations left after culling overlapping and off-plot labels
+     */
+    size_t get_drawn_annotation_count() const { return drawn_annotation_count; }
+    
     /**
      * @brief Convert color name to PlotStyle (utility for beginner-friendly API)
      * @param color_name Color name string
@@ -440,6 +958,43 @@ public:
      */
     size_t get_series_count() const { return data_series.size(); }
     
+    /**
+     * @brief Set the transparency of a data series
+     * @param series_index Index of the series (in order of add calls)
+     * @param alpha Alpha from 0.0 (transparent) to 1.0 (opaque)
+     * @return true if successful, false otherwise
+     * 
+     * Opaque series let dense scatters skip markers that land on an
+     * already drawn one.
+     */
+    bool set_series_alpha(size_t series_index, double alpha);
+    
+    /**
+     * @brief Get the number of markers skipped by the last render
+     * @return Opaque markers dropped because an identical one covered the same sub-pixel
+     *         cell, plus line markers dropped by marker thinning
+     */
+    size_t get_skipped_marker_count() const { return skipped_marker_count; }
+    
+    /**
+     * @brief Append points to an existing data series
+     * @param series_index Index of the series (in order of add calls)
+     * @param x_values X coordinates to append
+     * @param y_values Y coordinates to append
+     * @return true if successful, false otherwise
+     * 
+     * Appending keeps the legend and other render caches valid, so re-rendering
+     * a streaming plot does not allocate once the series capacity has grown.
+     */
+    bool append_to_series(size_t series_index, const std::vector<double>& x_values,
+                          const std::vector<double>& y_values);
+    
+    /**
+     * @brief Get the content revision
+     * @return Counter that changes whenever the plot content changes
+     */
+    uint64_t get_revision() const { return revision; }
+    
     
     // Friend classes for subplot management
     friend class SubplotManager;
@@ -477,9 +1032,38 @@ private:
     int total_width, total_height;                                   ///< Total canvas size
     double spacing;                                                  ///< Spacing between subplots
     std::string main_title = "";                                     ///< Main title for entire figure
+    RenderQuality render_quality = RenderQuality::FINAL;             ///< Figure quality, applied to subplots when set
+    bool share_x = false;                                            ///< Subplots in a column share the x axis
+    bool share_y = false;                                            ///< Subplots in a row share the y axis
+    std::shared_ptr<RenderCache> render_cache;                       ///< Optional cache of encoded outputs
+    
+    struct SurfaceDestroyer {
+        void operator()(cairo_surface_t* surface) const { cairo_surface_destroy(surface); }
+    };
+    
+    /**
+     * @brief Cached raster of one subplot, re-composited while the subplot is unchanged
+     */
+    struct SubplotTile {
+        std::unique_ptr<cairo_surface_t, SurfaceDestroyer> surface; ///< Rendered panel, or empty
+        const PlotManager* plot = nullptr;            ///< Subplot the tile was rendered from
+        uint64_t revision = 0;                        ///< Subplot revision the tile shows
+        RenderQuality quality = RenderQuality::FINAL; ///< Quality the tile was rendered with
+        uint64_t font_generation = 0;                 ///< fonts::generation() the tile was rendered with
+        double x_offset = 0, y_offset = 0, scale = 0; ///< Subplot placement the tile was rendered for
+        int origin_x = 0, origin_y = 0;               ///< Device position of the tile's top-left pixel
+    };
+    std::vector<SubplotTile> tiles; ///< One per grid cell, row-major
     
     // Helper methods
     double get_title_height(cairo_t* cr);
+    cairo_surface_t* render_image_surface();
+    void render_subplot(cairo_t* cr, int row, int col, bool use_tile);
+    void apply_shared_axes();
+    void apply_shared_axis(bool x_axis);
+    void invalidate_tile(int row, int col);
+    void write_snapshot(SnapshotWriter& writer) const;
+    bool render_cache_key(RenderFormat format, RenderKey& key);
     
 public:
     /**
@@ -509,6 +1093,8 @@ public:
             // Create a new subplot of the specified type with standard size
             // Positioning will be calculated dynamically during rendering
             subplots[row][col] = std::make_unique<PlotType>(800, 600);
+            subplots[row][col]->set_render_quality(render_quality);
+            invalidate_tile(row, col);
         }
         
         return static_cast<PlotType&>(*subplots[row][col]);
@@ -527,6 +1113,7 @@ public:
         }
         
         subplots[row][col] = std::move(plot_instance);
+        invalidate_tile(row, col);
         // Positioning will be calculated dynamically during rendering
     }
     
@@ -545,6 +1132,43 @@ public:
      */
     void set_main_title(const std::string& title);
     
+    /**
+     * @brief Share the x axis between the subplots of each column
+     * @param shared true to give each column one x range and tick layout
+     * 
+     * Only the bottom subplot of a column shows x tick labels.
+     */
+    void set_sharex(bool shared);
+    
+    /**
+     * @brief Share the y axis between the subplots of each row
+     * @param shared true to give each row one y range and tick layout
+     * 
+     * Only the leftmost subplot of a row shows y tick labels.
+     */
+    void set_sharey(bool shared);
+    
+    /**
+     * @brief Check whether columns share the x axis
+     * @return true if the x axis is shared
+     */
+    bool get_sharex() const { return share_x; }
+    
+    /**
+     * @brief Check whether rows share the y axis
+     * @return true if the y axis is shared
+     */
+    bool get_sharey() const { return share_y; }
+    
+    /**
+     * @brief Drop the cached subplot tiles
+     * 
+     * When rendering to an image surface, each subplot is kept as a cached
+     * tile and only subplots changed since the last render are redrawn. Tiles
+     * are rebuilt on demand; this only frees their memory.
+     */
+    void clear_tile_cache();
+    
     /**
      * @brief Save the complete subplot figure as PNG
      * @param filename Output filename
@@ -559,6 +1183,96 @@ public:
      */
     bool save_svg(const std::string& filename);
     
+    /**
+     * @brief Render the complete subplot figure into a raw pixel buffer
+     * @param pixels Output buffer, resized to width * height * 4 bytes (Cairo ARGB32)
+     * @return true if successful, false otherwise
+     */
+    bool render_to_buffer(std::vector<unsigned char>& pixels);
+    
+    /**
+     * @brief Render the complete subplot figure in successively refined passes
+     * @param pixels Output buffer, holding the latest pass (Cairo ARGB32)
+     * @param callback Called after each pass; return false to stop refining
+     * @return true if the final pass completed, false if cancelled or rendering failed
+     * 
+     * See PlotManager::render_progressive; all subplots refine together.
+     */
+    bool render_progressive(std::vector<unsigned char>& pixels, const ProgressCallback& callback);
+    
+    /**
+     * @brief Encode the complete subplot figure as PNG into memory
+     * @param png_data Output buffer receiving the PNG file contents
+     * @return true if successful, false otherwise
+     */
+    bool save_png_to_buffer(std::vector<unsigned char>& png_data);
+    
+    /**
+     * @brief Encode the complete subplot figure as SVG into memory
+     * @param svg_data Output string receiving the SVG document
+     * @return true if successful, false otherwise
+     */
+    bool save_svg_to_buffer(std::string& svg_data);
+    
+    /**
+     * @brief Save the layout and every subplot's state as a binary snapshot
+     * @param filename Output filename
+     * @return true if successful, false otherwise
+     * 
+     * See PlotManager::save_snapshot; fails if a subplot type has no
+     * snapshot support.
+     */
+    bool save_snapshot(const std::string& filename) const;
+    
+    /**
+     * @brief Restore a subplot figure saved with save_snapshot()
+     * @param filename Snapshot filename
+     * @return Restored figure, or nullptr if the file is missing or invalid
+     */
+    static std::unique_ptr<SubplotManager> load_snapshot(const std::string& filename);
+    
+    /**
+     * @brief Attach a render cache for the complete figure
+     * @param cache Cache consulted by the save and buffer methods, or nullptr to disable caching
+     * 
+     * See PlotManager::set_render_cache; the key covers the layout and every subplot.
+     */
+    void set_render_cache(std::shared_ptr<RenderCache> cache) { render_cache = std::move(cache); }
+    
+    /**
+     * @brief Get the attached render cache
+     * @return Cache, or nullptr if caching is disabled
+     */
+    const std::shared_ptr<RenderCache>& get_render_cache() const { return render_cache; }
+    
+    /**
+     * @brief Get the total canvas width
+     * @return Canvas width in pixels
+     */
+    int get_width() const { return total_width; }
+    
+    /**
+     * @brief Get the total canvas height
+     * @return Canvas height in pixels
+     */
+    int get_height() const { return total_height; }
+    
+    /**
+     * @brief Set the rendering quality profile for the whole figure
+     * @param quality RenderQuality::DRAFT for fast previews, RenderQuality::FINAL for export
+     * 
+     * Sets the quality of every existing subplot and of subplots created
+     * later by get_subplot(). A subplot's own set_render_quality() called
+     * afterwards overrides it for that panel.
+     */
+    void set_render_quality(RenderQuality quality);
+    
+    /**
+     * @brief Get the rendering quality profile
+     * @return Active quality profile
+     */
+    RenderQuality get_render_quality() const { return render_quality; }
+    
     /**
      * @brief Get the number of rows in the subplot grid
      * @return Number of rows
@@ -578,6 +1292,18 @@ public:
     void render_to_context(cairo_t* cr);
 };
 
+/**
+ * @brief Pre-initialize process-wide state so the first plot renders quickly
+ * @param width Canvas width to pre-allocate a pooled surface for (default: 800)
+ * @param height Canvas height to pre-allocate a pooled surface for (default: 600)
+ * 
+ * Resolves the shared font faces (including any PLOTLIB_FONT registration)
+ * and builds their glyph caches for the sizes plots use, reads the tracing
+ * environment, and leaves one image surface of the given size in the
+ * SurfacePool. Call it once at process start, e.g. while a service boots.
+ */
+void warm_up(int width = 800, int height = 600);
+
 } // namespace plotlib
 
 #endif // PLOTLIB_PLOT_MANAGER_H 
\ No newline at end of file
@@ -0,0 +1,174 @@
+/**
+ * @file render_cache.h
+ * @brief Content-addressed cache of rendered plot outputs
+ * @author PlotLib Contributors
+ * @version 1.0.0
+ * @date 2025-06-08
+ *
+ * This file contains the RenderCache class which stores encoded renders
+ * (PNG, SVG, raw pixels) under a hash of the complete plot state. Plots and
+ * subplot figures with an attached cache return the stored bytes when the
+ * same state is rendered again, skipping rendering and encoding entirely.
+ *
+ * Keys are computed by hashing the plot's snapshot record (see snapshot.h),
+ * a linear pass over the data columns that is far cheaper than drawing them,
+ * plus the files the render reads: registered fonts and pyramid series.
+ * The cache has an in-memory LRU tier and an optional on-disk tier that can
+ * be shared by several processes.
+ */
+
+#ifndef PLOTLIB_RENDER_CACHE_H
+#define PLOTLIB_RENDER_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace plotlib {
+
+/**
+ * @brief Output formats stored in a render cache
+ */
+enum class RenderFormat : uint32_t {
+    PNG = 1,    ///< save_png / save_png_to_buffer
+    SVG = 2,    ///< save_svg / save_svg_to_buffer
+    PIXELS = 3  ///< render_to_buffer (Cairo ARGB32)
+};
+
+/**
+ * @brief Cache key: hash and size of the plot state plus the output format
+ */
+struct RenderKey {
+    uint64_t state_hash = 0;               ///< Hash of the snapshot record
+    uint64_t state_size = 0;               ///< Size of the snapshot record in bytes
+    RenderFormat format = RenderFormat::PNG; ///< Output format
+
+    bool operator==(const RenderKey& other) const {
+        return state_hash == other.state_hash && state_size == other.state_size && format == other.format;
+    }
+};
+
+/**
+ * @brief Two-tier (memory LRU + optional disk) cache of encoded renders
+ *
+ * All methods are thread-safe, so one cache can serve plots rendered on
+ * several threads.
+ *
+ * @example
+ * @code
+ * auto cache = std::make_shared<RenderCache>(64 << 20, "/var/cache/plots", 1 << 30);
+ * HistogramPlot plot(800, 600);
+ * plot.set_render_cache(cache);
+ * plot.add_histogram(values, "Latency", "blue");
+ * plot.save_png("latency.png");  // rendered, then stored
+ * plot.save_png("latency.png");  // written from the cache
+ * @endcode
+ */
+class RenderCache {
+public:
+    /**
+     * @brief Hit and size counters
+     */
+    struct Stats {
+        uint64_t memory_hits = 0;  ///< Lookups served from memory
+        uint64_t disk_hits = 0;    ///< Lookups served from disk
+        uint64_t misses = 0;       ///< Lookups that required rendering
+        size_t memory_bytes = 0;   ///< Bytes held in memory
+        size_t disk_bytes = 0;     ///< Bytes of known files in the disk directory
+    };
+
+private:
+    struct KeyHash {
+        size_t operator()(const RenderKey& key) const {
+            return static_cast<size_t>(key.state_hash ^ (key.state_size * 0x9E3779B97F4A7C15ULL) ^
+                                       static_cast<uint64_t>(key.format));
+        }
+    };
+
+    struct MemoryEntry {
+        RenderKey key;
+        std::vector<unsigned char> bytes;
+    };
+
+    struct DiskEntry {
+        std::list<std::string>::iterator position; ///< Position in disk_order
+        size_t size;                               ///< File size in bytes
+    };
+
+    mutable std::mutex mutex;
+    size_t memory_limit;
+    std::list<MemoryEntry> memory_order;  ///< Most recently used first
+    std::unordered_map<RenderKey, std::list<MemoryEntry>::iterator, KeyHash> memory_index;
+
+    std::string disk_directory;           ///< Empty if the disk tier is disabled
+    size_t disk_limit;
+    std::list<std::string> disk_order;    ///< File names, most recently used first
+    std::unordered_map<std::string, DiskEntry> disk_index;
+
+    Stats stats;
+
+    void store_in_memory(const RenderKey& key, const std::vector<unsigned char>& bytes);
+    void store_on_disk(const std::string& name, const std::vector<unsigned char>& bytes);
+    bool load_from_disk(const std::string& name, std::vector<unsigned char>& bytes);
+    void touch_disk_entry(const std::string& name, size_t size);
+    void remove_disk_entry(const std::string& name);
+    void scan_disk_directory();
+
+public:
+    /**
+     * @brief Create a cache
+     * @param memory_limit_bytes Maximum bytes kept in memory (default: 64 MiB)
+     * @param disk_directory Directory for the disk tier, empty to disable it (default: empty)
+     * @param disk_limit_bytes Maximum bytes kept on disk (default: 256 MiB)
+     *
+     * The disk directory is created if needed. Files already in it from
+     * earlier runs or other processes are reused; files written by another
+     * library or snapshot version are never served, only evicted.
+     */
+    explicit RenderCache(size_t memory_limit_bytes = 64u << 20, const std::string& disk_directory = "",
+                         size_t disk_limit_bytes = 256u << 20);
+
+    RenderCache(const RenderCache&) = delete;
+    RenderCache& operator=(const RenderCache&) = delete;
+
+    /**
+     * @brief Look up a render
+     * @param key Cache key
+     * @param bytes Output, replaced with the cached bytes on a hit
+     * @return true on a hit, false on a miss
+     */
+    bool lookup(const RenderKey& key, std::vector<unsigned char>& bytes);
+
+    /**
+     * @brief Store a render in both tiers
+     * @param key Cache key
+     * @param bytes Encoded output; entries larger than a tier's limit skip that tier
+     */
+    void store(const RenderKey& key, const std::vector<unsigned char>& bytes);
+
+    /**
+     * @brief Drop the memory tier and delete this cache's files from the disk tier
+     */
+    void clear();
+
+    /**
+     * @brief Get hit and size counters
+     * @return Copy of the current counters
+     */
+    Stats get_stats() const;
+
+    /**
+     * @brief File name of a key in the disk tier
+     * @param key Cache key
+     * @return Name such as "<hash><size>.png", without directory
+     */
+    static std::string file_name(const RenderKey& key);
+};
+
+} // namespace plotlib
+
+#endif // PLOTLIB_RENDER_CACHE_H
@@ -24,6 +24,7 @@ namespace plotlib {
 struct ClusterPoint {
     double x, y;          ///< 2D coordinates of the point
     int cluster_label;    ///< Cluster ID (0, 1, 2, ...) or -1 for outliers
+    int reserved = 0;     ///< Explicit padding, zeroed so snapshots and render cache keys are deterministic
     
     /**
      * @brief Constructor from coordinates and label
@@ -34,14 +35,29 @@ struct ClusterPoint {
     ClusterPoint(double x_coord, double y_coord, int label) : x(x_coord), y(y_coord), cluster_label(label) {}
 };
 
+/**
+ * @brief Contiguous run of points sharing one cluster label
+ * 
+ * Built when the cluster series is added so rendering and legend collection
+ * need no per-frame grouping.
+ */
+struct ClusterRun {
+    int cluster_label;          ///< Cluster ID (-1 for outliers)
+    size_t begin, end;          ///< Point index range [begin, end) in ClusterSeries::points
+    PlotStyle legend_style;     ///< Resolved color and legend styling for the cluster
+    std::string name;           ///< Resolved legend name ("Outliers", "Cluster 1", or custom)
+};
+
 /**
  * @brief Represents a cluster-based data series for clustering visualization
  */
 struct ClusterSeries {
-    std::vector<ClusterPoint> points; ///< Collection of cluster-labeled points
+    std::vector<ClusterPoint> points; ///< Cluster-labeled points, stable-sorted by label
+    std::vector<ClusterRun> runs;     ///< One run per label in ascending label order (outliers first)
     std::string name;                 ///< Series name for legend (legacy, kept for compatibility)
     double point_size = 3.0;          ///< Size of cluster points
     double alpha = 0.8;               ///< Transparency of cluster points
+    ScreenCoordinates screen;         ///< Screen coordinates of the last render
     
     // Enhanced cluster legend management
     std::map<int, std::string> cluster_names;  ///< Custom names per cluster label (-1=outliers, 0+=clusters)
@@ -91,9 +107,15 @@ private:
     /**
      * @brief Get color for a specific cluster label
      * @param cluster_label Cluster ID (-1 for outliers, 0+ for clusters)
-     * @return RGB color vector [r, g, b]
+     * @return Style carrying the cluster's RGB color
+     */
+    PlotStyle get_cluster_color(int cluster_label);
+    
+    /**
+     * @brief Sort the points of a cluster series by label and build its runs
+     * @param series Series whose names and colors are already configured
      */
-    std::vector<double> get_cluster_color(int cluster_label);
+    void index_clusters(ClusterSeries& series);
     
 protected:
     /**
@@ -127,6 +149,25 @@ protected:
      */
     bool is_plot_empty() const override;
     
+    /**
+     * @brief Largest sampled series, counting each cluster run separately
+     */
+    size_t sampled_point_count() const override;
+    
+    /**
+     * @brief Export cluster and regular points for HTML canvas drawing
+     * @param series Output, in drawing order
+     * @return Always true
+     */
+    bool collect_html_series(std::vector<HtmlSeries>& series) override;
+    
+    /**
+     * @brief Snapshot support: marker type and cluster series with their resolved runs
+     */
+    SnapshotPlotType snapshot_type() const override;
+    void write_snapshot(SnapshotWriter& writer) const override;
+    bool read_snapshot(SnapshotReader& reader) override;
+    
     /**
      * @brief Draw legend including cluster legend entries
      * @param cr Cairo context for rendering
@@ -187,6 +228,27 @@ public:
     void add_scatter(const std::vector<double>& x_values, const std::vector<double>& y_values,
                      const std::string& name);
     
+    /**
+     * @brief Add a scatter series from shared columns with custom color
+     * @param x_values X column, e.g. a timestamp column shared by several series
+     * @param y_values Y column
+     * @param name Series name for legend
+     * @param color_name Color name {"blue", "green", "orange", "purple", "cyan", "magenta", "yellow", "red"}
+     * 
+     * The series references the columns instead of copying them.
+     */
+    void add_scatter(const DataColumn& x_values, const DataColumn& y_values,
+                     const std::string& name, const std::string& color_name);
+    
+    /**
+     * @brief Add a scatter series from shared columns with automatic styling
+     * @param x_values X column
+     * @param y_values Y column
+     * @param name Series name for legend
+     */
+    void add_scatter(const DataColumn& x_values, const DataColumn& y_values,
+                     const std::string& name);
+    
     /**
      * @brief Add a scatter series with auto-generated name and styling
      * @param x_values Vector of X coordinates
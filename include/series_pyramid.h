@@ -0,0 +1,253 @@
+/**
+ * @file series_pyramid.h
+ * @brief Disk-backed min/max pyramid files for very large line series
+ * @author PlotLib Contributors
+ * @version 1.0.0
+ * @date 2025-06-08
+ *
+ * This file contains the PyramidFileWriter and SeriesPyramid classes which
+ * store a time series together with a multi-level min/max summary in a
+ * memory-mapped file with a fixed block layout. Rendering a window of the
+ * series only touches the pyramid blocks (or raw blocks) that cover it, so
+ * series much larger than RAM can be plotted.
+ *
+ * File layout (native little-endian, every section aligned to 4096 bytes):
+ * - Header: magic, version, block geometry, point count, data bounds and the
+ *   offset/entry count of every pyramid level
+ * - Raw section: point_count x {double x, double y}, grouped in blocks of
+ *   block_points points
+ * - Level 0: one PyramidBucket per raw block
+ * - Level k: one PyramidBucket per `fanout` buckets of level k-1
+ */
+
+#ifndef PLOTLIB_SERIES_PYRAMID_H
+#define PLOTLIB_SERIES_PYRAMID_H
+
+#include "plot_manager.h"
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace plotlib {
+
+/**
+ * @brief Summary of a contiguous run of points in a pyramid level
+ */
+struct PyramidBucket {
+    double x_first;  ///< X of the first point in the run
+    double x_last;   ///< X of the last point in the run
+    double y_first;  ///< Y of the first point in the run
+    double y_last;   ///< Y of the last point in the run
+    double y_min;    ///< Minimum Y in the run
+    double y_max;    ///< Maximum Y in the run
+};
+
+/**
+ * @brief Fixed-size header at the start of every pyramid file
+ */
+struct PyramidFileHeader {
+    static constexpr int MAX_LEVELS = 24;  ///< Maximum number of pyramid levels
+
+    char magic[8];                         ///< "PLPYRMD1"
+    uint32_t version;                      ///< Format version (currently 1)
+    uint32_t block_points;                 ///< Raw points summarised by one level-0 bucket
+    uint32_t fanout;                       ///< Buckets of level k merged into one bucket of level k+1
+    uint32_t level_count;                  ///< Number of pyramid levels stored
+    uint64_t point_count;                  ///< Number of raw points
+    double min_x, max_x, min_y, max_y;     ///< Bounds of the whole series
+    uint64_t raw_offset;                   ///< Byte offset of the raw section
+    uint64_t level_offsets[MAX_LEVELS];    ///< Byte offset of each level
+    uint64_t level_sizes[MAX_LEVELS];      ///< Number of buckets in each level
+};
+
+/**
+ * @brief Streaming writer for pyramid files
+ *
+ * Points are appended in chunks and written straight to disk, so the writer
+ * needs memory proportional to the number of levels rather than the number
+ * of points. X values must be non-decreasing across all appended chunks.
+ *
+ * @example
+ * @code
+ * PyramidFileWriter writer("history.plpyr");
+ * while (read_chunk(x_chunk, y_chunk)) {
+ *     writer.append(x_chunk, y_chunk);
+ * }
+ * writer.finish();
+ * @endcode
+ */
+class PyramidFileWriter {
+private:
+    struct LevelState {
+        FILE* file = nullptr;          ///< Temporary file receiving finished buckets
+        uint64_t entries = 0;          ///< Buckets written to this level so far
+        PyramidBucket partial{};       ///< Bucket of the next level being accumulated
+        uint32_t partial_count = 0;    ///< Buckets merged into partial
+    };
+
+    std::string filename;
+    FILE* file = nullptr;
+    uint32_t block_points;
+    uint32_t fanout;
+    uint64_t point_count = 0;
+    double min_x = 0, max_x = 0, min_y = 0, max_y = 0;
+    std::vector<Point2D> block;        ///< Raw points of the block being filled
+    std::vector<LevelState> levels;
+    bool failed = false;
+    bool finished = false;
+
+    void write_block();
+    void push_bucket(size_t level, const PyramidBucket& bucket);
+    void close_temporaries();
+
+public:
+    /**
+     * @brief Create a writer and open the output file
+     * @param filename Output pyramid file
+     * @param block_points Raw points per level-0 bucket (default: 1024)
+     * @param fanout Buckets merged per higher level bucket (default: 8)
+     */
+    PyramidFileWriter(const std::string& filename, uint32_t block_points = 1024, uint32_t fanout = 8);
+
+    /**
+     * @brief Finishes the file if finish() was not called explicitly
+     */
+    ~PyramidFileWriter();
+
+    PyramidFileWriter(const PyramidFileWriter&) = delete;
+    PyramidFileWriter& operator=(const PyramidFileWriter&) = delete;
+
+    /**
+     * @brief Check whether the output file could be opened
+     * @return true if the writer is usable
+     */
+    bool is_open() const { return file != nullptr && !failed; }
+
+    /**
+     * @brief Append a chunk of points
+     * @param x_values X coordinates (non-decreasing)
+     * @param y_values Y coordinates
+     * @param count Number of points in the chunk
+     * @return true if successful, false otherwise
+     */
+    bool append(const double* x_values, const double* y_values, size_t count);
+
+    /**
+     * @brief Append a chunk of points
+     * @param x_values X coordinates (non-decreasing)
+     * @param y_values Y coordinates
+     * @return true if successful, false otherwise
+     */
+    bool append(const std::vector<double>& x_values, const std::vector<double>& y_values);
+
+    /**
+     * @brief Write the pyramid levels and header and close the file
+     * @return true if successful, false otherwise
+     */
+    bool finish();
+};
+
+/**
+ * @brief Read-only, memory-mapped view of a pyramid file
+ *
+ * Only the header is read when the file is opened; raw and pyramid blocks are
+ * paged in by the operating system when rendering touches them.
+ */
+class SeriesPyramid {
+private:
+    const unsigned char* mapping = nullptr;  ///< Start of the mapped file
+    size_t mapping_size = 0;                 ///< Size of the mapping in bytes
+    int64_t modified_ns = 0;                 ///< File modification time when opened, ns since the epoch
+    const PyramidFileHeader* header = nullptr;
+
+    SeriesPyramid() = default;
+
+public:
+    ~SeriesPyramid();
+
+    SeriesPyramid(const SeriesPyramid&) = delete;
+    SeriesPyramid& operator=(const SeriesPyramid&) = delete;
+
+    /**
+     * @brief Map a pyramid file into memory
+     * @param filename Pyramid file written by PyramidFileWriter
+     * @return Shared pyramid, or nullptr if the file is missing or invalid
+     */
+    static std::shared_ptr<SeriesPyramid> open(const std::string& filename);
+
+    /**
+     * @brief Write a complete in-memory series to a pyramid file
+     * @param filename Output pyramid file
+     * @param points Series points (non-decreasing X)
+     * @param block_points Raw points per level-0 bucket (default: 1024)
+     * @param fanout Buckets merged per higher level bucket (default: 8)
+     * @return true if successful, false otherwise
+     */
+    static bool write(const std::string& filename, const std::vector<Point2D>& points,
+                      uint32_t block_points = 1024, uint32_t fanout = 8);
+
+    /**
+     * @brief Size of the mapped file
+     * @return Size in bytes
+     */
+    size_t file_size() const { return mapping_size; }
+
+    /**
+     * @brief Modification time of the file when it was opened
+     * @return Nanoseconds since the epoch
+     */
+    int64_t modified_time() const { return modified_ns; }
+
+    uint64_t point_count() const { return header->point_count; }
+    uint32_t block_points() const { return header->block_points; }
+    uint32_t fanout() const { return header->fanout; }
+    uint32_t level_count() const { return header->level_count; }
+    double min_x() const { return header->min_x; }
+    double max_x() const { return header->max_x; }
+    double min_y() const { return header->min_y; }
+    double max_y() const { return header->max_y; }
+
+    /**
+     * @brief Access the raw points
+     * @return Pointer to point_count() points
+     */
+    const Point2D* raw_points() const {
+        return reinterpret_cast<const Point2D*>(mapping + header->raw_offset);
+    }
+
+    /**
+     * @brief Access the buckets of one pyramid level
+     * @param level Level index (0 = finest)
+     * @return Pointer to level_size(level) buckets
+     */
+    const PyramidBucket* level(uint32_t level) const {
+        return reinterpret_cast<const PyramidBucket*>(mapping + header->level_offsets[level]);
+    }
+
+    /**
+     * @brief Number of buckets in a pyramid level
+     * @param level Level index (0 = finest)
+     * @return Bucket count
+     */
+    uint64_t level_size(uint32_t level) const { return header->level_sizes[level]; }
+
+    /**
+     * @brief Number of raw points summarised by one bucket of a level
+     * @param level Level index (0 = finest)
+     * @return Points per bucket
+     */
+    uint64_t level_span(uint32_t level) const;
+
+    /**
+     * @brief Index of the first raw point with x >= value
+     * @param value X value to search for
+     * @return Raw point index in [0, point_count()]
+     */
+    uint64_t lower_bound(double value) const;
+};
+
+} // namespace plotlib
+
+#endif // PLOTLIB_SERIES_PYRAMID_H
@@ -0,0 +1,212 @@
+/**
+ * @file snapshot.h
+ * @brief Binary snapshots of complete plot and dashboard state
+ * @author PlotLib Contributors
+ * @version 1.0.0
+ * @date 2025-06-08
+ *
+ * A snapshot stores everything needed to re-render a plot or a SubplotManager
+ * grid: series columns, cluster labels, histogram counts and edges, styles,
+ * reference lines, labels and layout. Bulk columns are written with one
+ * fwrite each and read back from a memory-mapped file with one memcpy each,
+ * so a dashboard can be rebuilt in another process without regenerating or
+ * re-adding its data.
+ *
+ * File layout (native byte order, produced and consumed by the same build):
+ * - Header: magic "PLSNAP01", format version, content (single plot or grid)
+ * - Single plot: plot type tag followed by the plot record
+ * - Grid: layout fields, then one type tag and plot record per cell
+ *   (tag 0 for empty cells)
+ *
+ * Scalars are packed; every array is preceded by its element count and
+ * starts on an 8-byte boundary. A DataColumn shared by several series or
+ * plots is stored once and referenced by index afterwards, so loading
+ * restores the sharing.
+ */
+
+#ifndef PLOTLIB_SNAPSHOT_H
+#define PLOTLIB_SNAPSHOT_H
+
+#include "plot_manager.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace plotlib {
+
+/**
+ * @brief Snapshot record format version
+ *
+ * Bumped whenever the record layout changes; also part of render cache file
+ * names, since a new record field usually means new rendering state.
+ */
+constexpr uint32_t SNAPSHOT_VERSION = 7;
+
+/**
+ * @brief Plot type tags stored in snapshots
+ */
+enum class SnapshotPlotType : uint32_t {
+    NONE = 0,       ///< Empty grid cell, or a plot type without snapshot support
+    SCATTER = 1,    ///< ScatterPlot
+    LINE = 2,       ///< LinePlot
+    HISTOGRAM = 3   ///< HistogramPlot
+};
+
+/**
+ * @brief Sequential writer for snapshot records
+ *
+ * Write errors are sticky: after the first failure every call is a no-op
+ * and ok() returns false. A writer without a file only hashes the record,
+ * which gives render caches a key covering the complete plot state.
+ */
+class SnapshotWriter {
+private:
+    FILE* file;
+    uint64_t offset = 0;
+    uint64_t hash = 0;
+    bool failed = false;
+    std::unordered_map<const double*, uint64_t> written_columns; ///< Column storage -> 1-based column number
+
+    void put_bytes(const void* data, size_t size);
+    void align(size_t alignment);
+
+public:
+    /**
+     * @brief Create a writer appending to an open file
+     * @param file File opened for binary writing, positioned at its start
+     */
+    explicit SnapshotWriter(FILE* file) : file(file) {}
+
+    /**
+     * @brief Create a writer that hashes the record instead of writing it
+     */
+    SnapshotWriter() : file(nullptr) {}
+
+    void put_u32(uint32_t value) { put_bytes(&value, sizeof(value)); }
+    void put_u64(uint64_t value) { put_bytes(&value, sizeof(value)); }
+    void put_f64(double value) { put_bytes(&value, sizeof(value)); }
+    void put_bool(bool value) { put_u32(value ? 1 : 0); }
+    void put_string(const std::string& value);
+    void put_style(const PlotStyle& style);
+
+    /**
+     * @brief Write an element count and the raw bytes of a column
+     * @param values Column of trivially copyable elements
+     */
+    template<typename T>
+    void put_array(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "Snapshot arrays must be trivially copyable");
+        put_u64(values.size());
+        align(8);
+        put_bytes(values.data(), values.size() * sizeof(T));
+    }
+
+    /**
+     * @brief Write a data column, or a reference to it if it was written before
+     * @param column Column to write
+     *
+     * Hashing writers always hash the values, so keys depend only on content.
+     */
+    void put_column(const DataColumn& column);
+
+    /**
+     * @brief Check whether every write so far succeeded
+     * @return true if no error occurred
+     */
+    bool ok() const { return !failed; }
+
+    /**
+     * @brief Get the number of bytes written (or hashed) so far
+     * @return Record size in bytes
+     */
+    uint64_t size() const { return offset; }
+
+    /**
+     * @brief Get the 64-bit hash of everything passed to a hashing writer
+     * @return Hash value, 0 for writers with a file
+     */
+    uint64_t digest() const { return hash; }
+};
+
+/**
+ * @brief Bounds-checked sequential reader over a mapped snapshot
+ *
+ * Reading past the end or reading malformed data marks the reader as failed;
+ * failed reads return zero values and ok() returns false.
+ */
+class SnapshotReader {
+private:
+    const unsigned char* data;
+    size_t size;
+    size_t offset = 0;
+    bool failed = false;
+    std::vector<DataColumn> columns; ///< Columns read so far, for shared references
+
+    const unsigned char* take(size_t bytes);
+    void align(size_t alignment);
+
+public:
+    /**
+     * @brief Create a reader over snapshot bytes
+     * @param data Start of the snapshot (8-byte aligned, e.g. a mapping)
+     * @param size Size of the snapshot in bytes
+     */
+    SnapshotReader(const unsigned char* data, size_t size) : data(data), size(size) {}
+
+    uint32_t get_u32();
+    uint64_t get_u64();
+    double get_f64();
+    bool get_bool() { return get_u32() != 0; }
+    std::string get_string();
+    PlotStyle get_style();
+
+    /**
+     * @brief Read an element count and copy the column with one memcpy
+     * @param values Output column, replaced
+     */
+    template<typename T>
+    void get_array(std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "Snapshot arrays must be trivially copyable");
+        uint64_t count = get_u64();
+        align(8);
+        if (failed || count > (size - offset) / sizeof(T)) {
+            failed = true;
+            values.clear();
+            return;
+        }
+        const T* first = reinterpret_cast<const T*>(take(count * sizeof(T)));
+        values.assign(first, first + count);
+    }
+
+    /**
+     * @brief Read a column written by SnapshotWriter::put_column
+     * @return Column, sharing storage with earlier references to the same column
+     */
+    DataColumn get_column();
+
+    /**
+     * @brief Get an element count, failing if it exceeds the remaining bytes
+     * @param min_record_size Smallest possible encoded size of one element
+     * @return Element count, 0 on failure
+     */
+    uint64_t get_count(size_t min_record_size);
+
+    /**
+     * @brief Mark the snapshot as malformed
+     */
+    void fail() { failed = true; }
+
+    /**
+     * @brief Check whether every read so far succeeded
+     * @return true if no error occurred
+     */
+    bool ok() const { return !failed; }
+};
+
+} // namespace plotlib
+
+#endif // PLOTLIB_SNAPSHOT_H
@@ -0,0 +1,91 @@
+/**
+ * @file surface_pool.h
+ * @brief Reusable Cairo image surfaces for repeated rendering
+ * @author PlotLib Contributors
+ * @version 1.0.0
+ * @date 2025-06-08
+ *
+ * Rendering the same plot repeatedly (live dashboards, animations, buffer
+ * exports) would otherwise create and free a full-size image surface per
+ * frame. The pool keeps released surfaces and hands them out again for
+ * requests of the same size.
+ */
+
+#ifndef PLOTLIB_SURFACE_POOL_H
+#define PLOTLIB_SURFACE_POOL_H
+
+#include <cairo.h>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace plotlib {
+
+/**
+ * @brief Thread-safe pool of ARGB32 image surfaces
+ *
+ * @example
+ * @code
+ * cairo_surface_t* surface = SurfacePool::instance().acquire(800, 600);
+ * // ... render ...
+ * SurfacePool::instance().release(surface);
+ * @endcode
+ */
+class SurfacePool {
+private:
+    std::mutex mutex;
+    std::vector<cairo_surface_t*> free_surfaces; ///< Released surfaces ready for reuse
+    size_t max_surfaces;                         ///< Maximum number of surfaces kept
+
+public:
+    /**
+     * @brief Create a pool
+     * @param max_surfaces Maximum number of idle surfaces kept (default: 8)
+     */
+    explicit SurfacePool(size_t max_surfaces = 8);
+
+    /**
+     * @brief Destroy all idle surfaces
+     */
+    ~SurfacePool();
+
+    SurfacePool(const SurfacePool&) = delete;
+    SurfacePool& operator=(const SurfacePool&) = delete;
+
+    /**
+     * @brief Get the process-wide pool used by the plot classes
+     * @return Shared pool instance
+     */
+    static SurfacePool& instance();
+
+    /**
+     * @brief Get an ARGB32 image surface of the given size
+     * @param width Surface width in pixels
+     * @param height Surface height in pixels
+     * @return Surface owned by the caller until release(); contents are undefined
+     */
+    cairo_surface_t* acquire(int width, int height);
+
+    /**
+     * @brief Return a surface to the pool
+     * @param surface Surface obtained from acquire() (nullptr is ignored)
+     *
+     * The surface is destroyed instead if it is in an error state or the pool is full.
+     */
+    void release(cairo_surface_t* surface);
+
+    /**
+     * @brief Destroy all idle surfaces
+     */
+    void clear();
+
+    /**
+     * @brief Number of idle surfaces currently kept
+     * @return Idle surface count
+     */
+    size_t size();
+};
+
+} // namespace plotlib
+
+#endif // PLOTLIB_SURFACE_POOL_H
@@ -0,0 +1,123 @@
+/**
+ * @file trace.h
+ * @brief Optional Chrome trace-event recording for rendering and export
+ * @author PlotLib Contributors
+ * @version 1.0.0
+ * @date 2025-06-08
+ *
+ * Records timed scopes from any thread and writes them as Chrome trace-event
+ * JSON, which can be opened in Perfetto (ui.perfetto.dev) or chrome://tracing.
+ * Tracing is off by default; a disabled scope costs one atomic load.
+ *
+ * Tracing is enabled either programmatically:
+ * @code
+ * plotlib::trace::start("export.trace.json");
+ * dashboard.save_png("dashboard.png");
+ * plotlib::trace::stop();  // Writes the file
+ * @endcode
+ * or by setting the environment variable PLOTLIB_TRACE=<file> before the
+ * first traced scope runs; the file is then written at process exit.
+ */
+
+#ifndef PLOTLIB_TRACE_H
+#define PLOTLIB_TRACE_H
+
+#include <cstdint>
+#include <string>
+
+namespace plotlib {
+namespace trace {
+
+/**
+ * @brief Start recording trace events
+ * @param filename File the trace is written to by stop()
+ * @return true if recording started, false if a trace is already active
+ */
+bool start(const std::string& filename);
+
+/**
+ * @brief Stop recording and write all events to the trace file
+ * @return true if the file was written, false otherwise
+ */
+bool stop();
+
+/**
+ * @brief Check whether events are currently recorded
+ * @return true if tracing is active
+ */
+bool is_enabled();
+
+/**
+ * @brief Name the calling thread in the trace (e.g. "worker 3")
+ * @param name Thread name shown by the trace viewer
+ */
+void set_thread_name(const std::string& name);
+
+/**
+ * @brief Current time on the trace clock
+ * @return Microseconds since an arbitrary epoch
+ */
+uint64_t now_us();
+
+/**
+ * @brief Timed scope recorded as one complete ("X") event
+ *
+ * Name and category must be string literals (or otherwise outlive the trace),
+ * as only the pointers are stored while recording.
+ */
+class Scope {
+public:
+    static constexpr int MAX_ARGS = 4;  ///< Maximum arguments per event
+
+private:
+    const char* name;
+    const char* category;
+    uint64_t start_us = 0;
+    bool active;
+    const char* arg_keys[MAX_ARGS];
+    long long arg_values[MAX_ARGS];
+    int arg_count = 0;
+
+public:
+    /**
+     * @brief Begin a scope if tracing is enabled
+     * @param scope_name Event name (string literal)
+     * @param scope_category Event category (string literal), e.g. "render"
+     */
+    Scope(const char* scope_name, const char* scope_category);
+
+    /**
+     * @brief Record the event with its duration
+     */
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    /**
+     * @brief Attach an integer argument shown in the event details
+     * @param key Argument name (string literal)
+     * @param value Argument value
+     */
+    void arg(const char* key, long long value) {
+        if (active && arg_count < MAX_ARGS) {
+            arg_keys[arg_count] = key;
+            arg_values[arg_count] = value;
+            ++arg_count;
+        }
+    }
+};
+
+} // namespace trace
+} // namespace plotlib
+
+#define PLOTLIB_TRACE_CONCAT_INNER(a, b) a##b
+#define PLOTLIB_TRACE_CONCAT(a, b) PLOTLIB_TRACE_CONCAT_INNER(a, b)
+
+/**
+ * @brief Trace the enclosing block as an event named `name` in `category`
+ */
+#define PLOTLIB_TRACE_SCOPE(name, category) \
+    ::plotlib::trace::Scope PLOTLIB_TRACE_CONCAT(plotlib_trace_scope_, __LINE__)(name, category)
+
+#endif // PLOTLIB_TRACE_H
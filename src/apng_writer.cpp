@@ -0,0 +1,336 @@
+#include "apng_writer.h"
+#include "trace.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <zlib.h>
+
+namespace plotlib {
+
+namespace {
+
+const unsigned char PNG_SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+/// Byte offset of the acTL payload: signature, then the 25-byte IHDR chunk, then acTL length and type
+const long ACTL_DATA_OFFSET = 8 + 25 + 8;
+
+/// Largest frame delay representable in fcTL with a 1/1000 s denominator
+const uint32_t MAX_DELAY_MS = 65535;
+
+void put_u32(unsigned char* out, uint32_t value) {
+    out[0] = static_cast<unsigned char>(value >> 24);
+    out[1] = static_cast<unsigned char>(value >> 16);
+    out[2] = static_cast<unsigned char>(value >> 8);
+    out[3] = static_cast<unsigned char>(value);
+}
+
+void put_u16(unsigned char* out, uint16_t value) {
+    out[0] = static_cast<unsigned char>(value >> 8);
+    out[1] = static_cast<unsigned char>(value);
+}
+
+unsigned char paeth(int left, int up, int up_left) {
+    int estimate = left + up - up_left;
+    int distance_left = std::abs(estimate - left);
+    int distance_up = std::abs(estimate - up);
+    int distance_up_left = std::abs(estimate - up_left);
+    if (distance_left <= distance_up && distance_left <= distance_up_left) return static_cast<unsigned char>(left);
+    if (distance_up <= distance_up_left) return static_cast<unsigned char>(up);
+    return static_cast<unsigned char>(up_left);
+}
+
+/**
+ * @brief Filter RGBA scanlines and deflate them into a zlib stream
+ *
+ * Each row uses whichever of the None, Sub, Up and Paeth filters gives the
+ * smallest sum of absolute residuals. Runs on a worker thread.
+ */
+std::vector<unsigned char> compress_frame(std::vector<unsigned char> rgba, uint32_t frame_width, uint32_t frame_height) {
+    trace::Scope scope("deflate_frame", "encode");
+    scope.arg("width", frame_width);
+    scope.arg("height", frame_height);
+
+    size_t row_bytes = static_cast<size_t>(frame_width) * 4;
+    std::vector<unsigned char> filtered((row_bytes + 1) * frame_height);
+    std::vector<unsigned char> candidate(row_bytes);
+    std::vector<unsigned char> zero_row(row_bytes, 0);
+
+    for (uint32_t row = 0; row < frame_height; ++row) {
+        const unsigned char* line = rgba.data() + row * row_bytes;
+        const unsigned char* above = row > 0 ? line - row_bytes : zero_row.data();
+        unsigned char* out = filtered.data() + row * (row_bytes + 1);
+
+        // None
+        out[0] = 0;
+        std::memcpy(out + 1, line, row_bytes);
+        unsigned long best_cost = 0;
+        for (size_t i = 0; i < row_bytes; ++i) {
+            best_cost += std::abs(static_cast<signed char>(line[i]));
+        }
+
+        for (unsigned char filter = 1; filter <= 4; ++filter) {
+            if (filter == 3) continue; // Average rarely wins on plots
+            unsigned long cost = 0;
+            for (size_t i = 0; i < row_bytes; ++i) {
+                int left = i >= 4 ? line[i - 4] : 0;
+                int up = above[i];
+                int up_left = i >= 4 ? above[i - 4] : 0;
+                int predicted = filter == 1 ? left : filter == 2 ? up : paeth(left, up, up_left);
+                candidate[i] = static_cast<unsigned char>(line[i] - predicted);
+                cost += std::abs(static_cast<signed char>(candidate[i]));
+            }
+            if (cost < best_cost) {
+                best_cost = cost;
+                out[0] = filter;
+                std::memcpy(out + 1, candidate.data(), row_bytes);
+            }
+        }
+    }
+
+    uLongf compressed_size = compressBound(static_cast<uLong>(filtered.size()));
+    std::vector<unsigned char> compressed(compressed_size);
+    if (compress2(compressed.data(), &compressed_size, filtered.data(), static_cast<uLong>(filtered.size()),
+                  Z_DEFAULT_COMPRESSION) != Z_OK) {
+        return {};
+    }
+    compressed.resize(compressed_size);
+    return compressed;
+}
+
+} // namespace
+
+ApngWriter::ApngWriter(const std::string& filename, int width, int height, int delay_ms, int loops)
+    : filename(filename), width(width), height(height), default_delay_ms(std::max(0, delay_ms)),
+      loops(static_cast<uint32_t>(std::max(0, loops))), max_pending(std::max(2u, std::thread::hardware_concurrency())) {
+    if (width <= 0 || height <= 0) {
+        std::cerr << "Error: Invalid APNG frame size " << width << "x" << height << std::endl;
+        return;
+    }
+    file = std::fopen(filename.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error: Cannot open APNG file '" << filename << "' for writing" << std::endl;
+        return;
+    }
+
+    // 8-bit RGBA, no interlacing
+    unsigned char header[13];
+    put_u32(header, static_cast<uint32_t>(width));
+    put_u32(header + 4, static_cast<uint32_t>(height));
+    header[8] = 8;
+    header[9] = 6;
+    header[10] = header[11] = header[12] = 0;
+
+    // Frame count is patched in by finish()
+    unsigned char animation_control[8];
+    put_u32(animation_control, 0);
+    put_u32(animation_control + 4, this->loops);
+
+    failed = std::fwrite(PNG_SIGNATURE, 1, sizeof(PNG_SIGNATURE), file) != sizeof(PNG_SIGNATURE) ||
+             !write_chunk("IHDR", header, sizeof(header)) ||
+             !write_chunk("acTL", animation_control, sizeof(animation_control));
+}
+
+ApngWriter::~ApngWriter() {
+    if (!finished) {
+        finish();
+    }
+}
+
+bool ApngWriter::write_chunk(const char type[4], const unsigned char* data, size_t size) {
+    unsigned char length[4];
+    put_u32(length, static_cast<uint32_t>(size));
+    uLong crc = crc32(0L, reinterpret_cast<const Bytef*>(type), 4);
+    if (size > 0) {
+        crc = crc32(crc, data, static_cast<uInt>(size)); // A null buffer would reset the CRC
+    }
+    unsigned char crc_bytes[4];
+    put_u32(crc_bytes, static_cast<uint32_t>(crc));
+
+    return std::fwrite(length, 1, 4, file) == 4 &&
+           std::fwrite(type, 1, 4, file) == 4 &&
+           (size == 0 || std::fwrite(data, 1, size, file) == size) &&
+           std::fwrite(crc_bytes, 1, 4, file) == 4;
+}
+
+bool ApngWriter::write_frame(PendingFrame& frame) {
+    std::vector<unsigned char> compressed = frame.compressed.get();
+    if (compressed.empty()) {
+        std::cerr << "Error: Failed to compress APNG frame" << std::endl;
+        return false;
+    }
+
+    unsigned char frame_control[26];
+    put_u32(frame_control, sequence_number++);
+    put_u32(frame_control + 4, frame.frame_width);
+    put_u32(frame_control + 8, frame.frame_height);
+    put_u32(frame_control + 12, frame.x_offset);
+    put_u32(frame_control + 16, frame.y_offset);
+    put_u16(frame_control + 20, static_cast<uint16_t>(frame.delay_ms));
+    put_u16(frame_control + 22, 1000);
+    frame_control[24] = 0; // APNG_DISPOSE_OP_NONE: the next frame draws over this one
+    frame_control[25] = 0; // APNG_BLEND_OP_SOURCE: the rectangle replaces what was there
+    if (!write_chunk("fcTL", frame_control, sizeof(frame_control))) return false;
+
+    // The first frame doubles as the default image
+    if (sequence_number == 1) {
+        return write_chunk("IDAT", compressed.data(), compressed.size());
+    }
+
+    std::vector<unsigned char> frame_data(compressed.size() + 4);
+    put_u32(frame_data.data(), sequence_number++);
+    std::memcpy(frame_data.data() + 4, compressed.data(), compressed.size());
+    return write_chunk("fdAT", frame_data.data(), frame_data.size());
+}
+
+bool ApngWriter::write_oldest() {
+    PLOTLIB_TRACE_SCOPE("write_apng_frame", "io");
+    bool success = write_frame(pending.front());
+    pending.pop_front();
+    if (!success) failed = true;
+    return success;
+}
+
+bool ApngWriter::add_frame(const std::vector<unsigned char>& pixels, int delay_ms) {
+    PLOTLIB_TRACE_SCOPE("add_apng_frame", "export");
+    if (!is_open() || finished) {
+        std::cerr << "Error: APNG writer for '" << filename << "' is not open" << std::endl;
+        return false;
+    }
+    size_t pixel_count = static_cast<size_t>(width) * height;
+    if (pixels.size() != pixel_count * 4) {
+        std::cerr << "Error: APNG frame has " << pixels.size() << " bytes, expected " << pixel_count * 4 << std::endl;
+        return false;
+    }
+    uint32_t delay = std::min<uint32_t>(delay_ms < 0 ? default_delay_ms : delay_ms, MAX_DELAY_MS);
+
+    std::vector<uint32_t> current(pixel_count);
+    std::memcpy(current.data(), pixels.data(), pixels.size());
+
+    // Bounding rectangle of the pixels that differ from the previous frame
+    uint32_t left = 0, top = 0, right = width - 1, bottom = height - 1;
+    if (frame_count > 0) {
+        const size_t row_bytes = static_cast<size_t>(width) * 4;
+        auto row_changed = [&](uint32_t row) {
+            return std::memcmp(&current[row * width], &previous[row * width], row_bytes) != 0;
+        };
+        while (top < static_cast<uint32_t>(height) && !row_changed(top)) ++top;
+
+        if (top == static_cast<uint32_t>(height)) {
+            // Unchanged: show the previous frame longer if its delay can hold it
+            PendingFrame& last = pending.back();
+            if (last.delay_ms + delay <= MAX_DELAY_MS) {
+                last.delay_ms += delay;
+                return true;
+            }
+            top = bottom = left = right = 0;
+        } else {
+            while (!row_changed(bottom)) --bottom;
+            left = width - 1;
+            right = 0;
+            for (uint32_t row = top; row <= bottom; ++row) {
+                const uint32_t* now = &current[row * width];
+                const uint32_t* before = &previous[row * width];
+                for (uint32_t x = 0; x < left; ++x) {
+                    if (now[x] != before[x]) { left = x; break; }
+                }
+                for (uint32_t x = width - 1; x > right; --x) {
+                    if (now[x] != before[x]) { right = x; break; }
+                }
+            }
+            right = std::max(left, right);
+        }
+    }
+
+    // Unpremultiplied RGBA bytes of the rectangle
+    PendingFrame frame;
+    frame.x_offset = left;
+    frame.y_offset = top;
+    frame.frame_width = right - left + 1;
+    frame.frame_height = bottom - top + 1;
+    frame.delay_ms = delay;
+
+    std::vector<unsigned char> rgba(static_cast<size_t>(frame.frame_width) * frame.frame_height * 4);
+    unsigned char* out = rgba.data();
+    for (uint32_t row = top; row <= bottom; ++row) {
+        for (uint32_t x = left; x <= right; ++x) {
+            uint32_t argb = current[row * width + x];
+            uint32_t alpha = argb >> 24;
+            uint32_t red = (argb >> 16) & 0xff, green = (argb >> 8) & 0xff, blue = argb & 0xff;
+            if (alpha != 0 && alpha != 255) {
+                red = std::min<uint32_t>(255, (red * 255 + alpha / 2) / alpha);
+                green = std::min<uint32_t>(255, (green * 255 + alpha / 2) / alpha);
+                blue = std::min<uint32_t>(255, (blue * 255 + alpha / 2) / alpha);
+            }
+            out[0] = static_cast<unsigned char>(red);
+            out[1] = static_cast<unsigned char>(green);
+            out[2] = static_cast<unsigned char>(blue);
+            out[3] = static_cast<unsigned char>(alpha);
+            out += 4;
+        }
+    }
+
+    frame.compressed = std::async(std::launch::async, compress_frame, std::move(rgba),
+                                  frame.frame_width, frame.frame_height);
+    pending.push_back(std::move(frame));
+    previous.swap(current);
+    ++frame_count;
+
+    // Keep the newest frame pending so a repeat of it can extend its delay
+    while (pending.size() > max_pending) {
+        if (!write_oldest()) return false;
+    }
+    return true;
+}
+
+bool ApngWriter::add_frame(PlotManager& plot, int delay_ms) {
+    std::vector<unsigned char> pixels;
+    return plot.render_to_buffer(pixels) && add_frame(pixels, delay_ms);
+}
+
+bool ApngWriter::add_frame(SubplotManager& manager, int delay_ms) {
+    std::vector<unsigned char> pixels;
+    return manager.render_to_buffer(pixels) && add_frame(pixels, delay_ms);
+}
+
+bool ApngWriter::finish() {
+    if (finished) return !failed;
+    PLOTLIB_TRACE_SCOPE("finish_apng", "io");
+    finished = true;
+    if (!file) return false;
+
+    while (!pending.empty()) {
+        write_oldest();
+    }
+    if (frame_count == 0) {
+        std::cerr << "Error: APNG file '" << filename << "' has no frames" << std::endl;
+        failed = true;
+    }
+
+    if (!failed) {
+        failed = !write_chunk("IEND", nullptr, 0);
+    }
+
+    // Patch the frame count into acTL
+    if (!failed) {
+        unsigned char animation_control[8];
+        put_u32(animation_control, frame_count);
+        put_u32(animation_control + 4, loops);
+        uLong crc = crc32(0L, reinterpret_cast<const Bytef*>("acTL"), 4);
+        crc = crc32(crc, animation_control, sizeof(animation_control));
+        unsigned char crc_bytes[4];
+        put_u32(crc_bytes, static_cast<uint32_t>(crc));
+        failed = std::fseek(file, ACTL_DATA_OFFSET, SEEK_SET) != 0 ||
+                 std::fwrite(animation_control, 1, sizeof(animation_control), file) != sizeof(animation_control) ||
+                 std::fwrite(crc_bytes, 1, 4, file) != 4;
+    }
+
+    if (std::fclose(file) != 0) {
+        failed = true;
+    }
+    file = nullptr;
+    return !failed;
+}
+
+} // namespace plotlib
@@ -0,0 +1,274 @@
+#include "compressed_series.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace plotlib {
+
+namespace {
+
+uint64_t double_bits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double bits_double(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+int leading_zeros(uint64_t value) {
+#if defined(__GNUC__)
+    return value ? __builtin_clzll(value) : 64;
+#else
+    int count = 0;
+    for (uint64_t mask = uint64_t(1) << 63; mask && !(value & mask); mask >>= 1) ++count;
+    return count;
+#endif
+}
+
+int trailing_zeros(uint64_t value) {
+#if defined(__GNUC__)
+    return value ? __builtin_ctzll(value) : 64;
+#else
+    int count = 0;
+    for (uint64_t mask = 1; mask && !(value & mask); mask <<= 1) ++count;
+    return count;
+#endif
+}
+
+// Whole numbers within the exact range of doubles are delta-of-delta coded.
+// Negative zero is excluded so decoding restores every value bit for bit.
+bool is_integer_x(double x) {
+    return std::trunc(x) == x && std::abs(x) <= 9007199254740992.0 && !(x == 0 && std::signbit(x));
+}
+
+/**
+ * @brief Bounds-checked reader over a bit stream; reads past the end return zero bits
+ */
+class BitReader {
+private:
+    const uint64_t* words;
+    uint64_t word_count;
+    uint64_t position;
+
+public:
+    BitReader(const std::vector<uint64_t>& stream, uint64_t bit_offset)
+        : words(stream.data()), word_count(stream.size()), position(bit_offset) {}
+
+    uint64_t read(int bits) {
+        uint64_t index = position >> 6;
+        int used = static_cast<int>(position & 63);
+        position += bits;
+        if (index >= word_count) return 0;
+
+        uint64_t head = words[index] << used;
+        uint64_t value = head >> (64 - bits);
+        int space = 64 - used;
+        if (bits > space && index + 1 < word_count) {
+            value |= words[index + 1] >> (64 - (bits - space));
+        }
+        return value;
+    }
+
+    bool bit() { return read(1) != 0; }
+
+    uint64_t read_xor(uint64_t previous, int& leading, int& trailing) {
+        if (!bit()) return previous;
+        if (bit()) {
+            leading = static_cast<int>(read(6));
+            int length = static_cast<int>(read(6)) + 1;
+            trailing = 64 - leading - length;
+            if (trailing < 0) trailing = 0;  // Malformed stream
+        }
+        if (leading < 0) leading = 0;  // Malformed stream: window used before it was set
+        int length = 64 - leading - trailing;
+        if (length <= 0) return previous;
+        return previous ^ (read(length) << trailing);
+    }
+};
+
+} // anonymous namespace
+
+void CompressedSeries::write_bits(uint64_t value, int bits) {
+    if (bits < 64) value &= (uint64_t(1) << bits) - 1;
+    int used = static_cast<int>(bit_count & 63);
+    if (used == 0) words.push_back(0);
+    int space = 64 - used;
+    if (bits <= space) {
+        words.back() |= value << (space - bits);
+    } else {
+        words.back() |= value >> (bits - space);
+        words.push_back(value << (64 - (bits - space)));
+    }
+    bit_count += bits;
+}
+
+void CompressedSeries::write_xor(uint64_t value_bits, uint64_t& previous_bits, int& leading, int& trailing) {
+    uint64_t difference = value_bits ^ previous_bits;
+    previous_bits = value_bits;
+    if (difference == 0) {
+        write_bits(0, 1);
+        return;
+    }
+
+    int lead = leading_zeros(difference);
+    int trail = trailing_zeros(difference);
+    if (leading >= 0 && lead >= leading && trail >= trailing) {
+        // Fits the previous window: store only the bits inside it
+        write_bits(0x2, 2);
+        write_bits(difference >> trailing, 64 - leading - trailing);
+    } else {
+        int length = 64 - lead - trail;
+        write_bits(0x3, 2);
+        write_bits(static_cast<uint64_t>(lead), 6);
+        write_bits(static_cast<uint64_t>(length - 1), 6);
+        write_bits(difference >> trail, length);
+        leading = lead;
+        trailing = trail;
+    }
+}
+
+void CompressedSeries::start_block(double x, double y, bool integer_x) {
+    CompressedBlock block;
+    block.bit_offset = bit_count;
+    block.count = 1;
+    block.integer_x = integer_x ? 1 : 0;
+    block.min_x = block.max_x = x;
+    block.min_y = block.max_y = y;
+    blocks.push_back(block);
+
+    previous_x_bits = double_bits(x);
+    previous_y_bits = double_bits(y);
+    previous_x = integer_x ? static_cast<int64_t>(x) : 0;
+    previous_delta = 0;
+    x_leading = y_leading = -1;
+    x_trailing = y_trailing = 0;
+    write_bits(previous_x_bits, 64);
+    write_bits(previous_y_bits, 64);
+    block_open = true;
+}
+
+void CompressedSeries::append(const double* x, const double* y, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        double x_value = x[i];
+        double y_value = y[i];
+        bool integer_x = is_integer_x(x_value);
+        // While sorted, the last point holds the largest X so far
+        if (sorted && point_count > 0 && x_value < blocks.back().max_x) sorted = false;
+        ++point_count;
+
+        if (!block_open || blocks.back().count >= BLOCK_POINTS || (blocks.back().integer_x && !integer_x)) {
+            start_block(x_value, y_value, integer_x);
+            continue;
+        }
+
+        CompressedBlock& block = blocks.back();
+        if (block.integer_x) {
+            int64_t integer = static_cast<int64_t>(x_value);
+            int64_t delta = integer - previous_x;
+            int64_t delta_of_delta = delta - previous_delta;
+            if (delta_of_delta == 0) {
+                write_bits(0, 1);
+            } else if (delta_of_delta >= -63 && delta_of_delta <= 64) {
+                write_bits(0x2, 2);
+                write_bits(static_cast<uint64_t>(delta_of_delta + 63), 7);
+            } else if (delta_of_delta >= -255 && delta_of_delta <= 256) {
+                write_bits(0x6, 3);
+                write_bits(static_cast<uint64_t>(delta_of_delta + 255), 9);
+            } else if (delta_of_delta >= -2047 && delta_of_delta <= 2048) {
+                write_bits(0xE, 4);
+                write_bits(static_cast<uint64_t>(delta_of_delta + 2047), 12);
+            } else {
+                write_bits(0xF, 4);
+                write_bits(static_cast<uint64_t>(delta_of_delta), 64);
+            }
+            previous_x = integer;
+            previous_delta = delta;
+        } else {
+            write_xor(double_bits(x_value), previous_x_bits, x_leading, x_trailing);
+        }
+        write_xor(double_bits(y_value), previous_y_bits, y_leading, y_trailing);
+
+        ++block.count;
+        block.min_x = std::min(block.min_x, x_value);
+        block.max_x = std::max(block.max_x, x_value);
+        block.min_y = std::min(block.min_y, y_value);
+        block.max_y = std::max(block.max_y, y_value);
+    }
+}
+
+size_t CompressedSeries::decode_block(size_t index, double* x, double* y) const {
+    const CompressedBlock& block = blocks[index];
+    BitReader reader(words, block.bit_offset);
+
+    uint64_t x_bits = reader.read(64);
+    uint64_t y_bits = reader.read(64);
+    x[0] = bits_double(x_bits);
+    y[0] = bits_double(y_bits);
+
+    // Unsigned arithmetic keeps malformed streams from overflowing signed integers
+    uint64_t integer = block.integer_x && is_integer_x(x[0]) ? static_cast<uint64_t>(static_cast<int64_t>(x[0])) : 0;
+    uint64_t delta = 0;
+    int x_lead = -1, x_trail = 0, y_lead = -1, y_trail = 0;
+    for (uint32_t i = 1; i < block.count; ++i) {
+        if (block.integer_x) {
+            int64_t delta_of_delta = 0;
+            if (!reader.bit()) {
+                delta_of_delta = 0;
+            } else if (!reader.bit()) {
+                delta_of_delta = static_cast<int64_t>(reader.read(7)) - 63;
+            } else if (!reader.bit()) {
+                delta_of_delta = static_cast<int64_t>(reader.read(9)) - 255;
+            } else if (!reader.bit()) {
+                delta_of_delta = static_cast<int64_t>(reader.read(12)) - 2047;
+            } else {
+                delta_of_delta = static_cast<int64_t>(reader.read(64));
+            }
+            delta += static_cast<uint64_t>(delta_of_delta);
+            integer += delta;
+            x[i] = static_cast<double>(static_cast<int64_t>(integer));
+        } else {
+            x_bits = reader.read_xor(x_bits, x_lead, x_trail);
+            x[i] = bits_double(x_bits);
+        }
+        y_bits = reader.read_xor(y_bits, y_lead, y_trail);
+        y[i] = bits_double(y_bits);
+    }
+    return block.count;
+}
+
+bool CompressedSeries::restore(std::vector<CompressedBlock> stored_blocks, std::vector<uint64_t> stored_words,
+                               bool stored_sorted) {
+    clear();
+    uint64_t total = 0;
+    uint64_t previous_offset = 0;
+    for (const auto& block : stored_blocks) {
+        if (block.count == 0 || block.count > BLOCK_POINTS || block.bit_offset < previous_offset ||
+            block.bit_offset + 128 > stored_words.size() * 64) {
+            return false;
+        }
+        previous_offset = block.bit_offset;
+        total += block.count;
+    }
+
+    blocks = std::move(stored_blocks);
+    words = std::move(stored_words);
+    bit_count = words.size() * 64;
+    point_count = total;
+    sorted = stored_sorted;
+    return true;
+}
+
+void CompressedSeries::clear() {
+    words.clear();
+    blocks.clear();
+    bit_count = 0;
+    point_count = 0;
+    sorted = true;
+    block_open = false;
+}
+
+} // namespace plotlib
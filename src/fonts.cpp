@@ -0,0 +1,170 @@
+#include "fonts.h"
+#include "trace.h"
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+
+#ifdef PLOTLIB_HAVE_FREETYPE
+#include <cairo-ft.h>
+#endif
+
+namespace plotlib {
+namespace fonts {
+
+namespace {
+
+std::mutex font_mutex;
+cairo_font_face_t* faces[2] = {nullptr, nullptr}; ///< Regular and bold; guarded by font_mutex
+bool bold_registered = false;                     ///< Whether faces[1] came from a bold file
+std::string face_keys[2];                         ///< Cache key part of each face, empty for toy faces
+std::atomic<uint64_t> face_generation{0};         ///< Bumped whenever a face is replaced
+
+int face_index(cairo_font_weight_t weight) {
+    return weight == CAIRO_FONT_WEIGHT_BOLD ? 1 : 0;
+}
+
+void replace_face(int index, cairo_font_face_t* face) {
+    if (faces[index]) cairo_font_face_destroy(faces[index]);
+    faces[index] = face;
+    face_keys[index].clear();
+    ++face_generation;
+}
+
+/**
+ * @brief Identify a font file by path, size and modification time
+ */
+std::string file_key(const std::string& filename) {
+    std::error_code error;
+    auto size = std::filesystem::file_size(filename, error);
+    auto modified = std::filesystem::last_write_time(filename, error);
+    return filename + ":" + std::to_string(size) + ":" +
+           std::to_string(modified.time_since_epoch().count());
+}
+
+#ifdef PLOTLIB_HAVE_FREETYPE
+FT_Library ft_library = nullptr;          ///< Guarded by font_mutex
+const cairo_user_data_key_t ft_face_key = {};
+
+void done_ft_face(void* face) {
+    FT_Done_Face(static_cast<FT_Face>(face));
+}
+
+/**
+ * @brief Load a font file as a Cairo face; the face owns the FreeType face
+ */
+cairo_font_face_t* load_face(const std::string& filename, bool synthesize_bold) {
+    if (!ft_library && FT_Init_FreeType(&ft_library) != 0) {
+        std::cerr << "Error: Cannot initialize FreeType" << std::endl;
+        ft_library = nullptr;
+        return nullptr;
+    }
+    
+    FT_Face ft_face;
+    if (FT_New_Face(ft_library, filename.c_str(), 0, &ft_face) != 0) {
+        std::cerr << "Error: Cannot load font file '" << filename << "'" << std::endl;
+        return nullptr;
+    }
+    
+    cairo_font_face_t* face = cairo_ft_font_face_create_for_ft_face(ft_face, 0);
+    if (cairo_font_face_status(face) != CAIRO_STATUS_SUCCESS ||
+        cairo_font_face_set_user_data(face, &ft_face_key, ft_face, done_ft_face) != CAIRO_STATUS_SUCCESS) {
+        std::cerr << "Error: Cannot create font face for '" << filename << "'" << std::endl;
+        cairo_font_face_destroy(face);
+        FT_Done_Face(ft_face);
+        return nullptr;
+    }
+    if (synthesize_bold) {
+        cairo_ft_font_face_set_synthesize(face, CAIRO_FT_SYNTHESIZE_BOLD);
+    }
+    return face;
+}
+#endif
+
+/**
+ * @brief Register PLOTLIB_FONT / PLOTLIB_FONT_BOLD once
+ */
+void init_from_environment() {
+    static std::once_flag once;
+    std::call_once(once, [] {
+        const char* regular = std::getenv("PLOTLIB_FONT");
+        if (regular && *regular) register_font_file(regular, CAIRO_FONT_WEIGHT_NORMAL);
+        const char* bold = std::getenv("PLOTLIB_FONT_BOLD");
+        if (bold && *bold) register_font_file(bold, CAIRO_FONT_WEIGHT_BOLD);
+    });
+}
+
+} // namespace
+
+bool register_font_file(const std::string& filename, cairo_font_weight_t weight) {
+#ifdef PLOTLIB_HAVE_FREETYPE
+    PLOTLIB_TRACE_SCOPE("register_font_file", "fonts");
+    std::lock_guard<std::mutex> lock(font_mutex);
+    
+    cairo_font_face_t* face = load_face(filename, false);
+    if (!face) return false;
+    
+    std::string key = file_key(filename);
+    if (weight == CAIRO_FONT_WEIGHT_BOLD) {
+        replace_face(1, face);
+        face_keys[1] = key;
+        bold_registered = true;
+    } else {
+        replace_face(0, face);
+        face_keys[0] = key;
+        // Embolden the regular font rather than fall back to fontconfig for bold text
+        if (!bold_registered) {
+            replace_face(1, load_face(filename, true));
+            face_keys[1] = key + ":synthetic-bold";
+        }
+    }
+    return true;
+#else
+    std::cerr << "Error: Cannot load font file '" << filename
+              << "': PlotLib was built without FreeType support" << std::endl;
+    (void)weight;
+    return false;
+#endif
+}
+
+bool has_freetype() {
+#ifdef PLOTLIB_HAVE_FREETYPE
+    return true;
+#else
+    return false;
+#endif
+}
+
+void reset() {
+    std::lock_guard<std::mutex> lock(font_mutex);
+    replace_face(0, nullptr);
+    replace_face(1, nullptr);
+    bold_registered = false;
+}
+
+std::string registration_key() {
+    init_from_environment();
+    
+    std::lock_guard<std::mutex> lock(font_mutex);
+    return face_keys[0] + "|" + face_keys[1];
+}
+
+uint64_t generation() {
+    init_from_environment();
+    return face_generation.load();
+}
+
+void select_font_face(cairo_t* cr, cairo_font_weight_t weight) {
+    init_from_environment();
+    
+    std::lock_guard<std::mutex> lock(font_mutex);
+    cairo_font_face_t*& face = faces[face_index(weight)];
+    if (!face) {
+        face = cairo_toy_font_face_create("Arial", CAIRO_FONT_SLANT_NORMAL, weight);
+    }
+    cairo_set_font_face(cr, face);
+}
+
+} // namespace fonts
+} // namespace plotlib
@@ -1,18 +1,139 @@
 #include "histogram_plot.h"
+#include "fonts.h"
+#include "snapshot.h"
+#include "trace.h"
 #include <algorithm>
+#include <climits>
 #include <cmath>
+#include <cstdio>
+#include <limits>
 #include <numeric>
 #include <iostream>
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
 
 namespace plotlib {
 
+namespace {
+
+/// Arrays shorter than this are counted on the calling thread
+constexpr size_t PARALLEL_MIN_VALUES = size_t(1) << 18;
+
+/// Interleaved sub-histograms used for 8- and 16-bit values
+constexpr size_t INTERLEAVE = 4;
+
+/**
+ * @brief Number of chunks to split a count of values into
+ */
+size_t parallel_chunk_count(size_t value_count) {
+    if (value_count < PARALLEL_MIN_VALUES) return 1;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t chunks = std::min(threads, value_count / (PARALLEL_MIN_VALUES / 2));
+    // Keep every chunk within the range of its 32-bit counters
+    return std::max(chunks, static_cast<size_t>(value_count / UINT32_MAX) + 1);
+}
+
+/**
+ * @brief Run task(chunk, begin, end) over chunks of [0, value_count), one thread per chunk
+ *
+ * Chunk 0 runs on the calling thread. Tasks must not throw.
+ */
+template<typename Task>
+void parallel_for(size_t value_count, size_t chunks, const Task& task) {
+    if (chunks <= 1) {
+        task(0, 0, value_count);
+        return;
+    }
+    
+    std::vector<std::thread> workers;
+    workers.reserve(chunks - 1);
+    for (size_t chunk = 1; chunk < chunks; ++chunk) {
+        size_t begin = value_count * chunk / chunks;
+        size_t end = value_count * (chunk + 1) / chunks;
+        workers.emplace_back([&task, chunk, begin, end]() {
+            trace::Scope scope("count_chunk", "binning");
+            scope.arg("values", static_cast<long long>(end - begin));
+            task(chunk, begin, end);
+        });
+    }
+    task(0, 0, value_count / chunks);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Offset of a value from the smallest value of its type, as an unsigned integer
+ */
+template<typename T>
+uint64_t integer_key(T value) {
+    using Unsigned = typename std::make_unsigned<T>::type;
+    return static_cast<Unsigned>(static_cast<Unsigned>(value) - static_cast<Unsigned>(std::numeric_limits<T>::min()));
+}
+
+/**
+ * @brief Count 8- or 16-bit values into a table indexed by integer_key
+ *
+ * Consecutive values go to INTERLEAVE separate tables, so runs of equal values
+ * do not wait on the increment of the same counter.
+ */
+template<typename T>
+std::vector<uint64_t> count_small_integers(const std::vector<T>& values, size_t chunks) {
+    constexpr size_t table_size = size_t(1) << (8 * sizeof(T));
+    std::vector<std::vector<uint32_t>> tables(chunks, std::vector<uint32_t>(table_size * INTERLEAVE, 0));
+    
+    parallel_for(values.size(), chunks, [&](size_t chunk, size_t begin, size_t end) {
+        uint32_t* table = tables[chunk].data();
+        const T* data = values.data();
+        size_t i = begin;
+        for (; i + INTERLEAVE <= end; i += INTERLEAVE) {
+            ++table[integer_key(data[i])];
+            ++table[table_size + integer_key(data[i + 1])];
+            ++table[2 * table_size + integer_key(data[i + 2])];
+            ++table[3 * table_size + integer_key(data[i + 3])];
+        }
+        for (; i < end; ++i) {
+            ++table[integer_key(data[i])];
+        }
+    });
+    
+    std::vector<uint64_t> totals(table_size, 0);
+    for (const auto& table : tables) {
+        for (size_t copy = 0; copy < INTERLEAVE; ++copy) {
+            for (size_t key = 0; key < table_size; ++key) {
+                totals[key] += table[copy * table_size + key];
+            }
+        }
+    }
+    return totals;
+}
+
+} // namespace
+
+std::string HistogramData::category_name(size_t index) const {
+    if (index < categories.size()) return categories[index];
+    return category_prefix + " " + std::to_string(index + 1);
+}
+
+const char* HistogramData::category_label(size_t index, char* buffer, size_t buffer_size) const {
+    if (index < categories.size()) return categories[index].c_str();
+    std::snprintf(buffer, buffer_size, "%s %zu", category_prefix.c_str(), index + 1);
+    return buffer;
+}
+
 HistogramPlot::HistogramPlot(int width, int height) : PlotManager(width, height) {
     // Set default Y label for histograms
     y_label = "Frequency";
 }
 
+int HistogramPlot::auto_bin_count(size_t value_count) const {
+    int bin_count = std::max(1, static_cast<int>(std::ceil(std::log2(value_count) + 1)));
+    return std::min(bin_count, default_bin_count); // Cap at default
+}
+
 std::vector<double> HistogramPlot::calculate_bins(const std::vector<double>& data, int bin_count) {
+    PLOTLIB_TRACE_SCOPE("calculate_bins", "binning");
     if (data.empty()) return {};
     
     auto minmax = std::minmax_element(data.begin(), data.end());
@@ -21,8 +142,7 @@ std::vector<double> HistogramPlot::calculate_bins(const std::vector<double>& dat
     
     // Use Sturges' rule if bin_count is 0
     if (bin_count <= 0) {
-        bin_count = std::max(1, static_cast<int>(std::ceil(std::log2(data.size()) + 1)));
-        bin_count = std::min(bin_count, default_bin_count); // Cap at default
+        bin_count = auto_bin_count(data.size());
     }
     
     std::vector<double> bins;
@@ -41,6 +161,9 @@ std::vector<double> HistogramPlot::calculate_bins(const std::vector<double>& dat
 }
 
 std::vector<int> HistogramPlot::calculate_counts(const std::vector<double>& data, const std::vector<double>& bins) {
+    trace::Scope scope("calculate_counts", "binning");
+    scope.arg("values", static_cast<long long>(data.size()));
+    scope.arg("bins", static_cast<long long>(bins.size() > 0 ? bins.size() - 1 : 0));
     if (bins.size() < 2) return {};
     
     std::vector<int> counts(bins.size() - 1, 0);
@@ -106,7 +229,7 @@ void HistogramPlot::validate_histogram_type_compatibility(bool is_new_discrete)
     }
 }
 
-void HistogramPlot::add_data(const std::string& name, const std::vector<double>& data, 
+void HistogramPlot::add_data(const std::string& name, const DataColumn& data, 
                             const PlotStyle& style, int bin_count) {
     if (data.empty()) {
         std::cerr << "Error: Empty data provided for histogram series '" << name << "'" << std::endl;
@@ -119,11 +242,12 @@ void HistogramPlot::add_data(const std::string& name, const std::vector<double>&
     HistogramData hist_data(name);
     hist_data.values = data;
     hist_data.style = style;
-    hist_data.bins = calculate_bins(data, bin_count);
-    hist_data.counts = calculate_counts(data, hist_data.bins);
+    hist_data.bins = calculate_bins(data.vector(), bin_count);
+    hist_data.counts = calculate_counts(data.vector(), hist_data.bins);
     
-    histogram_series.push_back(hist_data);
+    histogram_series.push_back(std::move(hist_data));
     bounds_set = false;
+    mark_modified();
 }
 
 
@@ -204,29 +328,44 @@ void HistogramPlot::draw_data(cairo_t* cr) {
         if (hist_data.counts.empty()) continue;
         
         if (hist_data.is_discrete) {
-            // Draw discrete histogram bars
+            // Draw discrete histogram bars, one path per palette colour
             double bar_width = 0.8; // Width of each discrete bar (leave space between bars)
             
-            for (size_t i = 0; i < hist_data.counts.size(); ++i) {
-                double count = static_cast<double>(hist_data.counts[i]);
-                if (count == 0) continue; // Skip empty categories
+            // Borders would cover bars only a few pixels wide entirely
+            double bar_left_x, bar_right_x, unused_y;
+            transform_point(0, 0, bar_left_x, unused_y);
+            transform_point(bar_width, 0, bar_right_x, unused_y);
+            double bar_pixels = bar_right_x - bar_left_x, pixel_dy = 0.0;
+            cairo_user_to_device_distance(cr, &bar_pixels, &pixel_dy);
+            bool draw_borders = std::abs(bar_pixels) >= 3.0;
+            
+            for (size_t p = 0; p < hist_data.palette.size(); ++p) {
+                bool has_bars = false;
+                for (size_t i = 0; i < hist_data.counts.size(); ++i) {
+                    double count = static_cast<double>(hist_data.counts[i]);
+                    if (count == 0 || hist_data.palette_indices[i] != p) continue; // Skip empty categories
+                    
+                    // Calculate bar position (centered on integer x-values)
+                    double x_center = static_cast<double>(i);
+                    double bar_left = x_center - bar_width / 2.0;
+                    double bar_right = x_center + bar_width / 2.0;
+                    
+                    // Transform to screen coordinates
+                    double screen_left, screen_bottom, screen_right, screen_top;
+                    transform_point(bar_left, 0, screen_left, screen_bottom);
+                    transform_point(bar_right, count, screen_right, screen_top);
+                    
+                    cairo_rectangle(cr, screen_left, screen_top, screen_right - screen_left, screen_bottom - screen_top);
+                    has_bars = true;
+                }
+                if (!has_bars) continue;
                 
-                // Use individual style for each category
-                const PlotStyle& category_style = (i < hist_data.styles.size()) ? hist_data.styles[i] : hist_data.style;
+                const PlotStyle& category_style = hist_data.palette[p];
                 cairo_set_source_rgba(cr, category_style.r, category_style.g, category_style.b, category_style.alpha);
-                
-                // Calculate bar position (centered on integer x-values)
-                double x_center = static_cast<double>(i);
-                double bar_left = x_center - bar_width / 2.0;
-                double bar_right = x_center + bar_width / 2.0;
-                
-                // Transform to screen coordinates
-                double screen_left, screen_bottom, screen_right, screen_top;
-                transform_point(bar_left, 0, screen_left, screen_bottom);
-                transform_point(bar_right, count, screen_right, screen_top);
-                
-                // Draw filled rectangle
-                cairo_rectangle(cr, screen_left, screen_top, screen_right - screen_left, screen_bottom - screen_top);
+                if (!draw_borders) {
+                    cairo_fill(cr);
+                    continue;
+                }
                 cairo_fill_preserve(cr);
                 
                 // Draw border with darker color
@@ -238,10 +377,35 @@ void HistogramPlot::draw_data(cairo_t* cr) {
             // Draw continuous histogram bars
             if (hist_data.bins.empty()) continue;
             
-            // Set color and style
-            cairo_set_source_rgba(cr, hist_data.style.r, hist_data.style.g, hist_data.style.b, hist_data.style.alpha);
+            // Bins narrower than a device pixel are merged per pixel column
+            double pixel_width = 1.0, pixel_dy = 0.0;
+            cairo_device_to_user_distance(cr, &pixel_width, &pixel_dy);
+            pixel_width = std::abs(pixel_width);
+            if (pixel_width <= 0) pixel_width = 1.0;
+            double first_x, last_x, unused_y;
+            transform_point(hist_data.bins.front(), 0, first_x, unused_y);
+            transform_point(hist_data.bins.back(), 0, last_x, unused_y);
+            bool sub_pixel_bins = (last_x - first_x) < pixel_width * hist_data.counts.size();
+            
+            if (sub_pixel_bins) {
+                // Highest count per column; lighter if the envelope's lower part is drawn on top
+                add_pixel_column_bars(cr, hist_data, pixel_width, false);
+                double alpha = show_bin_envelope ? hist_data.style.alpha * 0.4 : hist_data.style.alpha;
+                cairo_set_source_rgba(cr, hist_data.style.r, hist_data.style.g, hist_data.style.b, alpha);
+                cairo_fill_preserve(cr);
+                cairo_set_source_rgba(cr, hist_data.style.r * 0.7, hist_data.style.g * 0.7, hist_data.style.b * 0.7, hist_data.style.alpha);
+                cairo_set_line_width(cr, 1.0);
+                cairo_stroke(cr);
+                
+                if (show_bin_envelope) {
+                    add_pixel_column_bars(cr, hist_data, pixel_width, true);
+                    cairo_set_source_rgba(cr, hist_data.style.r, hist_data.style.g, hist_data.style.b, hist_data.style.alpha);
+                    cairo_fill(cr);
+                }
+                continue;
+            }
             
-            // Draw histogram bars
+            // All bars of the series form one path: filled once, then outlined once
             for (size_t i = 0; i < hist_data.counts.size() && i < hist_data.bins.size() - 1; ++i) {
                 double bin_left = hist_data.bins[i];
                 double bin_right = hist_data.bins[i + 1];
@@ -252,20 +416,66 @@ void HistogramPlot::draw_data(cairo_t* cr) {
                 transform_point(bin_left, 0, screen_left, screen_bottom);
                 transform_point(bin_right, count, screen_right, screen_top);
                 
-                // Draw filled rectangle
                 cairo_rectangle(cr, screen_left, screen_top, screen_right - screen_left, screen_bottom - screen_top);
-                cairo_fill_preserve(cr);
-                
-                // Draw border
-                cairo_set_source_rgba(cr, hist_data.style.r * 0.7, hist_data.style.g * 0.7, hist_data.style.b * 0.7, hist_data.style.alpha);
-                cairo_set_line_width(cr, 1.0);
-                cairo_stroke(cr);
-                
-                // Restore fill color for next bar
-                cairo_set_source_rgba(cr, hist_data.style.r, hist_data.style.g, hist_data.style.b, hist_data.style.alpha);
             }
+            
+            // Fill
+            cairo_set_source_rgba(cr, hist_data.style.r, hist_data.style.g, hist_data.style.b, hist_data.style.alpha);
+            cairo_fill_preserve(cr);
+            
+            // Borders
+            cairo_set_source_rgba(cr, hist_data.style.r * 0.7, hist_data.style.g * 0.7, hist_data.style.b * 0.7, hist_data.style.alpha);
+            cairo_set_line_width(cr, 1.0);
+            cairo_stroke(cr);
+        }
+    }
+}
+
+size_t HistogramPlot::add_pixel_column_bars(cairo_t* cr, const HistogramData& hist_data, double pixel_width, bool use_min) {
+    size_t bin_count = std::min(hist_data.counts.size(), hist_data.bins.size() - 1);
+    
+    double column_left = 0, column_right = 0, column_count = 0;
+    long long column = 0;
+    bool open = false;
+    size_t bars = 0;
+    double screen_bottom, screen_top, unused_y;
+    
+    for (size_t i = 0; i < bin_count; ++i) {
+        double screen_left, screen_right;
+        transform_point(hist_data.bins[i], 0, screen_left, screen_bottom);
+        transform_point(hist_data.bins[i + 1], 0, screen_right, unused_y);
+        double count = static_cast<double>(hist_data.counts[i]);
+        long long bin_column = static_cast<long long>(std::floor((screen_left - margin_left) / pixel_width));
+        
+        if (open && bin_column == column) {
+            column_right = screen_right;
+            column_count = use_min ? std::min(column_count, count) : std::max(column_count, count);
+            continue;
         }
+        
+        if (open) {
+            transform_point(0, column_count, unused_y, screen_top);
+            cairo_rectangle(cr, column_left, screen_top, column_right - column_left, screen_bottom - screen_top);
+            ++bars;
+        }
+        column = bin_column;
+        column_left = screen_left;
+        column_right = screen_right;
+        column_count = count;
+        open = true;
     }
+    
+    if (open) {
+        transform_point(0, column_count, unused_y, screen_top);
+        cairo_rectangle(cr, column_left, screen_top, column_right - column_left, screen_bottom - screen_top);
+        ++bars;
+    }
+    return bars;
+}
+
+void HistogramPlot::set_bin_envelope(bool enabled) {
+    show_bin_envelope = enabled;
+    mark_modified(false);
 }
 
 void HistogramPlot::draw_axis_ticks(cairo_t* cr) {
@@ -282,14 +492,14 @@ void HistogramPlot::draw_axis_ticks(cairo_t* cr) {
         // For discrete histograms, only draw Y-axis ticks (no X-axis numeric ticks)
         cairo_set_source_rgb(cr, 0, 0, 0);
         cairo_set_line_width(cr, 1.0);
-        cairo_select_font_face(cr, "Arial", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+        fonts::select_font_face(cr, CAIRO_FONT_WEIGHT_NORMAL);
         cairo_set_font_size(cr, 10);
         
         // Y-axis ticks only
-        auto y_ticks = generate_nice_ticks(min_y, max_y, 6);
-        for (double tick : y_ticks) {
+        const TickLayout& y_ticks = get_tick_layout(y_tick_layout, min_y, max_y, TARGET_TICKS);
+        for (size_t i = 0; i < y_ticks.ticks.size(); ++i) {
             double screen_x, screen_y;
-            transform_point(min_x, tick, screen_x, screen_y);
+            transform_point(min_x, y_ticks.ticks[i], screen_x, screen_y);
             
             // Draw tick mark
             cairo_move_to(cr, margin_left, screen_y);
@@ -297,7 +507,8 @@ void HistogramPlot::draw_axis_ticks(cairo_t* cr) {
             cairo_stroke(cr);
             
             // Draw tick label
-            std::string label = format_number(tick);
+            if (!show_y_tick_labels) continue;
+            const std::string& label = y_ticks.labels[i];
             cairo_text_extents_t extents;
             cairo_text_extents(cr, label.c_str(), &extents);
             cairo_move_to(cr, margin_left - extents.width - 10, screen_y + extents.height/2);
@@ -322,30 +533,19 @@ void HistogramPlot::draw_axis_labels(cairo_t* cr) {
     if (has_discrete) {
         // Draw custom X-axis labels for discrete data
         cairo_set_source_rgb(cr, 0, 0, 0);
-        cairo_select_font_face(cr, "Arial", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+        fonts::select_font_face(cr, CAIRO_FONT_WEIGHT_BOLD);
         cairo_set_font_size(cr, 12);
         
-        // Draw discrete category labels
-        for (const auto& hist_data : histogram_series) {
-            if (hist_data.is_discrete && !hist_data.categories.empty()) {
-                for (size_t i = 0; i < hist_data.categories.size(); ++i) {
-                    double x_pos = static_cast<double>(i);
-                    double screen_x, screen_y;
-                    transform_point(x_pos, min_y, screen_x, screen_y);
-                    
-                    // Draw category label
-                    const std::string& label = hist_data.categories[i];
-                    cairo_text_extents_t extents;
-                    cairo_text_extents(cr, label.c_str(), &extents);
-                    cairo_move_to(cr, screen_x - extents.width/2, height - margin_bottom + 20);
-                    cairo_show_text(cr, label.c_str());
-                }
-                break; // Only use the first discrete series for labels
+        // Draw discrete category labels (only the first discrete series is labelled)
+        for (auto& hist_data : histogram_series) {
+            if (hist_data.is_discrete && show_x_tick_labels) {
+                draw_category_labels(cr, hist_data);
+                break;
             }
         }
         
         // Draw axis labels (X and Y)
-        cairo_select_font_face(cr, "Arial", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+        fonts::select_font_face(cr, CAIRO_FONT_WEIGHT_BOLD);
         cairo_set_font_size(cr, 12);
         
         // X-axis label
@@ -375,6 +575,54 @@ void HistogramPlot::draw_axis_labels(cairo_t* cr) {
     }
 }
 
+void HistogramPlot::draw_category_labels(cairo_t* cr, HistogramData& hist_data) {
+    size_t category_count = hist_data.counts.size();
+    if (hist_data.label_widths.size() != category_count) {
+        hist_data.label_widths.assign(category_count, -1.0f);
+    }
+    
+    // Distance between neighbouring category centres
+    double first_x, next_x, screen_y;
+    transform_point(0, min_y, first_x, screen_y);
+    transform_point(1, min_y, next_x, screen_y);
+    double category_spacing = next_x - first_x;
+    
+    // Greedy left-to-right placement; labels that would overlap the previous one are skipped
+    const double label_gap = 6.0;
+    double last_right = -1e300;
+    char buffer[64];
+    size_t i = 0;
+    while (i < category_count) {
+        double screen_x;
+        transform_point(static_cast<double>(i), min_y, screen_x, screen_y);
+        const char* label = hist_data.category_label(i, buffer, sizeof(buffer));
+        
+        float& label_width = hist_data.label_widths[i];
+        if (label_width < 0) {
+            cairo_text_extents_t extents;
+            cairo_text_extents(cr, label, &extents);
+            label_width = static_cast<float>(extents.width);
+        }
+        
+        if (screen_x - label_width / 2 < last_right + label_gap) {
+            ++i;
+            continue;
+        }
+        
+        cairo_move_to(cr, screen_x - label_width / 2, height - margin_bottom + 20);
+        cairo_show_text(cr, label);
+        last_right = screen_x + label_width / 2;
+        
+        // Jump to the first category whose centre clears this label
+        size_t next = i + 1;
+        if (category_spacing > 0) {
+            double skip = std::floor((last_right + label_gap - screen_x) / category_spacing);
+            if (skip > 1) next = i + static_cast<size_t>(std::min(skip, static_cast<double>(category_count)));
+        }
+        i = next;
+    }
+}
+
 void HistogramPlot::collect_legend_items(std::vector<LegendItem>& items) {
     // Check if we have any discrete data
     bool has_discrete = false;
@@ -388,13 +636,21 @@ void HistogramPlot::collect_legend_items(std::vector<LegendItem>& items) {
     if (has_discrete) {
         // Add discrete histogram categories as rectangles
         for (const auto& hist_data : histogram_series) {
-            if (hist_data.is_discrete && !hist_data.categories.empty()) {
-                for (size_t i = 0; i < hist_data.categories.size(); ++i) {
-                    if (i < hist_data.styles.size() && hist_data.counts[i] > 0 && 
-                        hidden_legend_items.find(hist_data.categories[i]) == hidden_legend_items.end()) {
-                        // Only show categories that have data and are not hidden
-                        items.emplace_back(hist_data.categories[i], hist_data.styles[i], LegendSymbolType::RECTANGLE);
-                    }
+            if (!hist_data.is_discrete) continue;
+            
+            if (hist_data.counts.size() > MAX_CATEGORY_LEGEND_ITEMS) {
+                // Too many categories to list: one entry for the whole series
+                if (hidden_legend_items.find(hist_data.name) == hidden_legend_items.end()) {
+                    items.emplace_back(hist_data.name, hist_data.style, LegendSymbolType::RECTANGLE);
+                }
+                continue;
+            }
+            
+            for (size_t i = 0; i < hist_data.counts.size(); ++i) {
+                std::string category = hist_data.category_name(i);
+                if (hist_data.counts[i] > 0 && hidden_legend_items.find(category) == hidden_legend_items.end()) {
+                    // Only show categories that have data and are not hidden
+                    items.emplace_back(category, hist_data.category_style(i), LegendSymbolType::RECTANGLE);
                 }
             }
         }
@@ -406,12 +662,7 @@ void HistogramPlot::collect_legend_items(std::vector<LegendItem>& items) {
             }
         }
         
-        // Add reference lines
-        for (const auto& ref_line : reference_lines) {
-            if (!ref_line.label.empty() && hidden_legend_items.find(ref_line.label) == hidden_legend_items.end()) {
-                items.emplace_back(ref_line.label, ref_line.style, LegendSymbolType::LINE);
-            }
-        }
+        collect_reference_legend_items(items);
     } else {
         // Use parent implementation for continuous data only
         PlotManager::collect_legend_items(items);
@@ -428,11 +679,21 @@ void HistogramPlot::clear() {
 // Continuous histogram methods with new parameter ordering (data->naming->colors)
 void HistogramPlot::add_histogram(const std::vector<double>& values, const std::string& name, 
                                  const std::string& color_name, int bin_count) {
-    add_data(name, values, color_to_style(color_name, 3.0, 2.0), bin_count);
+    add_data(name, DataColumn(values), color_to_style(color_name, 3.0, 2.0), bin_count);
 }
 
 void HistogramPlot::add_histogram(const std::vector<double>& values, const std::string& name, int bin_count) {
     // Use automatic color based on series count
+    std::string color = get_auto_color(histogram_series.size());
+    add_data(name, DataColumn(values), color_to_style(color, 3.0, 2.0), bin_count);
+}
+
+void HistogramPlot::add_histogram(const DataColumn& values, const std::string& name,
+                                 const std::string& color_name, int bin_count) {
+    add_data(name, values, color_to_style(color_name, 3.0, 2.0), bin_count);
+}
+
+void HistogramPlot::add_histogram(const DataColumn& values, const std::string& name, int bin_count) {
     std::string color = get_auto_color(histogram_series.size());
     add_data(name, values, color_to_style(color, 3.0, 2.0), bin_count);
 }
@@ -442,6 +703,120 @@ void HistogramPlot::add_histogram(const std::vector<double>& values, int bin_cou
     add_histogram(values, auto_name, bin_count);
 }
 
+template<typename T>
+void HistogramPlot::add_integer_histogram(const std::vector<T>& values, const std::string& name,
+                                         const std::string& color_name, int bin_count) {
+    static_assert(std::is_integral<T>::value, "add_integer_histogram requires integer values");
+    if (values.empty()) {
+        std::cerr << "Error: Empty data provided for histogram series '" << name << "'" << std::endl;
+        return;
+    }
+    
+    // Validate that we're not mixing histogram types
+    validate_histogram_type_compatibility(false); // false = continuous
+    
+    trace::Scope scope("count_integers", "binning");
+    size_t chunks = parallel_chunk_count(values.size());
+    scope.arg("values", static_cast<long long>(values.size()));
+    scope.arg("threads", static_cast<long long>(chunks));
+    
+    // Small types: count every possible value directly, the range falls out of the table
+    std::vector<uint64_t> table;
+    uint64_t min_key = 0, max_key = 0;
+    if constexpr (sizeof(T) <= 2) {
+        table = count_small_integers(values, chunks);
+        while (table[min_key] == 0) ++min_key;
+        max_key = table.size() - 1;
+        while (table[max_key] == 0) --max_key;
+    } else {
+        std::vector<uint64_t> chunk_min(chunks), chunk_max(chunks);
+        parallel_for(values.size(), chunks, [&](size_t chunk, size_t begin, size_t end) {
+            auto minmax = std::minmax_element(values.begin() + begin, values.begin() + end);
+            chunk_min[chunk] = integer_key(*minmax.first);
+            chunk_max[chunk] = integer_key(*minmax.second);
+        });
+        min_key = *std::min_element(chunk_min.begin(), chunk_min.end());
+        max_key = *std::max_element(chunk_max.begin(), chunk_max.end());
+    }
+    
+    // Whole-integer bin width; a span narrower than the bin count gets one bin per value
+    if (bin_count <= 0) {
+        bin_count = auto_bin_count(values.size());
+    }
+    uint64_t span = max_key - min_key;
+    uint64_t bin_width = span / static_cast<uint64_t>(bin_count);
+    // Saturate instead of wrapping to 0 for a full 64-bit span in one bin (which then gets two)
+    if (bin_width < UINT64_MAX) ++bin_width;
+    size_t bins = static_cast<size_t>(span / bin_width) + 1;
+    scope.arg("bins", static_cast<long long>(bins));
+    
+    std::vector<uint64_t> totals(bins, 0);
+    if constexpr (sizeof(T) <= 2) {
+        for (uint64_t key = min_key; key <= max_key; ++key) {
+            totals[(key - min_key) / bin_width] += table[key];
+        }
+    } else {
+        std::vector<std::vector<uint32_t>> chunk_counts(chunks, std::vector<uint32_t>(bins, 0));
+        parallel_for(values.size(), chunks, [&](size_t chunk, size_t begin, size_t end) {
+            uint32_t* counts = chunk_counts[chunk].data();
+            if (bin_width == 1) {
+                for (size_t i = begin; i < end; ++i) {
+                    ++counts[integer_key(values[i]) - min_key];
+                }
+            } else {
+                for (size_t i = begin; i < end; ++i) {
+                    ++counts[(integer_key(values[i]) - min_key) / bin_width];
+                }
+            }
+        });
+        for (const auto& counts : chunk_counts) {
+            for (size_t bin = 0; bin < bins; ++bin) {
+                totals[bin] += counts[bin];
+            }
+        }
+    }
+    
+    HistogramData hist_data(name);
+    hist_data.style = color_to_style(color_name, 3.0, 2.0);
+    
+    // Bin edges halfway between integers
+    double min_value = static_cast<double>(static_cast<T>(min_key + static_cast<uint64_t>(std::numeric_limits<T>::min())));
+    hist_data.bins.reserve(bins + 1);
+    for (size_t bin = 0; bin <= bins; ++bin) {
+        hist_data.bins.push_back(min_value - 0.5 + static_cast<double>(bin) * static_cast<double>(bin_width));
+    }
+    hist_data.counts.reserve(bins);
+    for (uint64_t total : totals) {
+        hist_data.counts.push_back(static_cast<int>(std::min<uint64_t>(total, INT_MAX)));
+    }
+    
+    histogram_series.push_back(std::move(hist_data));
+    bounds_set = false;
+    mark_modified();
+}
+
+template<typename T>
+void HistogramPlot::add_integer_histogram(const std::vector<T>& values, const std::string& name, int bin_count) {
+    // Use automatic color based on series count
+    add_integer_histogram(values, name, get_auto_color(histogram_series.size()), bin_count);
+}
+
+#define PLOTLIB_INSTANTIATE_INTEGER_HISTOGRAM(T) \
+    template void HistogramPlot::add_integer_histogram<T>(const std::vector<T>&, const std::string&, \
+                                                          const std::string&, int); \
+    template void HistogramPlot::add_integer_histogram<T>(const std::vector<T>&, const std::string&, int);
+
+PLOTLIB_INSTANTIATE_INTEGER_HISTOGRAM(int8_t)
+PLOTLIB_INSTANTIATE_INTEGER_HISTOGRAM(uint8_t)
+PLOTLIB_INSTANTIATE_INTEGER_HISTOGRAM(int16_t)
+PLOTLIB_INSTANTIATE_INTEGER_HISTOGRAM(uint16_t)
+PLOTLIB_INSTANTIATE_INTEGER_HISTOGRAM(int32_t)
+PLOTLIB_INSTANTIATE_INTEGER_HISTOGRAM(uint32_t)
+PLOTLIB_INSTANTIATE_INTEGER_HISTOGRAM(int64_t)
+PLOTLIB_INSTANTIATE_INTEGER_HISTOGRAM(uint64_t)
+
+#undef PLOTLIB_INSTANTIATE_INTEGER_HISTOGRAM
+
 // Discrete histogram methods with simplified API (counts and names only)
 void HistogramPlot::add_histogram(const std::vector<int>& counts, const std::vector<std::string>& names,
                                  const std::vector<std::string>& color_names) {
@@ -455,13 +830,15 @@ void HistogramPlot::add_histogram(const std::vector<int>& counts, const std::vec
         return;
     }
     
-    // Convert color names to PlotStyle objects
-    std::vector<PlotStyle> styles;
+    // Convert color names to palette entries
+    HistogramData hist_data("Discrete");
+    hist_data.categories = names;
+    hist_data.palette_indices.reserve(counts.size());
     for (const auto& color_name : color_names) {
-        styles.push_back(color_to_style(color_name, 3.0, 2.0));
+        hist_data.palette_indices.push_back(palette_index(hist_data.palette, color_to_style(color_name, 3.0, 2.0)));
     }
     
-    add_discrete_data_simplified("Discrete", counts, names, styles);
+    add_compact_discrete_data(hist_data, counts);
 }
 
 void HistogramPlot::add_histogram(const std::vector<int>& counts, const std::vector<std::string>& names) {
@@ -470,69 +847,53 @@ void HistogramPlot::add_histogram(const std::vector<int>& counts, const std::vec
         return;
     }
     
-    // Generate automatic colors for each category
-    std::vector<PlotStyle> styles;
-    for (size_t i = 0; i < counts.size(); ++i) {
-        std::string color = get_auto_color(histogram_series.size() * counts.size() + i);
-        styles.push_back(color_to_style(color, 3.0, 2.0));
-    }
-    
-    add_discrete_data_simplified("Discrete", counts, names, styles);
+    HistogramData hist_data("Discrete");
+    hist_data.categories = names;
+    add_compact_discrete_data(hist_data, counts);
 }
 
 void HistogramPlot::add_histogram(const std::vector<int>& counts) {
-    // Generate automatic names: idx 1, idx 2, idx 3, ...
-    std::vector<std::string> auto_names;
-    for (size_t i = 0; i < counts.size(); ++i) {
-        auto_names.push_back("idx " + std::to_string(i + 1));
+    // Automatic names "idx 1", "idx 2", ... are generated when needed
+    HistogramData hist_data("Discrete");
+    hist_data.category_prefix = "idx";
+    add_compact_discrete_data(hist_data, counts);
+}
+
+uint16_t HistogramPlot::palette_index(std::vector<PlotStyle>& palette, const PlotStyle& style) {
+    for (size_t i = 0; i < palette.size(); ++i) {
+        const PlotStyle& entry = palette[i];
+        if (entry.r == style.r && entry.g == style.g && entry.b == style.b && entry.alpha == style.alpha &&
+            entry.point_size == style.point_size && entry.line_width == style.line_width) {
+            return static_cast<uint16_t>(i);
+        }
     }
-    
-    add_histogram(counts, auto_names);
+    if (palette.size() > UINT16_MAX) {
+        // Palette full: reuse the last entry
+        return UINT16_MAX;
+    }
+    palette.push_back(style);
+    return static_cast<uint16_t>(palette.size() - 1);
 }
 
 void HistogramPlot::add_discrete_data(const std::string& name, const std::vector<int>& counts, 
                                      const std::string& category_prefix, const std::vector<PlotStyle>& styles) {
-    if (counts.empty()) {
-        std::cerr << "Error: Empty count data provided for discrete histogram series '" << name << "'" << std::endl;
-        return;
-    }
-    
-    // Validate that we're not mixing histogram types
-    validate_histogram_type_compatibility(true); // true = discrete
-    
     if (styles.size() != counts.size()) {
         std::cerr << "Error: Number of styles (" << styles.size() << ") must match number of categories (" << counts.size() << ")" << std::endl;
         return;
     }
     
     HistogramData hist_data(name);
-    hist_data.is_discrete = true;
     hist_data.category_prefix = category_prefix;
-    hist_data.counts = counts;
-    hist_data.styles = styles;
-    
-    // Generate category names
-    for (size_t i = 0; i < counts.size(); ++i) {
-        hist_data.categories.push_back(category_prefix + " " + std::to_string(i + 1));
+    hist_data.palette_indices.reserve(styles.size());
+    for (const auto& style : styles) {
+        hist_data.palette_indices.push_back(palette_index(hist_data.palette, style));
     }
     
-    // Use the first style as the main style for legend purposes
-    hist_data.style = styles[0];
-    
-    histogram_series.push_back(hist_data);
-    bounds_set = false;
+    add_compact_discrete_data(hist_data, counts);
 }
 
 void HistogramPlot::add_discrete_data_simplified(const std::string& name, const std::vector<int>& counts, 
                                                 const std::vector<std::string>& names, const std::vector<PlotStyle>& styles) {
-    if (counts.empty()) {
-        std::cerr << "Error: Empty count data provided for discrete histogram series '" << name << "'" << std::endl;
-        return;
-    }
-    
-    // Validate that we're not mixing histogram types
-    validate_histogram_type_compatibility(true); // true = discrete
-    
     if (styles.size() != counts.size()) {
         std::cerr << "Error: Number of styles (" << styles.size() << ") must match number of categories (" << counts.size() << ")" << std::endl;
         return;
@@ -544,16 +905,45 @@ void HistogramPlot::add_discrete_data_simplified(const std::string& name, const
     }
     
     HistogramData hist_data(name);
+    hist_data.categories = names;
+    hist_data.palette_indices.reserve(styles.size());
+    for (const auto& style : styles) {
+        hist_data.palette_indices.push_back(palette_index(hist_data.palette, style));
+    }
+    
+    add_compact_discrete_data(hist_data, counts);
+}
+
+void HistogramPlot::add_compact_discrete_data(HistogramData& hist_data, const std::vector<int>& counts) {
+    if (counts.empty()) {
+        std::cerr << "Error: Empty count data provided for discrete histogram series '" << hist_data.name << "'" << std::endl;
+        return;
+    }
+    
+    // Validate that we're not mixing histogram types
+    validate_histogram_type_compatibility(true); // true = discrete
+    
+    if (hist_data.palette.empty()) {
+        // Automatic colors cycle through the shared palette, continuing across series
+        size_t offset = histogram_series.size() * counts.size();
+        for (const auto& color : auto_colors) {
+            hist_data.palette.push_back(color_to_style(color, 3.0, 2.0));
+        }
+        hist_data.palette_indices.resize(counts.size());
+        for (size_t i = 0; i < counts.size(); ++i) {
+            hist_data.palette_indices[i] = static_cast<uint16_t>((offset + i) % auto_colors.size());
+        }
+    }
+    
     hist_data.is_discrete = true;
     hist_data.counts = counts;
-    hist_data.styles = styles;
-    hist_data.categories = names; // Use provided names directly
     
-    // Use the first style as the main style for legend purposes
-    hist_data.style = styles[0];
+    // Use the first category's style as the main style for legend purposes
+    hist_data.style = hist_data.category_style(0);
     
-    histogram_series.push_back(hist_data);
+    histogram_series.push_back(std::move(hist_data));
     bounds_set = false;
+    mark_modified();
 }
 
 bool HistogramPlot::is_plot_empty() const {
@@ -573,4 +963,83 @@ bool HistogramPlot::is_plot_empty() const {
     return true;  // All histograms are empty
 }
 
+SnapshotPlotType HistogramPlot::snapshot_type() const {
+    return SnapshotPlotType::HISTOGRAM;
+}
+
+void HistogramPlot::write_snapshot(SnapshotWriter& writer) const {
+    PlotManager::write_snapshot(writer);
+    writer.put_u32(static_cast<uint32_t>(default_bin_count));
+    writer.put_bool(show_bin_envelope);
+    
+    writer.put_u64(histogram_series.size());
+    for (const auto& hist : histogram_series) {
+        writer.put_string(hist.name);
+        writer.put_style(hist.style);
+        writer.put_bool(hist.is_discrete);
+        writer.put_string(hist.category_prefix);
+        writer.put_column(hist.values);
+        writer.put_array(hist.bins);
+        writer.put_array(hist.counts);
+        
+        writer.put_u64(hist.categories.size());
+        for (const auto& category : hist.categories) {
+            writer.put_string(category);
+        }
+        writer.put_u64(hist.palette.size());
+        for (const auto& style : hist.palette) {
+            writer.put_style(style);
+        }
+        writer.put_array(hist.palette_indices);
+    }
+}
+
+bool HistogramPlot::read_snapshot(SnapshotReader& reader) {
+    if (!PlotManager::read_snapshot(reader)) return false;
+    default_bin_count = static_cast<int>(reader.get_u32());
+    show_bin_envelope = reader.get_bool();
+    
+    histogram_series.clear();
+    uint64_t series_count = reader.get_count(sizeof(uint64_t));
+    histogram_series.reserve(series_count);
+    for (uint64_t i = 0; i < series_count && reader.ok(); ++i) {
+        HistogramData hist(reader.get_string());
+        hist.style = reader.get_style();
+        hist.is_discrete = reader.get_bool();
+        hist.category_prefix = reader.get_string();
+        hist.values = reader.get_column();
+        reader.get_array(hist.bins);
+        reader.get_array(hist.counts);
+        
+        uint64_t category_count = reader.get_count(sizeof(uint64_t));
+        hist.categories.reserve(category_count);
+        for (uint64_t j = 0; j < category_count; ++j) {
+            hist.categories.push_back(reader.get_string());
+        }
+        uint64_t palette_count = reader.get_count(6 * sizeof(double) + sizeof(uint64_t));
+        hist.palette.reserve(palette_count);
+        for (uint64_t j = 0; j < palette_count; ++j) {
+            hist.palette.push_back(reader.get_style());
+        }
+        reader.get_array(hist.palette_indices);
+        
+        // Reject records that would index out of range while drawing
+        if (hist.is_discrete) {
+            if (hist.palette_indices.size() != hist.counts.size() ||
+                (!hist.categories.empty() && hist.categories.size() != hist.counts.size())) {
+                reader.fail();
+            }
+            for (uint16_t index : hist.palette_indices) {
+                if (index >= hist.palette.size()) reader.fail();
+            }
+        } else if (!hist.counts.empty() && hist.bins.size() != hist.counts.size() + 1) {
+            reader.fail();
+        }
+        histogram_series.push_back(std::move(hist));
+    }
+    
+    mark_modified();
+    return reader.ok();
+}
+
 } // namespace plotlib 
\ No newline at end of file
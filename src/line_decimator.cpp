@@ -0,0 +1,73 @@
+#include "line_decimator.h"
+#include <cmath>
+
+namespace plotlib {
+
+void LineDecimator::begin(cairo_t* context, double pixel_width) {
+    cr = context;
+    column_width = pixel_width > 0 ? pixel_width : 1.0;
+    has_column = false;
+    path_started = false;
+}
+
+void LineDecimator::emit(double x, double y) {
+    if (!path_started) {
+        cairo_move_to(cr, x, y);
+        path_started = true;
+    } else {
+        cairo_line_to(cr, x, y);
+    }
+}
+
+void LineDecimator::flush_column() {
+    if (!has_column) return;
+
+    emit(first_x, first_y);
+    if (min_before_max) {
+        emit(min_x, min_y);
+        emit(max_x, max_y);
+    } else {
+        emit(max_x, max_y);
+        emit(min_x, min_y);
+    }
+    emit(last_x, last_y);
+
+    has_column = false;
+}
+
+void LineDecimator::add_point(double screen_x, double screen_y) {
+    if (std::isnan(screen_x) || std::isnan(screen_y)) return;
+
+    long long point_column = static_cast<long long>(std::floor(screen_x / column_width));
+
+    if (has_column && point_column == column) {
+        if (screen_y < min_y) {
+            min_y = screen_y;
+            min_x = screen_x;
+            min_before_max = false;
+        }
+        if (screen_y > max_y) {
+            max_y = screen_y;
+            max_x = screen_x;
+            min_before_max = true;
+        }
+        last_x = screen_x;
+        last_y = screen_y;
+        return;
+    }
+
+    // Column changed: emit the finished one and open a new column
+    flush_column();
+
+    has_column = true;
+    column = point_column;
+    first_x = last_x = min_x = max_x = screen_x;
+    first_y = last_y = min_y = max_y = screen_y;
+    min_before_max = true;
+}
+
+void LineDecimator::finish() {
+    flush_column();
+}
+
+} // namespace plotlib
@@ -1,4 +1,6 @@
 #include "line_plot.h"
+#include "series_pyramid.h"
+#include "snapshot.h"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
@@ -12,18 +14,35 @@ LinePlot::LinePlot(int width, int height) : PlotManager(width, height) {
 
 void LinePlot::set_default_line_style(LineStyle style) {
     default_line_style = style;
+    mark_modified(false);
 }
 
 void LinePlot::set_default_line_width(double width) {
     default_line_width = width;
+    mark_modified(false);
 }
 
 void LinePlot::set_default_show_markers(bool enabled) {
     show_markers = enabled;
+    mark_modified(false);
 }
 
 void LinePlot::set_default_marker_type(MarkerType marker_type) {
     default_marker_type = marker_type;
+    mark_modified(false);
+}
+
+void LinePlot::set_marker_thinning(bool enabled) {
+    marker_thinning = enabled;
+    mark_modified(false);
+}
+
+void LinePlot::set_vector_tolerance(double tolerance) {
+    if (!(tolerance >= 0.0)) {
+        throw std::invalid_argument("Error: Vector tolerance must be zero or positive");
+    }
+    vector_tolerance = tolerance;
+    mark_modified(false);
 }
 
 void LinePlot::set_line_style(cairo_t* cr, LineStyle style, double line_width) {
@@ -52,32 +71,73 @@ void LinePlot::draw_data(cairo_t* cr) {
     // Draw lines
     draw_lines(cr);
     
+    // Draw disk-backed series
+    draw_pyramid_lines(cr);
+    
+    // Draw compressed series
+    for (const auto& series : compressed_series) {
+        draw_compressed_series(cr, series);
+    }
+    
     // Draw markers on top if enabled
     if (show_markers) {
         draw_markers(cr);
     }
 }
 
+double LinePlot::vector_path_tolerance(cairo_t* cr) const {
+    // Vector targets keep every vertex they are given, so paths are simplified to the
+    // tolerance instead; converted to user units along the axis that is scaled most
+    cairo_surface_type_t target = cairo_surface_get_type(cairo_get_target(cr));
+    if (vector_tolerance <= 0.0 || (target != CAIRO_SURFACE_TYPE_SVG && target != CAIRO_SURFACE_TYPE_PDF &&
+                                    target != CAIRO_SURFACE_TYPE_PS)) {
+        return 0.0;
+    }
+    double x_dx = vector_tolerance, x_dy = 0.0, y_dx = 0.0, y_dy = vector_tolerance;
+    cairo_device_to_user_distance(cr, &x_dx, &x_dy);
+    cairo_device_to_user_distance(cr, &y_dx, &y_dy);
+    return std::min(std::hypot(x_dx, x_dy), std::hypot(y_dx, y_dy));
+}
+
+void LinePlot::add_simplified_path(cairo_t* cr, const float* xy, size_t count, double tolerance) {
+    const std::vector<size_t>& kept = simplifier.simplify(xy, count, tolerance);
+    if (kept.empty()) return;
+    cairo_move_to(cr, xy[2 * kept[0]], xy[2 * kept[0] + 1]);
+    for (size_t k = 1; k < kept.size(); ++k) {
+        cairo_line_to(cr, xy[2 * kept[k]], xy[2 * kept[k] + 1]);
+    }
+}
+
 void LinePlot::draw_lines(cairo_t* cr) {
-    for (const auto& series : data_series) {
-        if (series.points.size() < 2) continue; // Need at least 2 points for a line
+    double tolerance = vector_path_tolerance(cr);
+    
+    for (auto& series : data_series) {
+        if (series.size() < 2) continue; // Need at least 2 points for a line
         
         // Set line style and color
         cairo_set_source_rgba(cr, series.style.r, series.style.g, series.style.b, series.style.alpha);
         set_line_style(cr, default_line_style, default_line_width);
         
-        // Start the path
-        bool first_point = true;
-        for (const auto& pt : series.points) {
-            double screen_x, screen_y;
-            transform_point(pt.x, pt.y, screen_x, screen_y);
-            
-            if (first_point) {
-                cairo_move_to(cr, screen_x, screen_y);
-                first_point = false;
+        const float* screen = screen_coordinates(series.screen, series.x.data(), series.y.data(), series.size());
+        if (tolerance > 0.0) {
+            add_simplified_path(cr, screen, series.size(), tolerance);
+            cairo_stroke(cr);
+            continue;
+        }
+        
+        // Start the path (sampled in draft mode, always ending at the last point)
+        size_t last = series.size() - 1;
+        size_t stride = series_stride(series.size());
+        size_t i = 0;
+        while (true) {
+            if (i == 0) {
+                cairo_move_to(cr, screen[0], screen[1]);
             } else {
-                cairo_line_to(cr, screen_x, screen_y);
+                cairo_line_to(cr, screen[2 * i], screen[2 * i + 1]);
             }
+            
+            if (i == last) break;
+            i = std::min(i + stride, last);
         }
         
         // Stroke the path
@@ -86,20 +146,413 @@ void LinePlot::draw_lines(cairo_t* cr) {
 }
 
 void LinePlot::draw_markers(cairo_t* cr) {
-    for (const auto& series : data_series) {
-        for (const auto& pt : series.points) {
+    for (auto& series : data_series) {
+        const float* screen = screen_coordinates(series.screen, series.x.data(), series.y.data(), series.size());
+        double spacing = marker_thinning ? 2.0 * series.style.point_size : 0.0;
+        draw_marker_run(cr, screen, 0, series.size(), series_stride(series.size()), default_marker_type,
+                        series.style.point_size, series.style.r, series.style.g, series.style.b,
+                        series.style.alpha, spacing);
+    }
+}
+
+void LinePlot::draw_pyramid_lines(cairo_t* cr) {
+    for (const auto& series : pyramid_series) {
+        draw_pyramid_series(cr, series);
+    }
+}
+
+void LinePlot::draw_pyramid_series(cairo_t* cr, const PyramidLineSeries& series) {
+    const SeriesPyramid& pyramid = *series.pyramid;
+    uint64_t point_count = pyramid.point_count();
+    if (point_count < 2) return;
+    
+    double plot_width = width - margin_left - margin_right;
+    double plot_height = height - margin_top - margin_bottom;
+    
+    // Width of one device pixel in user units (subplots are scaled)
+    double pixel_width = 1.0, pixel_dy = 0.0;
+    cairo_device_to_user_distance(cr, &pixel_width, &pixel_dy);
+    pixel_width = std::abs(pixel_width);
+    if (pixel_width <= 0) pixel_width = 1.0;
+    double columns = std::max(1.0, plot_width / pixel_width);
+    
+    // Raw index range of the visible window, plus one point on each side
+    uint64_t first = pyramid.lower_bound(min_x);
+    if (first > 0) --first;
+    uint64_t end = std::min(point_count, pyramid.lower_bound(max_x) + 1);
+    if (end <= first + 1) return;
+    uint64_t visible = end - first;
+    
+    cairo_save(cr);
+    cairo_rectangle(cr, margin_left, margin_top, plot_width, plot_height);
+    cairo_clip(cr);
+    cairo_set_source_rgba(cr, series.style.r, series.style.g, series.style.b, series.style.alpha);
+    set_line_style(cr, default_line_style, default_line_width);
+    
+    const Point2D* raw = pyramid.raw_points();
+    double screen_x, screen_y;
+    
+    // Vector targets collect the window and simplify it to the tolerance;
+    // raster targets draw sparse windows exactly and decimate dense ones
+    double tolerance = vector_path_tolerance(cr);
+    bool decimate = tolerance <= 0.0 && visible > columns * 4;
+    bool started = false;
+    vector_path.clear();
+    auto add_vertex = [&](double x, double y) {
+        if (tolerance > 0.0) {
+            vector_path.push_back(static_cast<float>(x));
+            vector_path.push_back(static_cast<float>(y));
+        } else if (decimate) {
+            decimator.add_point(x, y);
+        } else if (started) {
+            cairo_line_to(cr, x, y);
+        } else {
+            cairo_move_to(cr, x, y);
+            started = true;
+        }
+    };
+    
+    if (decimate) decimator.begin(cr, pixel_width);
+    if (visible <= columns * 4) {
+        // Few enough points in the window: use them all
+        for (uint64_t i = first; i < end; ++i) {
+            transform_point(raw[i].x, raw[i].y, screen_x, screen_y);
+            add_vertex(screen_x, screen_y);
+        }
+    } else {
+        // Pick the coarsest level that still has two buckets per pixel column
+        double points_per_column = visible / columns;
+        int chosen_level = -1;
+        for (uint32_t level = pyramid.level_count(); level-- > 0;) {
+            if (pyramid.level_span(level) * 2 <= points_per_column) {
+                chosen_level = static_cast<int>(level);
+                break;
+            }
+        }
+        
+        if (chosen_level < 0) {
+            // Level 0 is still too coarse: use the raw points of the window
+            for (uint64_t i = first; i < end; ++i) {
+                transform_point(raw[i].x, raw[i].y, screen_x, screen_y);
+                add_vertex(screen_x, screen_y);
+            }
+        } else {
+            uint32_t level = static_cast<uint32_t>(chosen_level);
+            uint64_t span = pyramid.level_span(level);
+            uint64_t last_bucket = std::min(pyramid.level_size(level) - 1, (end - 1) / span);
+            const PyramidBucket* buckets = pyramid.level(level);
+            
+            for (uint64_t b = first / span; b <= last_bucket; ++b) {
+                const PyramidBucket& bucket = buckets[b];
+                double mid_x = (bucket.x_first + bucket.x_last) / 2.0;
+                
+                transform_point(bucket.x_first, bucket.y_first, screen_x, screen_y);
+                add_vertex(screen_x, screen_y);
+                transform_point(mid_x, bucket.y_min, screen_x, screen_y);
+                add_vertex(screen_x, screen_y);
+                transform_point(mid_x, bucket.y_max, screen_x, screen_y);
+                add_vertex(screen_x, screen_y);
+                transform_point(bucket.x_last, bucket.y_last, screen_x, screen_y);
+                add_vertex(screen_x, screen_y);
+            }
+        }
+    }
+    if (decimate) decimator.finish();
+    if (tolerance > 0.0) add_simplified_path(cr, vector_path.data(), vector_path.size() / 2, tolerance);
+    
+    cairo_stroke(cr);
+    cairo_restore(cr);
+}
+
+void LinePlot::draw_compressed_series(cairo_t* cr, const CompressedLineSeries& series) {
+    const CompressedSeries& data = series.data;
+    if (data.size() < 2) return;
+    
+    double plot_width = width - margin_left - margin_right;
+    double plot_height = height - margin_top - margin_bottom;
+    
+    // Width of one device pixel in user units (subplots are scaled)
+    double pixel_width = 1.0, pixel_dy = 0.0;
+    cairo_device_to_user_distance(cr, &pixel_width, &pixel_dy);
+    pixel_width = std::abs(pixel_width);
+    if (pixel_width <= 0) pixel_width = 1.0;
+    double columns = std::max(1.0, plot_width / pixel_width);
+    
+    // Blocks covering the visible window, plus one block on each side
+    size_t first = 0;
+    size_t end = data.block_count();
+    if (data.is_sorted()) {
+        while (first < end && data.block(first).max_x < min_x) ++first;
+        if (first > 0) --first;
+        size_t last = first;
+        while (last < end && data.block(last).min_x <= max_x) ++last;
+        end = std::min(end, last + 1);
+    }
+    uint64_t visible = 0;
+    for (size_t b = first; b < end; ++b) visible += data.block(b).count;
+    if (visible < 2) return;
+    
+    cairo_save(cr);
+    cairo_rectangle(cr, margin_left, margin_top, plot_width, plot_height);
+    cairo_clip(cr);
+    cairo_set_source_rgba(cr, series.style.r, series.style.g, series.style.b, series.style.alpha);
+    set_line_style(cr, default_line_style, default_line_width);
+    
+    // Vector targets simplify the window to the tolerance; on raster targets dense
+    // sorted windows go through the decimator and everything else is drawn exactly
+    double tolerance = vector_path_tolerance(cr);
+    bool decimate = tolerance <= 0.0 && data.is_sorted() && visible > columns * 4;
+    if (decimate) decimator.begin(cr, pixel_width);
+    vector_path.clear();
+    decoded_x.resize(CompressedSeries::BLOCK_POINTS);
+    decoded_y.resize(CompressedSeries::BLOCK_POINTS);
+    bool started = false;
+    for (size_t b = first; b < end; ++b) {
+        size_t count = data.decode_block(b, decoded_x.data(), decoded_y.data());
+        for (size_t i = 0; i < count; ++i) {
             double screen_x, screen_y;
-            transform_point(pt.x, pt.y, screen_x, screen_y);
+            transform_point(decoded_x[i], decoded_y[i], screen_x, screen_y);
+            if (tolerance > 0.0) {
+                vector_path.push_back(static_cast<float>(screen_x));
+                vector_path.push_back(static_cast<float>(screen_y));
+            } else if (decimate) {
+                decimator.add_point(screen_x, screen_y);
+            } else if (started) {
+                cairo_line_to(cr, screen_x, screen_y);
+            } else {
+                cairo_move_to(cr, screen_x, screen_y);
+                started = true;
+            }
+        }
+    }
+    if (decimate) decimator.finish();
+    if (tolerance > 0.0) add_simplified_path(cr, vector_path.data(), vector_path.size() / 2, tolerance);
+    
+    cairo_stroke(cr);
+    cairo_restore(cr);
+}
+
+void LinePlot::calculate_bounds() {
+    if (pyramid_series.empty() && compressed_series.empty()) {
+        PlotManager::calculate_bounds();
+        return;
+    }
+    
+    bool first = true;
+    
+    // Regular series
+    for (const auto& series : data_series) {
+        const double* xs = series.x.data();
+        const double* ys = series.y.data();
+        for (size_t i = 0; i < series.size(); ++i) {
+            if (first) {
+                min_x = max_x = xs[i];
+                min_y = max_y = ys[i];
+                first = false;
+            } else {
+                min_x = std::min(min_x, xs[i]);
+                max_x = std::max(max_x, xs[i]);
+                min_y = std::min(min_y, ys[i]);
+                max_y = std::max(max_y, ys[i]);
+            }
+        }
+    }
+    
+    // Pyramid series carry their bounds in the file header
+    for (const auto& series : pyramid_series) {
+        const SeriesPyramid& pyramid = *series.pyramid;
+        if (pyramid.point_count() == 0) continue;
+        
+        if (first) {
+            min_x = pyramid.min_x();
+            max_x = pyramid.max_x();
+            min_y = pyramid.min_y();
+            max_y = pyramid.max_y();
+            first = false;
+        } else {
+            min_x = std::min(min_x, pyramid.min_x());
+            max_x = std::max(max_x, pyramid.max_x());
+            min_y = std::min(min_y, pyramid.min_y());
+            max_y = std::max(max_y, pyramid.max_y());
+        }
+    }
+    
+    // Compressed series carry their bounds in the block index
+    for (const auto& series : compressed_series) {
+        for (const auto& block : series.data.block_index()) {
+            if (first) {
+                min_x = block.min_x;
+                max_x = block.max_x;
+                min_y = block.min_y;
+                max_y = block.max_y;
+                first = false;
+            } else {
+                min_x = std::min(min_x, block.min_x);
+                max_x = std::max(max_x, block.max_x);
+                min_y = std::min(min_y, block.min_y);
+                max_y = std::max(max_y, block.max_y);
+            }
+        }
+    }
+    
+    if (first) return;
+    
+    // Add some padding
+    double x_range = max_x - min_x;
+    double y_range = max_y - min_y;
+    
+    if (x_range == 0) x_range = 1;
+    if (y_range == 0) y_range = 1;
+    
+    min_x -= x_range * 0.05;
+    max_x += x_range * 0.05;
+    min_y -= y_range * 0.05;
+    max_y += y_range * 0.05;
+    
+    bounds_set = true;
+}
+
+bool LinePlot::is_plot_empty() const {
+    for (const auto& series : pyramid_series) {
+        if (series.pyramid->point_count() > 0) {
+            return false;
+        }
+    }
+    for (const auto& series : compressed_series) {
+        if (!series.data.empty()) {
+            return false;
+        }
+    }
+    return PlotManager::is_plot_empty();
+}
+
+void LinePlot::collect_legend_items(std::vector<LegendItem>& items) {
+    PlotManager::collect_legend_items(items);
+    
+    for (const auto& series : pyramid_series) {
+        if (!series.name.empty() && hidden_legend_items.find(series.name) == hidden_legend_items.end()) {
+            items.emplace_back(series.name, series.style, LegendSymbolType::MARKER, MarkerType::CIRCLE);
+        }
+    }
+    for (const auto& series : compressed_series) {
+        if (!series.name.empty() && hidden_legend_items.find(series.name) == hidden_legend_items.end()) {
+            items.emplace_back(series.name, series.style, LegendSymbolType::MARKER, MarkerType::CIRCLE);
+        }
+    }
+}
+
+bool LinePlot::collect_html_series(std::vector<HtmlSeries>& series) {
+    if (!pyramid_series.empty() || !compressed_series.empty()) return false;
+    
+    // Same order as draw_data(): all lines, then all markers
+    for (int pass = 0; pass < (show_markers ? 2 : 1); ++pass) {
+        bool line = pass == 0;
+        for (const auto& data : data_series) {
+            if (line && data.size() < 2) continue;
             
-            draw_marker(cr, screen_x, screen_y, default_marker_type, 
-                       series.style.point_size, series.style.r, series.style.g, 
-                       series.style.b, series.style.alpha);
+            HtmlSeries entry;
+            entry.line = line;
+            entry.marker = default_marker_type;
+            entry.style = data.style;
+            if (line) {
+                entry.style.line_width = default_line_width;
+                if (default_line_style == LineStyle::DASHED) entry.dashes = {10.0, 5.0};
+                if (default_line_style == LineStyle::DOTTED) entry.dashes = {2.0, 3.0};
+            }
+            entry.x.reserve(data.size());
+            entry.y.reserve(data.size());
+            const double* xs = data.x.data();
+            const double* ys = data.y.data();
+            for (size_t i = 0; i < data.size(); ++i) {
+                entry.x.push_back(static_cast<float>(xs[i] - min_x));
+                entry.y.push_back(static_cast<float>(ys[i] - min_y));
+            }
+            series.push_back(std::move(entry));
         }
     }
+    return true;
+}
+
+void LinePlot::clear() {
+    PlotManager::clear();
+    pyramid_series.clear();
+    compressed_series.clear();
+}
+
+bool LinePlot::add_line_pyramid(const std::string& filename, const std::string& name, const std::string& color_name) {
+    std::shared_ptr<SeriesPyramid> pyramid = SeriesPyramid::open(filename);
+    if (!pyramid) return false;
+    
+    PyramidLineSeries series;
+    series.pyramid = pyramid;
+    series.style = color_to_style(color_name, 3.0, 2.0);
+    series.name = name;
+    series.filename = filename;
+    
+    pyramid_series.push_back(series);
+    bounds_set = false;
+    mark_modified();
+    return true;
+}
+
+bool LinePlot::add_line_pyramid(const std::string& filename, const std::string& name) {
+    std::string color = get_auto_color(data_series.size() + pyramid_series.size());
+    return add_line_pyramid(filename, name, color);
+}
+
+void LinePlot::add_compressed_line(const std::vector<double>& x_values, const std::vector<double>& y_values,
+                                   const std::string& name, const std::string& color_name) {
+    if (x_values.size() != y_values.size()) {
+        std::cerr << "Error: X and Y vectors must have the same size" << std::endl;
+        return;
+    }
+    
+    CompressedLineSeries series;
+    series.data.append(x_values.data(), y_values.data(), x_values.size());
+    series.data.shrink_to_fit();
+    series.style = color_to_style(color_name, 3.0, 2.0);
+    series.name = name;
+    
+    compressed_series.push_back(std::move(series));
+    bounds_set = false;
+    mark_modified();
+}
+
+void LinePlot::add_compressed_line(const std::vector<double>& x_values, const std::vector<double>& y_values,
+                                   const std::string& name) {
+    std::string color = get_auto_color(data_series.size() + pyramid_series.size() + compressed_series.size());
+    add_compressed_line(x_values, y_values, name, color);
+}
+
+bool LinePlot::append_to_compressed_line(size_t series_index, const std::vector<double>& x_values,
+                                         const std::vector<double>& y_values) {
+    if (series_index >= compressed_series.size()) {
+        std::cerr << "Error: Series index " << series_index << " out of range" << std::endl;
+        return false;
+    }
+    if (x_values.size() != y_values.size()) {
+        std::cerr << "Error: X and Y vectors must have the same size" << std::endl;
+        return false;
+    }
+    
+    compressed_series[series_index].data.append(x_values.data(), y_values.data(), x_values.size());
+    bounds_set = false;
+    mark_modified(false);
+    return true;
+}
+
+bool LinePlot::save_line_pyramid(size_t series_index, const std::string& filename) const {
+    if (series_index >= data_series.size()) {
+        std::cerr << "Error: Series index " << series_index << " out of range" << std::endl;
+        return false;
+    }
+    const DataSeries& series = data_series[series_index];
+    PyramidFileWriter writer(filename);
+    return writer.is_open() && writer.append(series.x.data(), series.y.data(), series.size()) && writer.finish();
 }
 
 // Beginner-friendly convenience methods
-void LinePlot::add_line(const std::vector<double>& x_values, const std::vector<double>& y_values,
+void LinePlot::add_line(const DataColumn& x_values, const DataColumn& y_values,
                        const std::string& name, const std::string& color_name) {
     if (x_values.size() != y_values.size()) {
         std::cerr << "Error: X and Y vectors must have the same size" << std::endl;
@@ -107,32 +560,34 @@ void LinePlot::add_line(const std::vector<double>& x_values, const std::vector<d
     }
     
     DataSeries series(name);
-    for (size_t i = 0; i < x_values.size(); ++i) {
-        series.points.emplace_back(x_values[i], y_values[i]);
-    }
+    series.x = x_values;
+    series.y = y_values;
     series.style = color_to_style(color_name, 3.0, 2.0);
     
-    data_series.push_back(series);
+    data_series.push_back(std::move(series));
     bounds_set = false;
+    mark_modified();
 }
 
-void LinePlot::add_line(const std::vector<double>& x_values, const std::vector<double>& y_values,
+void LinePlot::add_line(const DataColumn& x_values, const DataColumn& y_values,
                        const std::string& name) {
+    std::string color = get_auto_color(data_series.size());
+    add_line(x_values, y_values, name, color);
+}
+
+void LinePlot::add_line(const std::vector<double>& x_values, const std::vector<double>& y_values,
+                       const std::string& name, const std::string& color_name) {
     if (x_values.size() != y_values.size()) {
         std::cerr << "Error: X and Y vectors must have the same size" << std::endl;
         return;
     }
-    
-    DataSeries series(name);
-    for (size_t i = 0; i < x_values.size(); ++i) {
-        series.points.emplace_back(x_values[i], y_values[i]);
-    }
-    
+    add_line(DataColumn(x_values), DataColumn(y_values), name, color_name);
+}
+
+void LinePlot::add_line(const std::vector<double>& x_values, const std::vector<double>& y_values,
+                       const std::string& name) {
     std::string color = get_auto_color(data_series.size());
-    series.style = color_to_style(color, 3.0, 2.0);
-    
-    data_series.push_back(series);
-    bounds_set = false;
+    add_line(x_values, y_values, name, color);
 }
 
 void LinePlot::add_line(const std::vector<double>& x_values, const std::vector<double>& y_values) {
@@ -140,4 +595,119 @@ void LinePlot::add_line(const std::vector<double>& x_values, const std::vector<d
     add_line(x_values, y_values, auto_name);
 }
 
+SnapshotPlotType LinePlot::snapshot_type() const {
+    return SnapshotPlotType::LINE;
+}
+
+void LinePlot::write_snapshot(SnapshotWriter& writer) const {
+    PlotManager::write_snapshot(writer);
+    writer.put_u32(static_cast<uint32_t>(default_line_style));
+    writer.put_f64(default_line_width);
+    writer.put_bool(show_markers);
+    writer.put_u32(static_cast<uint32_t>(default_marker_type));
+    writer.put_f64(vector_tolerance);
+    writer.put_bool(marker_thinning);
+    
+    writer.put_u64(pyramid_series.size());
+    for (const auto& series : pyramid_series) {
+        writer.put_string(series.filename);
+        writer.put_style(series.style);
+        writer.put_string(series.name);
+    }
+    
+    writer.put_u64(compressed_series.size());
+    for (const auto& series : compressed_series) {
+        writer.put_string(series.name);
+        writer.put_style(series.style);
+        writer.put_bool(series.data.is_sorted());
+        writer.put_array(series.data.block_index());
+        writer.put_array(series.data.bit_stream());
+    }
+}
+
+void LinePlot::hash_external_inputs(SnapshotWriter& hasher) const {
+    for (const auto& series : pyramid_series) {
+        const SeriesPyramid& pyramid = *series.pyramid;
+        hasher.put_u64(pyramid.file_size());
+        hasher.put_u64(static_cast<uint64_t>(pyramid.modified_time()));
+        hasher.put_u64(pyramid.point_count());
+        hasher.put_u32(pyramid.block_points());
+        hasher.put_u32(pyramid.fanout());
+        hasher.put_f64(pyramid.min_x());
+        hasher.put_f64(pyramid.max_x());
+        hasher.put_f64(pyramid.min_y());
+        hasher.put_f64(pyramid.max_y());
+        // The coarsest level summarises every raw point in a few buckets
+        if (pyramid.level_count() > 0) {
+            uint32_t top = pyramid.level_count() - 1;
+            const PyramidBucket* buckets = pyramid.level(top);
+            for (uint64_t i = 0; i < pyramid.level_size(top); ++i) {
+                const PyramidBucket& bucket = buckets[i];
+                hasher.put_f64(bucket.x_first);
+                hasher.put_f64(bucket.x_last);
+                hasher.put_f64(bucket.y_first);
+                hasher.put_f64(bucket.y_last);
+                hasher.put_f64(bucket.y_min);
+                hasher.put_f64(bucket.y_max);
+            }
+        }
+    }
+}
+
+bool LinePlot::read_snapshot(SnapshotReader& reader) {
+    if (!PlotManager::read_snapshot(reader)) return false;
+    uint32_t line_style = reader.get_u32();
+    default_line_width = reader.get_f64();
+    show_markers = reader.get_bool();
+    uint32_t marker = reader.get_u32();
+    double tolerance = reader.get_f64();
+    bool thinning = reader.get_bool();
+    if (line_style > static_cast<uint32_t>(LineStyle::DOTTED) ||
+        marker > static_cast<uint32_t>(MarkerType::TRIANGLE) || !(tolerance >= 0.0)) {
+        reader.fail();
+        return false;
+    }
+    default_line_style = static_cast<LineStyle>(line_style);
+    default_marker_type = static_cast<MarkerType>(marker);
+    vector_tolerance = tolerance;
+    marker_thinning = thinning;
+    
+    pyramid_series.clear();
+    uint64_t series_count = reader.get_count(sizeof(uint64_t));
+    for (uint64_t i = 0; i < series_count && reader.ok(); ++i) {
+        PyramidLineSeries series;
+        series.filename = reader.get_string();
+        series.style = reader.get_style();
+        series.name = reader.get_string();
+        if (!reader.ok()) break;
+        series.pyramid = SeriesPyramid::open(series.filename);
+        if (!series.pyramid) {
+            reader.fail();
+            break;
+        }
+        pyramid_series.push_back(std::move(series));
+    }
+    
+    compressed_series.clear();
+    series_count = reader.get_count(sizeof(uint64_t));
+    for (uint64_t i = 0; i < series_count && reader.ok(); ++i) {
+        CompressedLineSeries series;
+        series.name = reader.get_string();
+        series.style = reader.get_style();
+        bool sorted = reader.get_bool();
+        std::vector<CompressedBlock> blocks;
+        std::vector<uint64_t> words;
+        reader.get_array(blocks);
+        reader.get_array(words);
+        if (!reader.ok() || !series.data.restore(std::move(blocks), std::move(words), sorted)) {
+            reader.fail();
+            break;
+        }
+        compressed_series.push_back(std::move(series));
+    }
+    
+    mark_modified();
+    return reader.ok();
+}
+
 } // namespace plotlib 
\ No newline at end of file
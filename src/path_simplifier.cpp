@@ -0,0 +1,79 @@
+#include "path_simplifier.h"
+#include <cmath>
+
+namespace plotlib {
+
+namespace {
+
+// Squared distance from (px, py) to the segment (ax, ay)-(bx, by)
+double segment_distance_squared(double px, double py, double ax, double ay, double bx, double by) {
+    double dx = bx - ax;
+    double dy = by - ay;
+    double length_squared = dx * dx + dy * dy;
+    double t = 0.0;
+    if (length_squared > 0.0) {
+        t = ((px - ax) * dx + (py - ay) * dy) / length_squared;
+        t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+    }
+    double ex = ax + t * dx - px;
+    double ey = ay + t * dy - py;
+    return ex * ex + ey * ey;
+}
+
+} // anonymous namespace
+
+const std::vector<size_t>& PathSimplifier::simplify(const float* xy, size_t count, double tolerance) {
+    kept.clear();
+    if (count == 0) return kept;
+    keep.assign(count, 0);
+    ranges.clear();
+
+    // Each run of finite vertices is simplified on its own
+    size_t run_start = count;
+    for (size_t i = 0; i <= count; ++i) {
+        bool finite = i < count && std::isfinite(xy[2 * i]) && std::isfinite(xy[2 * i + 1]);
+        if (finite) {
+            if (run_start == count) run_start = i;
+            continue;
+        }
+        if (i < count) keep[i] = 1;
+        if (run_start != count) {
+            keep[run_start] = 1;
+            keep[i - 1] = 1;
+            if (i - 1 > run_start + 1) ranges.emplace_back(run_start, i - 1);
+            run_start = count;
+        }
+    }
+
+    double limit = tolerance * tolerance;
+    while (!ranges.empty()) {
+        size_t first = ranges.back().first;
+        size_t last = ranges.back().second;
+        ranges.pop_back();
+
+        double ax = xy[2 * first], ay = xy[2 * first + 1];
+        double bx = xy[2 * last], by = xy[2 * last + 1];
+        double farthest = -1.0;
+        size_t split = first;
+        for (size_t i = first + 1; i < last; ++i) {
+            double distance = segment_distance_squared(xy[2 * i], xy[2 * i + 1], ax, ay, bx, by);
+            if (distance > farthest) {
+                farthest = distance;
+                split = i;
+            }
+        }
+
+        if (farthest > limit) {
+            keep[split] = 1;
+            if (split - first > 1) ranges.emplace_back(first, split);
+            if (last - split > 1) ranges.emplace_back(split, last);
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (keep[i]) kept.push_back(i);
+    }
+    return kept;
+}
+
+} // namespace plotlib
@@ -1,7 +1,13 @@
 #include "plot_manager.h"
+#include "fonts.h"
+#include "render_cache.h"
 #include "scatter_plot.h"
+#include "surface_pool.h"
+#include "trace.h"
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -11,6 +17,213 @@
 
 namespace plotlib {
 
+namespace {
+
+cairo_status_t append_to_vector(void* closure, const unsigned char* data, unsigned int length) {
+    auto* buffer = static_cast<std::vector<unsigned char>*>(closure);
+    buffer->insert(buffer->end(), data, data + length);
+    return CAIRO_STATUS_SUCCESS;
+}
+
+cairo_status_t append_to_string(void* closure, const unsigned char* data, unsigned int length) {
+    auto* buffer = static_cast<std::string*>(closure);
+    buffer->append(reinterpret_cast<const char*>(data), length);
+    return CAIRO_STATUS_SUCCESS;
+}
+
+std::string base64_encode(const unsigned char* data, size_t size) {
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string encoded;
+    encoded.reserve((size + 2) / 3 * 4);
+    size_t i = 0;
+    for (; i + 2 < size; i += 3) {
+        uint32_t triple = (uint32_t(data[i]) << 16) | (uint32_t(data[i + 1]) << 8) | data[i + 2];
+        encoded += alphabet[(triple >> 18) & 63];
+        encoded += alphabet[(triple >> 12) & 63];
+        encoded += alphabet[(triple >> 6) & 63];
+        encoded += alphabet[triple & 63];
+    }
+    if (i < size) {
+        uint32_t triple = uint32_t(data[i]) << 16;
+        if (i + 1 < size) triple |= uint32_t(data[i + 1]) << 8;
+        encoded += alphabet[(triple >> 18) & 63];
+        encoded += alphabet[(triple >> 12) & 63];
+        encoded += (i + 1 < size) ? alphabet[(triple >> 6) & 63] : '=';
+        encoded += '=';
+    }
+    return encoded;
+}
+
+// Float32 columns are stored in native byte order (little-endian on all supported targets)
+std::string base64_floats(const std::vector<float>& values) {
+    return base64_encode(reinterpret_cast<const unsigned char*>(values.data()), values.size() * sizeof(float));
+}
+
+std::string escape_html(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        switch (c) {
+            case '&': escaped += "&amp;"; break;
+            case '<': escaped += "&lt;"; break;
+            case '>': escaped += "&gt;"; break;
+            case '"': escaped += "&quot;"; break;
+            default: escaped += c; break;
+        }
+    }
+    return escaped;
+}
+
+// Index of the group drawn with the same colour and width as style, adding a group if needed
+size_t style_group(std::vector<const PlotStyle*>& groups, const PlotStyle& style) {
+    for (size_t i = 0; i < groups.size(); ++i) {
+        const PlotStyle& group = *groups[i];
+        if (group.r == style.r && group.g == style.g && group.b == style.b &&
+            group.alpha == style.alpha && group.line_width == style.line_width) {
+            return i;
+        }
+    }
+    groups.push_back(&style);
+    return groups.size() - 1;
+}
+
+const char* html_marker_name(MarkerType type) {
+    switch (type) {
+        case MarkerType::CIRCLE: return "circle";
+        case MarkerType::CROSS: return "cross";
+        case MarkerType::SQUARE: return "square";
+        case MarkerType::TRIANGLE: return "triangle";
+    }
+    return "circle";
+}
+
+// Draws the series of the embedded plot object onto the data canvas, mirroring draw_marker()
+const char* HTML_DRAW_SCRIPT = R"(
+function decode(text) {
+  var binary = atob(text), bytes = new Uint8Array(binary.length);
+  for (var i = 0; i < binary.length; ++i) bytes[i] = binary.charCodeAt(i);
+  return new Float32Array(bytes.buffer);
+}
+var canvas = document.getElementById('plotlib-data');
+var ratio = window.devicePixelRatio || 1;
+canvas.width = plot.width * ratio;
+canvas.height = plot.height * ratio;
+var ctx = canvas.getContext('2d');
+ctx.scale(ratio, ratio);
+var sx = plot.plotWidth / (plot.maxX - plot.minX), sy = plot.plotHeight / (plot.maxY - plot.minY);
+plot.series.forEach(function (s) {
+  var xs = decode(s.x), ys = decode(s.y), n = xs.length, size = s.size;
+  ctx.fillStyle = ctx.strokeStyle = s.color;
+  ctx.beginPath();
+  if (s.line) {
+    ctx.lineWidth = s.width;
+    ctx.setLineDash(s.dashes);
+    for (var i = 0; i < n; ++i) {
+      var px = plot.left + xs[i] * sx, py = plot.bottom - ys[i] * sy;
+      if (i == 0) ctx.moveTo(px, py); else ctx.lineTo(px, py);
+    }
+    ctx.stroke();
+    return;
+  }
+  ctx.setLineDash([]);
+  ctx.lineWidth = size * 0.4;
+  var cross = s.marker == 'cross';
+  var paint = function () { if (cross) ctx.stroke(); else ctx.fill(); };
+  // Translucent markers are painted one by one so overlaps darken as in the PNG output
+  var batch = s.alpha >= 1;
+  for (var i = 0; i < n; ++i) {
+    var px = plot.left + xs[i] * sx, py = plot.bottom - ys[i] * sy;
+    if (s.marker == 'circle') {
+      ctx.moveTo(px + size, py);
+      ctx.arc(px, py, size, 0, 2 * Math.PI);
+    } else if (s.marker == 'square') {
+      ctx.rect(px - size, py - size, 2 * size, 2 * size);
+    } else if (s.marker == 'triangle') {
+      ctx.moveTo(px, py - size);
+      ctx.lineTo(px - size * 0.866, py + size * 0.5);
+      ctx.lineTo(px + size * 0.866, py + size * 0.5);
+      ctx.closePath();
+    } else {
+      ctx.moveTo(px - size, py - size);
+      ctx.lineTo(px + size, py + size);
+      ctx.moveTo(px - size, py + size);
+      ctx.lineTo(px + size, py - size);
+    }
+    if (!batch) {
+      paint();
+      ctx.beginPath();
+    }
+  }
+  if (batch) paint();
+});
+)";
+
+// Copy an ARGB32 image surface into a tightly packed buffer
+/**
+ * @brief Write a complete output file
+ * @param filename Output filename
+ * @param data Bytes to write
+ * @param size Number of bytes
+ * @param kind File kind for the error message (e.g. "PNG")
+ * @return true if successful, false otherwise
+ */
+bool write_output_file(const std::string& filename, const void* data, size_t size, const char* kind) {
+    PLOTLIB_TRACE_SCOPE("write_output_file", "io");
+    FILE* file = std::fopen(filename.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error: Cannot open " << kind << " file '" << filename << "' for writing" << std::endl;
+        return false;
+    }
+    bool success = std::fwrite(data, 1, size, file) == size;
+    return std::fclose(file) == 0 && success;
+}
+
+bool copy_surface_pixels(cairo_surface_t* surface, std::vector<unsigned char>& pixels) {
+    if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) return false;
+    
+    cairo_surface_flush(surface);
+    int surface_width = cairo_image_surface_get_width(surface);
+    int surface_height = cairo_image_surface_get_height(surface);
+    int stride = cairo_image_surface_get_stride(surface);
+    const unsigned char* data = cairo_image_surface_get_data(surface);
+    
+    size_t row_bytes = static_cast<size_t>(surface_width) * 4;
+    pixels.resize(row_bytes * surface_height);
+    for (int row = 0; row < surface_height; ++row) {
+        std::copy(data + static_cast<size_t>(row) * stride, data + static_cast<size_t>(row) * stride + row_bytes,
+                  pixels.begin() + row_bytes * row);
+    }
+    return true;
+}
+
+/**
+ * @brief Choose the sampling strides of a progressive render
+ * @param largest_series Points in the largest sampled series
+ * @param min_points Points a series keeps in the coarsest pass
+ * @param strides Output, at least 4 entries; the last stride is always 1
+ * @return Number of passes
+ * 
+ * Passes that would not sample the largest series any differently from the
+ * previous one are dropped.
+ */
+int choose_progressive_strides(size_t largest_series, size_t min_points, size_t* strides) {
+    static const size_t pass_strides[] = {64, 16, 4};
+    size_t max_useful = std::max<size_t>(1, largest_series / min_points);
+    
+    int pass_count = 0;
+    size_t previous = 1;
+    for (size_t stride : pass_strides) {
+        size_t effective = std::min(stride, max_useful);
+        if (effective > 1 && effective != previous) {
+            strides[pass_count++] = stride;
+            previous = effective;
+        }
+    }
+    strides[pass_count++] = 1;
+    return pass_count;
+}
+
+} // namespace
+
 // Static member initialization
 std::vector<std::string> PlotManager::auto_colors = {"blue", "green", "orange", "purple", "cyan", "magenta", "yellow", "red"};
 
@@ -22,20 +235,24 @@ PlotManager::PlotManager(int width, int height) : width(width), height(height) {
 
 void PlotManager::set_title(const std::string& plot_title) {
     title = plot_title;
+    mark_modified(false);
 }
 
 void PlotManager::set_xlabel(const std::string& x_axis_label) {
     x_label = x_axis_label;
+    mark_modified(false);
 }
 
 void PlotManager::set_ylabel(const std::string& y_axis_label) {
     y_label = y_axis_label;
+    mark_modified(false);
 }
 
 void PlotManager::set_labels(const std::string& plot_title, const std::string& x_axis_label, const std::string& y_axis_label) {
     title = plot_title;
     x_label = x_axis_label;
     y_label = y_axis_label;
+    mark_modified(false);
 }
 
 void PlotManager::calculate_bounds() {
@@ -45,16 +262,18 @@ void PlotManager::calculate_bounds() {
     
     // Calculate bounds from regular data series
     for (const auto& series : data_series) {
-        for (const auto& pt : series.points) {
+        const double* xs = series.x.data();
+        const double* ys = series.y.data();
+        for (size_t i = 0; i < series.size(); ++i) {
             if (first) {
-                min_x = max_x = pt.x;
-                min_y = max_y = pt.y;
+                min_x = max_x = xs[i];
+                min_y = max_y = ys[i];
                 first = false;
             } else {
-                min_x = std::min(min_x, pt.x);
-                max_x = std::max(max_x, pt.x);
-                min_y = std::min(min_y, pt.y);
-                max_y = std::max(max_y, pt.y);
+                min_x = std::min(min_x, xs[i]);
+                max_x = std::max(max_x, xs[i]);
+                min_y = std::min(min_y, ys[i]);
+                max_y = std::max(max_y, ys[i]);
             }
         }
     }
@@ -79,7 +298,41 @@ void PlotManager::set_bounds(double min_x, double max_x, double min_y, double ma
     this->max_x = max_x;
     this->min_y = min_y;
     this->max_y = max_y;
+    data_min_x = min_x;
+    data_max_x = max_x;
+    data_min_y = min_y;
+    data_max_y = max_y;
     bounds_set = true;
+    mark_modified(false);
+}
+
+void PlotManager::ensure_bounds() {
+    if (bounds_set) return;
+    
+    PLOTLIB_TRACE_SCOPE("calculate_bounds", "render");
+    calculate_bounds();
+    data_min_x = min_x;
+    data_max_x = max_x;
+    data_min_y = min_y;
+    data_max_y = max_y;
+}
+
+void PlotManager::set_axis_range(bool x_axis, double min_val, double max_val) {
+    double& axis_min = x_axis ? min_x : min_y;
+    double& axis_max = x_axis ? max_x : max_y;
+    if (axis_min == min_val && axis_max == max_val) return;
+    
+    axis_min = min_val;
+    axis_max = max_val;
+    mark_modified(false);
+}
+
+void PlotManager::set_tick_label_visibility(bool x_visible, bool y_visible) {
+    if (show_x_tick_labels == x_visible && show_y_tick_labels == y_visible) return;
+    
+    show_x_tick_labels = x_visible;
+    show_y_tick_labels = y_visible;
+    mark_modified(false);
 }
 
 void PlotManager::transform_point(double data_x, double data_y, double& screen_x, double& screen_y) {
@@ -90,22 +343,61 @@ void PlotManager::transform_point(double data_x, double data_y, double& screen_x
     screen_y = height - margin_bottom - (data_y - min_y) / (max_y - min_y) * plot_height;
 }
 
-std::string PlotManager::format_number(double value, int precision) {
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(precision) << value;
-    std::string str = oss.str();
+const float* PlotManager::screen_coordinates(ScreenCoordinates& cache, const double* xs, const double* ys,
+                                             size_t count, size_t stride) {
+    const double view[ScreenCoordinates::VIEW_FIELDS] = {
+        min_x, max_x, min_y, max_y, static_cast<double>(width), static_cast<double>(height),
+        margin_left, margin_right, margin_top, margin_bottom};
+    
+    size_t first = 0;
+    if (cache.count <= count && std::equal(view, view + ScreenCoordinates::VIEW_FIELDS, cache.view)) {
+        // Same view: only points appended since the last render are new
+        first = cache.count;
+        if (first == count) return cache.xy.data();
+    } else {
+        std::copy(view, view + ScreenCoordinates::VIEW_FIELDS, cache.view);
+    }
     
-    // Remove trailing zeros
-    str.erase(str.find_last_not_of('0') + 1, std::string::npos);
-    str.erase(str.find_last_not_of('.') + 1, std::string::npos);
+    cache.xy.resize(count * 2);
+    const unsigned char* x_bytes = reinterpret_cast<const unsigned char*>(xs);
+    const unsigned char* y_bytes = reinterpret_cast<const unsigned char*>(ys);
+    for (size_t i = first; i < count; ++i) {
+        double screen_x, screen_y;
+        transform_point(*reinterpret_cast<const double*>(x_bytes + i * stride),
+                        *reinterpret_cast<const double*>(y_bytes + i * stride), screen_x, screen_y);
+        cache.xy[2 * i] = static_cast<float>(screen_x);
+        cache.xy[2 * i + 1] = static_cast<float>(screen_y);
+    }
+    cache.count = count;
+    return cache.xy.data();
+}
+
+std::string PlotManager::format_number(double value, int precision) {
+    // Large enough for any double in fixed notation
+    char buffer[512];
+    int length = std::snprintf(buffer, sizeof(buffer), "%.*f", precision, value);
+    if (length < 0) return std::string();
+    length = std::min(length, static_cast<int>(sizeof(buffer)) - 1);
+    
+    // Remove trailing zeros and a trailing decimal point
+    if (std::memchr(buffer, '.', length)) {
+        while (length > 0 && buffer[length - 1] == '0') --length;
+        if (length > 0 && buffer[length - 1] == '.') --length;
+    }
     
-    return str;
+    return std::string(buffer, length);
 }
 
 std::vector<double> PlotManager::generate_nice_ticks(double min_val, double max_val, int target_ticks) {
     std::vector<double> ticks;
+    generate_nice_ticks(min_val, max_val, target_ticks, ticks);
+    return ticks;
+}
+
+void PlotManager::generate_nice_ticks(double min_val, double max_val, int target_ticks, std::vector<double>& ticks) {
+    ticks.clear();
     
-    if (min_val >= max_val) return ticks;
+    if (min_val >= max_val) return;
     
     double range = max_val - min_val;
     double raw_step = range / target_ticks;
@@ -127,8 +419,48 @@ std::vector<double> PlotManager::generate_nice_ticks(double min_val, double max_
     for (double tick = start; tick <= max_val + nice_step * 0.001; tick += nice_step) {
         ticks.push_back(tick);
     }
+}
+
+const PlotManager::TickLayout& PlotManager::get_tick_layout(TickLayout& layout, double min_val, double max_val,
+                                                            int target_ticks) {
+    if (layout.valid && layout.min_val == min_val && layout.max_val == max_val &&
+        layout.target_ticks == target_ticks) {
+        return layout;
+    }
     
-    return ticks;
+    if (!layout.valid) {
+        // Room for any tick count generate_nice_ticks produces, so later ranges reuse the storage
+        layout.ticks.reserve(32);
+        layout.labels.reserve(32);
+    }
+    
+    generate_nice_ticks(min_val, max_val, target_ticks, layout.ticks);
+    layout.labels.resize(layout.ticks.size());
+    for (size_t i = 0; i < layout.ticks.size(); ++i) {
+        layout.labels[i] = format_number(layout.ticks[i]);
+    }
+    
+    layout.min_val = min_val;
+    layout.max_val = max_val;
+    layout.target_ticks = target_ticks;
+    layout.valid = true;
+    return layout;
+}
+
+const std::vector<LegendItem>& PlotManager::get_legend_items() {
+    if (legend_cache_revision != legend_revision) {
+        legend_items_cache.clear();
+        collect_legend_items(legend_items_cache);
+        legend_cache_revision = legend_revision;
+    }
+    return legend_items_cache;
+}
+
+void PlotManager::mark_modified(bool legend_changed) {
+    ++revision;
+    if (legend_changed) {
+        ++legend_revision;
+    }
 }
 
 void PlotManager::draw_axes(cairo_t* cr) {
@@ -149,14 +481,14 @@ void PlotManager::draw_axes(cairo_t* cr) {
 void PlotManager::draw_axis_ticks(cairo_t* cr) {
     cairo_set_source_rgb(cr, 0, 0, 0);
     cairo_set_line_width(cr, 1.0);
-    cairo_select_font_face(cr, "Arial", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+    fonts::select_font_face(cr, CAIRO_FONT_WEIGHT_NORMAL);
     cairo_set_font_size(cr, 10);
     
     // X-axis ticks
-    auto x_ticks = generate_nice_ticks(min_x, max_x, 6);
-    for (double tick : x_ticks) {
+    const TickLayout& x_ticks = get_tick_layout(x_tick_layout, min_x, max_x, TARGET_TICKS);
+    for (size_t i = 0; i < x_ticks.ticks.size(); ++i) {
         double screen_x, screen_y;
-        transform_point(tick, min_y, screen_x, screen_y);
+        transform_point(x_ticks.ticks[i], min_y, screen_x, screen_y);
         
         // Draw tick mark
         cairo_move_to(cr, screen_x, height - margin_bottom);
@@ -164,7 +496,8 @@ void PlotManager::draw_axis_ticks(cairo_t* cr) {
         cairo_stroke(cr);
         
         // Draw tick label
-        std::string label = format_number(tick);
+        if (!show_x_tick_labels) continue;
+        const std::string& label = x_ticks.labels[i];
         cairo_text_extents_t extents;
         cairo_text_extents(cr, label.c_str(), &extents);
         cairo_move_to(cr, screen_x - extents.width/2, height - margin_bottom + 20);
@@ -172,10 +505,10 @@ void PlotManager::draw_axis_ticks(cairo_t* cr) {
     }
     
     // Y-axis ticks
-    auto y_ticks = generate_nice_ticks(min_y, max_y, 6);
-    for (double tick : y_ticks) {
+    const TickLayout& y_ticks = get_tick_layout(y_tick_layout, min_y, max_y, TARGET_TICKS);
+    for (size_t i = 0; i < y_ticks.ticks.size(); ++i) {
         double screen_x, screen_y;
-        transform_point(min_x, tick, screen_x, screen_y);
+        transform_point(min_x, y_ticks.ticks[i], screen_x, screen_y);
         
         // Draw tick mark
         cairo_move_to(cr, margin_left, screen_y);
@@ -183,7 +516,8 @@ void PlotManager::draw_axis_ticks(cairo_t* cr) {
         cairo_stroke(cr);
         
         // Draw tick label
-        std::string label = format_number(tick);
+        if (!show_y_tick_labels) continue;
+        const std::string& label = y_ticks.labels[i];
         cairo_text_extents_t extents;
         cairo_text_extents(cr, label.c_str(), &extents);
         cairo_move_to(cr, margin_left - extents.width - 10, screen_y + extents.height/2);
@@ -196,8 +530,8 @@ void PlotManager::draw_grid(cairo_t* cr) {
     cairo_set_line_width(cr, 0.5);
     
     // Vertical grid lines (based on x-axis ticks)
-    auto x_ticks = generate_nice_ticks(min_x, max_x, 6);
-    for (double tick : x_ticks) {
+    const TickLayout& x_ticks = get_tick_layout(x_tick_layout, min_x, max_x, TARGET_TICKS);
+    for (double tick : x_ticks.ticks) {
         double screen_x, screen_y;
         transform_point(tick, min_y, screen_x, screen_y);
         cairo_move_to(cr, screen_x, margin_top);
@@ -206,8 +540,8 @@ void PlotManager::draw_grid(cairo_t* cr) {
     }
     
     // Horizontal grid lines (based on y-axis ticks)
-    auto y_ticks = generate_nice_ticks(min_y, max_y, 6);
-    for (double tick : y_ticks) {
+    const TickLayout& y_ticks = get_tick_layout(y_tick_layout, min_y, max_y, TARGET_TICKS);
+    for (double tick : y_ticks.ticks) {
         double screen_x, screen_y;
         transform_point(min_x, tick, screen_x, screen_y);
         cairo_move_to(cr, margin_left, screen_y);
@@ -219,49 +553,163 @@ void PlotManager::draw_grid(cairo_t* cr) {
 void PlotManager::draw_reference_lines(cairo_t* cr) {
     if (reference_lines.empty()) return;
     
-    for (const auto& ref_line : reference_lines) {
-        // Set line style and color
-        cairo_set_source_rgba(cr, ref_line.style.r, ref_line.style.g, ref_line.style.b, ref_line.style.alpha);
-        cairo_set_line_width(cr, ref_line.style.line_width);
-        
-        // Set dotted line style
-        double dashes[] = {4.0, 4.0};
-        cairo_set_dash(cr, dashes, 2, 0);
+    // Reference lines only change together with the legend
+    if (reference_order_revision != legend_revision) {
+        reference_line_order.clear();
+        reference_line_groups.clear();
+        std::vector<uint32_t> group_of_line(reference_lines.size());
+        std::vector<const PlotStyle*> group_styles;
+        for (size_t i = 0; i < reference_lines.size(); ++i) {
+            group_of_line[i] = static_cast<uint32_t>(style_group(group_styles, reference_lines[i].style));
+            reference_line_order.push_back(static_cast<uint32_t>(i));
+        }
+        // Groups in order of first use, lines in insertion order within a group
+        std::sort(reference_line_order.begin(), reference_line_order.end(), [&](uint32_t a, uint32_t b) {
+            return group_of_line[a] != group_of_line[b] ? group_of_line[a] < group_of_line[b] : a < b;
+        });
+        for (size_t i = 0; i < reference_line_order.size(); ++i) {
+            if (i == 0 || group_of_line[reference_line_order[i]] != group_of_line[reference_line_order[i - 1]]) {
+                reference_line_groups.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        reference_order_revision = legend_revision;
+    }
+    
+    // Dotted line style, shared by all reference lines
+    double dashes[] = {4.0, 4.0};
+    cairo_set_dash(cr, dashes, 2, 0);
+    
+    // One path and one stroke per style
+    for (size_t group = 0; group < reference_line_groups.size(); ++group) {
+        size_t begin = reference_line_groups[group];
+        size_t end = group + 1 < reference_line_groups.size() ? reference_line_groups[group + 1]
+                                                              : reference_line_order.size();
+        const PlotStyle& style = reference_lines[reference_line_order[begin]].style;
+        cairo_set_source_rgba(cr, style.r, style.g, style.b, style.alpha);
+        cairo_set_line_width(cr, style.line_width);
         
-        if (ref_line.is_vertical) {
-            // Draw vertical reference line
-            double screen_x, screen_y_top, screen_y_bottom;
-            transform_point(ref_line.value, min_y, screen_x, screen_y_bottom);
-            transform_point(ref_line.value, max_y, screen_x, screen_y_top);
+        bool has_path = false;
+        for (size_t i = begin; i < end; ++i) {
+            const ReferenceLine& ref_line = reference_lines[reference_line_order[i]];
+            double screen_x, screen_y;
+            transform_point(ref_line.is_vertical ? ref_line.value : min_x,
+                            ref_line.is_vertical ? min_y : ref_line.value, screen_x, screen_y);
             
-            // Only draw if the line is within the plot area
-            if (screen_x >= margin_left && screen_x <= width - margin_right) {
+            // Only draw lines within the plot area
+            if (ref_line.is_vertical) {
+                if (screen_x < margin_left || screen_x > width - margin_right) continue;
                 cairo_move_to(cr, screen_x, margin_top);
                 cairo_line_to(cr, screen_x, height - margin_bottom);
-                cairo_stroke(cr);
-            }
-        } else {
-            // Draw horizontal reference line
-            double screen_x_left, screen_x_right, screen_y;
-            transform_point(min_x, ref_line.value, screen_x_left, screen_y);
-            transform_point(max_x, ref_line.value, screen_x_right, screen_y);
-            
-            // Only draw if the line is within the plot area
-            if (screen_y >= margin_top && screen_y <= height - margin_bottom) {
+            } else {
+                if (screen_y < margin_top || screen_y > height - margin_bottom) continue;
                 cairo_move_to(cr, margin_left, screen_y);
                 cairo_line_to(cr, width - margin_right, screen_y);
-                cairo_stroke(cr);
             }
+            has_path = true;
         }
+        if (has_path) cairo_stroke(cr);
+    }
+    
+    // Reset dash pattern for later elements
+    cairo_set_dash(cr, nullptr, 0, 0);
+}
+
+void PlotManager::draw_annotations(cairo_t* cr) {
+    drawn_annotation_count = 0;
+    if (annotations.empty()) return;
+    
+    fonts::select_font_face(cr, CAIRO_FONT_WEIGHT_NORMAL);
+    cairo_set_font_size(cr, ANNOTATION_FONT_SIZE);
+    
+    using Box = AnnotationLayout::Box;
+    
+    // Spatial hash over screen cells: each placed label is registered in every
+    // cell it touches, so a new label is only tested against nearby labels.
+    // The buffers keep their capacity, so re-renders do not allocate.
+    size_t bucket_count = 64;
+    while (bucket_count < annotations.size() * 2) bucket_count *= 2;
+    std::vector<int32_t>& buckets = annotation_layout.buckets;
+    std::vector<AnnotationLayout::CellEntry>& cells = annotation_layout.cells;
+    std::vector<Box>& boxes = annotation_layout.boxes;
+    std::vector<std::pair<uint32_t, uint32_t>>& visible = annotation_layout.visible;
+    std::vector<const PlotStyle*>& group_styles = annotation_layout.group_styles;
+    buckets.assign(bucket_count, -1);
+    cells.clear();
+    boxes.clear();
+    visible.clear();
+    group_styles.clear();
+    auto bucket_of = [&](int64_t cell_x, int64_t cell_y) {
+        uint64_t key = static_cast<uint64_t>(cell_x) * 0x9E3779B97F4A7C15ULL ^
+                       static_cast<uint64_t>(cell_y) * 0xC2B2AE3D27D4EB4FULL;
+        return static_cast<size_t>((key ^ (key >> 29)) & (bucket_count - 1));
+    };
+    
+    for (size_t i = 0; i < annotations.size(); ++i) {
+        const Annotation& annotation = annotations[i];
+        double screen_x, screen_y;
+        transform_point(annotation.x, annotation.y, screen_x, screen_y);
+        if (screen_x < margin_left || screen_x > width - margin_right ||
+            screen_y < margin_top || screen_y > height - margin_bottom) {
+            continue;
+        }
+        
+        cairo_text_extents_t extents;
+        cairo_text_extents(cr, annotation.text.c_str(), &extents);
+        double text_x = screen_x + 4;
+        double text_y = screen_y - 4;
+        Box box = {text_x + extents.x_bearing - 1, text_y + extents.y_bearing - 1,
+                   text_x + extents.x_bearing + extents.width + 1, text_y + extents.y_bearing + extents.height + 1};
+        int64_t cell_x0 = static_cast<int64_t>(std::floor(box.x0 / ANNOTATION_CELL_SIZE));
+        int64_t cell_x1 = static_cast<int64_t>(std::floor(box.x1 / ANNOTATION_CELL_SIZE));
+        int64_t cell_y0 = static_cast<int64_t>(std::floor(box.y0 / ANNOTATION_CELL_SIZE));
+        int64_t cell_y1 = static_cast<int64_t>(std::floor(box.y1 / ANNOTATION_CELL_SIZE));
         
-        // Reset dash pattern for next element
-        cairo_set_dash(cr, nullptr, 0, 0);
+        bool overlaps = false;
+        for (int64_t cy = cell_y0; cy <= cell_y1 && !overlaps; ++cy) {
+            for (int64_t cx = cell_x0; cx <= cell_x1 && !overlaps; ++cx) {
+                for (int32_t entry = buckets[bucket_of(cx, cy)]; entry >= 0; entry = cells[entry].next) {
+                    const Box& other = boxes[cells[entry].box];
+                    if (box.x0 < other.x1 && other.x0 < box.x1 && box.y0 < other.y1 && other.y0 < box.y1) {
+                        overlaps = true;
+                        break;
+                    }
+                }
+            }
+        }
+        if (overlaps) continue;
+        
+        uint32_t box_index = static_cast<uint32_t>(boxes.size());
+        boxes.push_back(box);
+        for (int64_t cy = cell_y0; cy <= cell_y1; ++cy) {
+            for (int64_t cx = cell_x0; cx <= cell_x1; ++cx) {
+                size_t bucket = bucket_of(cx, cy);
+                cells.push_back({box_index, buckets[bucket]});
+                buckets[bucket] = static_cast<int32_t>(cells.size() - 1);
+            }
+        }
+        visible.emplace_back(static_cast<uint32_t>(style_group(group_styles, annotation.style)),
+                             static_cast<uint32_t>(i));
     }
+    
+    // Draw the surviving labels grouped by colour, one source change per group
+    std::sort(visible.begin(), visible.end());
+    for (size_t i = 0; i < visible.size(); ++i) {
+        const Annotation& annotation = annotations[visible[i].second];
+        if (i == 0 || visible[i].first != visible[i - 1].first) {
+            cairo_set_source_rgba(cr, annotation.style.r, annotation.style.g, annotation.style.b,
+                                  annotation.style.alpha);
+        }
+        double screen_x, screen_y;
+        transform_point(annotation.x, annotation.y, screen_x, screen_y);
+        cairo_move_to(cr, screen_x + 4, screen_y - 4);
+        cairo_show_text(cr, annotation.text.c_str());
+    }
+    drawn_annotation_count = visible.size();
 }
 
 void PlotManager::draw_axis_labels(cairo_t* cr) {
     cairo_set_source_rgb(cr, 0, 0, 0);
-    cairo_select_font_face(cr, "Arial", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+    fonts::select_font_face(cr, CAIRO_FONT_WEIGHT_BOLD);
     cairo_set_font_size(cr, 12);
     
     // X-axis label
@@ -291,7 +739,7 @@ void PlotManager::draw_title(cairo_t* cr) {
     if (title.empty()) return;
     
     cairo_set_source_rgb(cr, 0, 0, 0);
-    cairo_select_font_face(cr, "Arial", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+    fonts::select_font_face(cr, CAIRO_FONT_WEIGHT_BOLD);
     cairo_set_font_size(cr, 16);
     
     cairo_text_extents_t extents;
@@ -305,6 +753,11 @@ void PlotManager::draw_marker(cairo_t* cr, double x, double y, MarkerType type,
                              double r, double g, double b, double alpha) {
     cairo_set_source_rgba(cr, r, g, b, alpha);
     
+    // Small circles are indistinguishable from squares in previews and much cheaper to fill
+    if (type == MarkerType::CIRCLE && render_quality == RenderQuality::DRAFT && size <= DRAFT_SQUARE_MARKER_SIZE) {
+        type = MarkerType::SQUARE;
+    }
+    
     switch (type) {
         case MarkerType::CIRCLE:
             cairo_arc(cr, x, y, size, 0, 2 * M_PI);
@@ -335,18 +788,73 @@ void PlotManager::draw_marker(cairo_t* cr, double x, double y, MarkerType type,
     }
 }
 
+void PlotManager::draw_marker_run(cairo_t* cr, const float* screen, size_t begin, size_t end, size_t stride,
+                                  MarkerType type, double size, double r, double g, double b, double alpha,
+                                  double min_spacing) {
+    // Translucent markers darken with every overlap, so only opaque ones are deduplicated
+    bool deduplicate = alpha >= 1.0;
+    MarkerOccupancy& occupancy = marker_occupancy;
+    uint32_t columns = static_cast<uint32_t>(std::max(width, 0)) * MARKER_SUBPIXELS;
+    uint32_t rows = static_cast<uint32_t>(std::max(height, 0)) * MARKER_SUBPIXELS;
+    if (deduplicate && (occupancy.columns != columns || occupancy.rows != rows)) {
+        // Sized once per canvas size; later passes reuse both buffers without allocating
+        size_t words = (static_cast<size_t>(columns) * rows + 63) / 64;
+        occupancy.bits.assign(words, 0);
+        occupancy.touched.clear();
+        occupancy.touched.reserve(words);
+        occupancy.columns = columns;
+        occupancy.rows = rows;
+    }
+    
+    float canvas_width = static_cast<float>(width);
+    float canvas_height = static_cast<float>(height);
+    double spacing_squared = min_spacing * min_spacing;
+    bool has_last = false;
+    float last_x = 0, last_y = 0;
+    for (size_t i = begin; i < end; i += stride) {
+        float x = screen[2 * i];
+        float y = screen[2 * i + 1];
+        if (has_last) {
+            double dx = x - last_x, dy = y - last_y;
+            if (dx * dx + dy * dy < spacing_squared) {
+                ++skipped_marker_count;
+                continue;
+            }
+        }
+        // Markers centred off the canvas (or at NaN) are drawn without a cell
+        if (deduplicate && x >= 0 && y >= 0 && x < canvas_width && y < canvas_height) {
+            size_t cell = static_cast<size_t>(y * MARKER_SUBPIXELS) * columns +
+                          static_cast<size_t>(x * MARKER_SUBPIXELS);
+            uint64_t& word = occupancy.bits[cell >> 6];
+            uint64_t mask = uint64_t(1) << (cell & 63);
+            if (word & mask) {
+                ++skipped_marker_count;
+                continue;
+            }
+            if (word == 0) occupancy.touched.push_back(static_cast<uint32_t>(cell >> 6));
+            word |= mask;
+        }
+        draw_marker(cr, x, y, type, size, r, g, b, alpha);
+        last_x = x;
+        last_y = y;
+        has_last = min_spacing > 0.0;
+    }
+    
+    for (uint32_t index : occupancy.touched) occupancy.bits[index] = 0;
+    occupancy.touched.clear();
+}
+
 void PlotManager::draw_legend(cairo_t* cr) {
     if (!show_legend) return;
     
-    // Collect all legend items from derived classes
-    std::vector<LegendItem> legend_items;
-    collect_legend_items(legend_items);
+    // Legend items from derived classes (re-collected only after changes)
+    const std::vector<LegendItem>& legend_items = get_legend_items();
     
     if (legend_items.empty()) return;
     
     // Set up font and colors
     cairo_set_source_rgb(cr, 0, 0, 0);
-    cairo_select_font_face(cr, "Arial", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+    fonts::select_font_face(cr, CAIRO_FONT_WEIGHT_NORMAL);
     cairo_set_font_size(cr, 10);
     
     double legend_x = width - margin_right + 10;
@@ -431,9 +939,15 @@ void PlotManager::collect_legend_items(std::vector<LegendItem>& items) {
         }
     }
     
-    // Add reference lines
+    collect_reference_legend_items(items);
+}
+
+void PlotManager::collect_reference_legend_items(std::vector<LegendItem>& items) const {
+    // Lines sharing a label (e.g. many event markers) get a single entry
+    std::set<std::string> seen_labels;
     for (const auto& ref_line : reference_lines) {
-        if (!ref_line.label.empty() && hidden_legend_items.find(ref_line.label) == hidden_legend_items.end()) {
+        if (!ref_line.label.empty() && hidden_legend_items.find(ref_line.label) == hidden_legend_items.end() &&
+            seen_labels.insert(ref_line.label).second) {
             items.emplace_back(ref_line.label, ref_line.style, LegendSymbolType::LINE);
         }
     }
@@ -448,57 +962,112 @@ void PlotManager::set_subplot_transform(double x_offset, double y_offset, double
 }
 
 void PlotManager::render_to_context(cairo_t* cr) {
-    if (!bounds_set) {
-        calculate_bounds();
-    }
+    PLOTLIB_TRACE_SCOPE("render_plot", "render");
+    
+    ensure_bounds();
+    skipped_marker_count = 0;
+    
+    // Keep the caller's transformation and quality settings intact
+    cairo_save(cr);
+    apply_render_quality(cr, render_quality);
     
     if (is_subplot) {
-        // Save the current transformation matrix
-        cairo_save(cr);
-        
         // Apply subplot transformation: translate first, then scale
         cairo_translate(cr, subplot_x_offset, subplot_y_offset);
         cairo_scale(cr, subplot_width_scale, subplot_height_scale);
-        
-        // Draw all plot elements within the transformed coordinate system
-        draw_grid(cr);
-        draw_axes(cr);
-        draw_axis_ticks(cr);
-        draw_axis_labels(cr);
-        draw_title(cr);
-        
-        // Check if plot is empty and draw appropriate content
-        if (is_plot_empty()) {
-            draw_empty_plot_text(cr);
-        } else {
-            draw_data(cr);  // This will be implemented by derived classes
-            draw_reference_lines(cr);  // Draw reference lines over data
-            draw_legend(cr);
+    }
+    
+    // Draw all plot elements (within the subplot's coordinate system if any)
+    bool below_data = render_layer != RenderLayer::ABOVE_DATA;
+    bool above_data = render_layer != RenderLayer::BELOW_DATA;
+    if (below_data) {
+        {
+            PLOTLIB_TRACE_SCOPE("draw_grid", "render");
+            draw_grid(cr);
         }
-        
-        // Restore the transformation matrix
-        cairo_restore(cr);
+        {
+            PLOTLIB_TRACE_SCOPE("draw_axes", "render");
+            draw_axes(cr);
+            draw_axis_ticks(cr);
+            draw_axis_labels(cr);
+        }
+        {
+            PLOTLIB_TRACE_SCOPE("draw_title", "render");
+            draw_title(cr);
+        }
+    }
+    
+    // Check if plot is empty and draw appropriate content
+    if (is_plot_empty()) {
+        if (below_data) draw_empty_plot_text(cr);
     } else {
-        // Regular single plot rendering
-        draw_grid(cr);
-        draw_axes(cr);
-        draw_axis_ticks(cr);
-        draw_axis_labels(cr);
-        draw_title(cr);
-        
-        // Check if plot is empty and draw appropriate content
-        if (is_plot_empty()) {
-            draw_empty_plot_text(cr);
-        } else {
+        if (render_layer == RenderLayer::ALL) {
+            PLOTLIB_TRACE_SCOPE("draw_data", "render");
             draw_data(cr);  // This will be implemented by derived classes
-            draw_reference_lines(cr);  // Draw reference lines over data
-            draw_legend(cr);
+        }
+        if (above_data) {
+            {
+                PLOTLIB_TRACE_SCOPE("draw_reference_lines", "render");
+                draw_reference_lines(cr);  // Draw reference lines over data
+            }
+            {
+                PLOTLIB_TRACE_SCOPE("draw_annotations", "render");
+                draw_annotations(cr);
+            }
+            {
+                PLOTLIB_TRACE_SCOPE("draw_legend", "render");
+                draw_legend(cr);
+            }
         }
     }
+    
+    cairo_restore(cr);
 }
 
-bool PlotManager::save_png(const std::string& filename) {
-    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+void PlotManager::apply_render_quality(cairo_t* cr, RenderQuality quality) {
+    if (quality != RenderQuality::DRAFT) return;
+    
+    // Aliased geometry and coarser curve flattening
+    cairo_set_antialias(cr, CAIRO_ANTIALIAS_NONE);
+    cairo_set_tolerance(cr, 0.5);
+    
+    // Unhinted, grayscale text
+    cairo_font_options_t* options = cairo_font_options_create();
+    cairo_font_options_set_antialias(options, CAIRO_ANTIALIAS_FAST);
+    cairo_font_options_set_hint_style(options, CAIRO_HINT_STYLE_NONE);
+    cairo_font_options_set_hint_metrics(options, CAIRO_HINT_METRICS_OFF);
+    cairo_set_font_options(cr, options);
+    cairo_font_options_destroy(options);
+}
+
+size_t PlotManager::series_stride(size_t point_count) const {
+    size_t stride = 1;
+    if (render_quality == RenderQuality::DRAFT && point_count > DRAFT_MAX_POINTS) {
+        stride = (point_count + DRAFT_MAX_POINTS - 1) / DRAFT_MAX_POINTS;
+    }
+    if (progressive_stride > 1) {
+        // Keep at least PROGRESSIVE_MIN_POINTS points so small series are complete early
+        size_t progressive = std::min(progressive_stride, std::max<size_t>(1, point_count / PROGRESSIVE_MIN_POINTS));
+        stride = std::max(stride, progressive);
+    }
+    return stride;
+}
+
+size_t PlotManager::sampled_point_count() const {
+    size_t largest = 0;
+    for (const auto& series : data_series) {
+        largest = std::max(largest, series.size());
+    }
+    return largest;
+}
+
+void PlotManager::set_render_quality(RenderQuality quality) {
+    render_quality = quality;
+    mark_modified(false);
+}
+
+cairo_surface_t* PlotManager::render_image_surface() {
+    cairo_surface_t* surface = SurfacePool::instance().acquire(width, height);
     cairo_t* cr = cairo_create(surface);
     
     // White background
@@ -507,15 +1076,38 @@ bool PlotManager::save_png(const std::string& filename) {
     
     render_to_context(cr);
     
-    cairo_status_t status = cairo_surface_write_to_png(surface, filename.c_str());
-    
     cairo_destroy(cr);
-    cairo_surface_destroy(surface);
+    return surface;
+}
+
+bool PlotManager::save_png(const std::string& filename) {
+    PLOTLIB_TRACE_SCOPE("save_png", "export");
+    if (render_cache) {
+        // Go through the buffer so the encoded bytes can be cached and reused
+        std::vector<unsigned char> png_data;
+        return save_png_to_buffer(png_data) && write_output_file(filename, png_data.data(), png_data.size(), "PNG");
+    }
+    
+    cairo_surface_t* surface = render_image_surface();
+    
+    cairo_status_t status;
+    {
+        PLOTLIB_TRACE_SCOPE("encode_write_png", "io");
+        status = cairo_surface_write_to_png(surface, filename.c_str());
+    }
+    
+    SurfacePool::instance().release(surface);
     
     return status == CAIRO_STATUS_SUCCESS;
 }
 
 bool PlotManager::save_svg(const std::string& filename) {
+    PLOTLIB_TRACE_SCOPE("save_svg", "export");
+    if (render_cache) {
+        std::string svg_data;
+        return save_svg_to_buffer(svg_data) && write_output_file(filename, svg_data.data(), svg_data.size(), "SVG");
+    }
+    
     cairo_surface_t* surface = cairo_svg_surface_create(filename.c_str(), width, height);
     cairo_t* cr = cairo_create(surface);
     
@@ -531,15 +1123,194 @@ bool PlotManager::save_svg(const std::string& filename) {
     return true;
 }
 
+bool PlotManager::render_to_buffer(std::vector<unsigned char>& pixels) {
+    PLOTLIB_TRACE_SCOPE("render_to_buffer", "export");
+    RenderKey key;
+    bool cacheable = render_cache && render_cache_key(RenderFormat::PIXELS, key);
+    if (cacheable && render_cache->lookup(key, pixels)) return true;
+    
+    cairo_surface_t* surface = render_image_surface();
+    bool success = copy_surface_pixels(surface, pixels);
+    SurfacePool::instance().release(surface);
+    
+    if (cacheable && success) render_cache->store(key, pixels);
+    return success;
+}
+
+bool PlotManager::render_progressive(std::vector<unsigned char>& pixels, const ProgressCallback& callback) {
+    PLOTLIB_TRACE_SCOPE("render_progressive", "export");
+    size_t strides[4];
+    int pass_count = choose_progressive_strides(sampled_point_count(), PROGRESSIVE_MIN_POINTS, strides);
+    
+    for (int pass = 0; pass < pass_count; ++pass) {
+        PLOTLIB_TRACE_SCOPE("progressive_pass", "render");
+        progressive_stride = strides[pass];
+        cairo_surface_t* surface = render_image_surface();
+        progressive_stride = 1;
+        
+        bool success = copy_surface_pixels(surface, pixels);
+        SurfacePool::instance().release(surface);
+        if (!success) return false;
+        
+        bool last_pass = pass + 1 == pass_count;
+        if (callback && !callback(pass + 1, pass_count) && !last_pass) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PlotManager::save_png_to_buffer(std::vector<unsigned char>& png_data) {
+    PLOTLIB_TRACE_SCOPE("save_png_to_buffer", "export");
+    RenderKey key;
+    bool cacheable = render_cache && render_cache_key(RenderFormat::PNG, key);
+    if (cacheable && render_cache->lookup(key, png_data)) return true;
+    
+    cairo_surface_t* surface = render_image_surface();
+    
+    png_data.clear();
+    cairo_status_t status;
+    {
+        PLOTLIB_TRACE_SCOPE("encode_png", "encode");
+        status = cairo_surface_write_to_png_stream(surface, append_to_vector, &png_data);
+    }
+    
+    SurfacePool::instance().release(surface);
+    
+    bool success = status == CAIRO_STATUS_SUCCESS;
+    if (cacheable && success) render_cache->store(key, png_data);
+    return success;
+}
+
+bool PlotManager::save_svg_to_buffer(std::string& svg_data) {
+    PLOTLIB_TRACE_SCOPE("save_svg_to_buffer", "export");
+    RenderKey key;
+    bool cacheable = render_cache && render_cache_key(RenderFormat::SVG, key);
+    std::vector<unsigned char> cached;
+    if (cacheable && render_cache->lookup(key, cached)) {
+        svg_data.assign(cached.begin(), cached.end());
+        return true;
+    }
+    
+    svg_data.clear();
+    cairo_surface_t* surface = cairo_svg_surface_create_for_stream(append_to_string, &svg_data, width, height);
+    cairo_t* cr = cairo_create(surface);
+    
+    // White background
+    cairo_set_source_rgb(cr, 1, 1, 1);
+    cairo_paint(cr);
+    
+    render_to_context(cr);
+    
+    cairo_destroy(cr);
+    cairo_surface_finish(surface);
+    cairo_status_t status = cairo_surface_status(surface);
+    cairo_surface_destroy(surface);
+    
+    bool success = status == CAIRO_STATUS_SUCCESS;
+    if (cacheable && success) render_cache->store(key, std::vector<unsigned char>(svg_data.begin(), svg_data.end()));
+    return success;
+}
+
+bool PlotManager::collect_html_series(std::vector<HtmlSeries>& /*series*/) {
+    return false;
+}
+
+bool PlotManager::render_layer_png(RenderLayer layer, bool opaque, std::vector<unsigned char>& png_data) {
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    cairo_t* cr = cairo_create(surface);
+    
+    if (opaque) {
+        cairo_set_source_rgb(cr, 1, 1, 1);
+        cairo_paint(cr);
+    }
+    
+    render_layer = layer;
+    render_to_context(cr);
+    render_layer = RenderLayer::ALL;
+    cairo_destroy(cr);
+    
+    png_data.clear();
+    cairo_status_t status = cairo_surface_write_to_png_stream(surface, append_to_vector, &png_data);
+    cairo_surface_destroy(surface);
+    return status == CAIRO_STATUS_SUCCESS;
+}
+
+bool PlotManager::save_html_to_buffer(std::string& html_data) {
+    PLOTLIB_TRACE_SCOPE("save_html_to_buffer", "export");
+    html_data.clear();
+    ensure_bounds();
+    
+    std::vector<HtmlSeries> series;
+    bool client_data = collect_html_series(series);
+    
+    // Static layers: everything under the data on white, everything over it on transparent
+    std::vector<unsigned char> below_png, above_png;
+    if (!render_layer_png(client_data ? RenderLayer::BELOW_DATA : RenderLayer::ALL, true, below_png)) return false;
+    if (client_data && !render_layer_png(RenderLayer::ABOVE_DATA, false, above_png)) return false;
+    
+    PLOTLIB_TRACE_SCOPE("encode_html", "encode");
+    std::ostringstream html;
+    html << std::setprecision(12);
+    html << "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n"
+         << "<title>" << escape_html(title.empty() ? "PlotLib" : title) << "</title>\n</head>\n"
+         << "<body style=\"margin:0\">\n"
+         << "<div style=\"position:relative;width:" << width << "px;height:" << height << "px\">\n";
+    const std::string layer_style = "\" style=\"position:absolute;left:0;top:0;width:" + std::to_string(width) +
+                                    "px;height:" + std::to_string(height) + "px\"";
+    html << "<img alt=\"\" src=\"data:image/png;base64," << base64_encode(below_png.data(), below_png.size()) << layer_style << ">\n";
+    if (client_data) {
+        html << "<canvas id=\"plotlib-data" << layer_style << "></canvas>\n";
+        html << "<img alt=\"\" src=\"data:image/png;base64," << base64_encode(above_png.data(), above_png.size()) << layer_style << ">\n";
+    }
+    html << "</div>\n";
+    
+    if (client_data) {
+        double plot_width = width - margin_left - margin_right;
+        double plot_height = height - margin_top - margin_bottom;
+        html << "<script>\n(function () {\nvar plot = {width:" << width << ",height:" << height
+             << ",left:" << margin_left << ",bottom:" << height - margin_bottom
+             << ",plotWidth:" << plot_width << ",plotHeight:" << plot_height
+             << ",minX:" << min_x << ",maxX:" << max_x << ",minY:" << min_y << ",maxY:" << max_y << ",series:[\n";
+        for (size_t i = 0; i < series.size(); ++i) {
+            const HtmlSeries& entry = series[i];
+            const PlotStyle& style = entry.style;
+            html << (i > 0 ? ",\n" : "") << "{line:" << (entry.line ? "true" : "false")
+                 << ",marker:'" << html_marker_name(entry.marker) << "'"
+                 << ",size:" << style.point_size << ",width:" << style.line_width << ",alpha:" << style.alpha
+                 << ",color:'rgba(" << std::lround(style.r * 255) << "," << std::lround(style.g * 255) << ","
+                 << std::lround(style.b * 255) << "," << style.alpha << ")',dashes:[";
+            for (size_t d = 0; d < entry.dashes.size(); ++d) {
+                html << (d > 0 ? "," : "") << entry.dashes[d];
+            }
+            html << "],x:'" << base64_floats(entry.x) << "',y:'" << base64_floats(entry.y) << "'}";
+        }
+        html << "]};\n" << HTML_DRAW_SCRIPT << "})();\n</script>\n";
+    }
+    html << "</body>\n</html>\n";
+    
+    html_data = html.str();
+    return true;
+}
+
+bool PlotManager::save_html(const std::string& filename) {
+    PLOTLIB_TRACE_SCOPE("save_html", "export");
+    std::string html_data;
+    if (!save_html_to_buffer(html_data)) return false;
+    return write_output_file(filename, html_data.data(), html_data.size(), "HTML");
+}
+
 void PlotManager::clear() {
     data_series.clear();
     reference_lines.clear();
+    annotations.clear();
     title = "";
     x_label = "";
     y_label = "";
     bounds_set = false;
     hidden_legend_items.clear();
     show_legend = true;
+    mark_modified();
 }
 
 bool PlotManager::is_plot_empty() const {
@@ -552,7 +1323,7 @@ bool PlotManager::is_plot_empty() const {
     
     // Check if all data series have empty points
     for (const auto& series : data_series) {
-        if (!series.points.empty()) {
+        if (series.size() > 0) {
             return false;  // Found non-empty series
         }
     }
@@ -563,7 +1334,7 @@ bool PlotManager::is_plot_empty() const {
 void PlotManager::draw_empty_plot_text(cairo_t* cr) {
     // Set text properties
     cairo_set_source_rgb(cr, 0.6, 0.6, 0.6);  // Gray color
-    cairo_select_font_face(cr, "Arial", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+    fonts::select_font_face(cr, CAIRO_FONT_WEIGHT_NORMAL);
     cairo_set_font_size(cr, 24);
     
     // Calculate center position of the plot area (excluding margins)
@@ -587,18 +1358,22 @@ void PlotManager::draw_empty_plot_text(cairo_t* cr) {
 // Legend management methods
 void PlotManager::set_legend_enabled(bool enabled) {
     show_legend = enabled;
+    mark_modified();
 }
 
 void PlotManager::hide_legend_item(const std::string& item_name) {
     hidden_legend_items.insert(item_name);
+    mark_modified();
 }
 
 void PlotManager::show_legend_item(const std::string& item_name) {
     hidden_legend_items.erase(item_name);
+    mark_modified();
 }
 
 void PlotManager::show_all_legend_items() {
     hidden_legend_items.clear();
+    mark_modified();
 }
 
 // Reference line management methods
@@ -650,10 +1425,60 @@ void PlotManager::add_horizontal_line(double y_value) {
 void PlotManager::add_reference_line(bool is_vertical, double value, const std::string& label, const PlotStyle& style) {
     ReferenceLine ref_line(is_vertical, value, label, style);
     reference_lines.push_back(ref_line);
+    mark_modified();
 }
 
 void PlotManager::clear_reference_lines() {
     reference_lines.clear();
+    mark_modified();
+}
+
+void PlotManager::add_annotation(double x, double y, const std::string& text, const std::string& color_name) {
+    annotations.emplace_back(x, y, text, color_to_style(color_name));
+    mark_modified(false);
+}
+
+void PlotManager::clear_annotations() {
+    annotations.clear();
+    mark_modified(false);
+}
+
+bool PlotManager::append_to_series(size_t series_index, const std::vector<double>& x_values,
+                                   const std::vector<double>& y_values) {
+    if (series_index >= data_series.size()) {
+        std::cerr << "Error: Series index " << series_index << " out of range" << std::endl;
+        return false;
+    }
+    if (x_values.size() != y_values.size()) {
+        std::cerr << "Error: X and Y vectors must have the same size" << std::endl;
+        return false;
+    }
+    
+    // Columns shared with other series or plots are copied first, so only this series grows
+    DataSeries& series = data_series[series_index];
+    series.x.append(x_values.data(), x_values.size());
+    series.y.append(y_values.data(), y_values.size());
+    // Grow the screen coordinate cache with the data, so the next render does not allocate
+    if (series.screen.xy.capacity() > 0) series.screen.xy.reserve(2 * series.x.vector().capacity());
+    
+    bounds_set = false;
+    mark_modified(false);
+    return true;
+}
+
+bool PlotManager::set_series_alpha(size_t series_index, double alpha) {
+    if (series_index >= data_series.size()) {
+        std::cerr << "Error: Series index " << series_index << " out of range" << std::endl;
+        return false;
+    }
+    if (!(alpha >= 0.0 && alpha <= 1.0)) {
+        std::cerr << "Error: Alpha must be between 0 and 1" << std::endl;
+        return false;
+    }
+    
+    data_series[series_index].style.alpha = alpha;
+    mark_modified();
+    return true;
 }
 
 PlotStyle PlotManager::color_to_style(const std::string& color_name, double point_size, double line_width) {
@@ -712,21 +1537,124 @@ SubplotManager::SubplotManager(int rows, int cols, int width, int height, double
     for (int i = 0; i < rows; ++i) {
         subplots[i].resize(cols);
     }
+    tiles.resize(static_cast<size_t>(rows) * cols);
 }
 
 ScatterPlot& SubplotManager::get_subplot(int row, int col) {
     return get_subplot<ScatterPlot>(row, col);
 }
 
+void SubplotManager::invalidate_tile(int row, int col) {
+    SubplotTile& tile = tiles[static_cast<size_t>(row) * cols + col];
+    tile.surface.reset();
+    tile.plot = nullptr;
+}
+
+void SubplotManager::clear_tile_cache() {
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            invalidate_tile(i, j);
+        }
+    }
+}
+
 void SubplotManager::set_main_title(const std::string& title) {
     main_title = title;
 }
 
+void SubplotManager::set_render_quality(RenderQuality quality) {
+    render_quality = quality;
+    for (auto& row : subplots) {
+        for (auto& subplot : row) {
+            if (subplot) subplot->set_render_quality(quality);
+        }
+    }
+}
+
+void SubplotManager::set_sharex(bool shared) {
+    share_x = shared;
+}
+
+void SubplotManager::set_sharey(bool shared) {
+    share_y = shared;
+}
+
+void SubplotManager::apply_shared_axes() {
+    PLOTLIB_TRACE_SCOPE("apply_shared_axes", "render");
+    
+    // Own bounds first; a shared range is the union of the non-empty subplots' ranges
+    for (auto& row : subplots) {
+        for (auto& subplot : row) {
+            if (subplot) subplot->ensure_bounds();
+        }
+    }
+    
+    apply_shared_axis(true);
+    apply_shared_axis(false);
+}
+
+void SubplotManager::apply_shared_axis(bool x_axis) {
+    bool shared = x_axis ? share_x : share_y;
+    
+    // x is shared down each column, y along each row
+    int group_count = x_axis ? cols : rows;
+    int member_count = x_axis ? rows : cols;
+    
+    for (int group = 0; group < group_count; ++group) {
+        auto plot_at = [&](int member) {
+            return x_axis ? subplots[member][group].get() : subplots[group][member].get();
+        };
+        
+        bool found = false;
+        double shared_min = 0, shared_max = 0;
+        int labelled_member = -1;  // Bottom subplot for x, leftmost for y
+        for (int member = 0; member < member_count; ++member) {
+            PlotManager* plot = plot_at(member);
+            if (!plot) continue;
+            if (x_axis || labelled_member < 0) labelled_member = member;
+            if (!shared || !plot->bounds_set || plot->is_plot_empty()) continue;
+            
+            double own_min = x_axis ? plot->data_min_x : plot->data_min_y;
+            double own_max = x_axis ? plot->data_max_x : plot->data_max_y;
+            shared_min = found ? std::min(shared_min, own_min) : own_min;
+            shared_max = found ? std::max(shared_max, own_max) : own_max;
+            found = true;
+        }
+        
+        const PlotManager::TickLayout* shared_layout = nullptr;
+        for (int member = 0; member < member_count; ++member) {
+            PlotManager* plot = plot_at(member);
+            if (!plot) continue;
+            
+            PlotManager::TickLayout& layout = x_axis ? plot->x_tick_layout : plot->y_tick_layout;
+            if (found) {
+                plot->set_axis_range(x_axis, shared_min, shared_max);
+                
+                // Ticks are computed by the first subplot and copied to the others
+                if (!shared_layout) {
+                    shared_layout = &plot->get_tick_layout(layout, shared_min, shared_max, PlotManager::TARGET_TICKS);
+                } else if (!layout.valid || layout.min_val != shared_min || layout.max_val != shared_max ||
+                           layout.target_ticks != PlotManager::TARGET_TICKS) {
+                    layout = *shared_layout;
+                }
+            } else if (plot->bounds_set) {
+                // Not shared (any more): back to the subplot's own range
+                plot->set_axis_range(x_axis, x_axis ? plot->data_min_x : plot->data_min_y,
+                                     x_axis ? plot->data_max_x : plot->data_max_y);
+            }
+            
+            bool labels_visible = !shared || member == labelled_member;
+            plot->set_tick_label_visibility(x_axis ? labels_visible : plot->show_x_tick_labels,
+                                            x_axis ? plot->show_y_tick_labels : labels_visible);
+        }
+    }
+}
+
 double SubplotManager::get_title_height(cairo_t* cr) {
     if (main_title.empty()) return 0.0;
     
     cairo_save(cr);
-    cairo_select_font_face(cr, "Arial", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+    fonts::select_font_face(cr, CAIRO_FONT_WEIGHT_BOLD);
     cairo_set_font_size(cr, 20);
     
     cairo_text_extents_t extents;
@@ -737,6 +1665,11 @@ double SubplotManager::get_title_height(cairo_t* cr) {
 }
 
 void SubplotManager::render_to_context(cairo_t* cr) {
+    PLOTLIB_TRACE_SCOPE("render_subplots", "render");
+    
+    cairo_save(cr);
+    PlotManager::apply_render_quality(cr, render_quality);
+    
     // White background
     cairo_set_source_rgb(cr, 1, 1, 1);
     cairo_paint(cr);
@@ -787,6 +1720,9 @@ void SubplotManager::render_to_context(cairo_t* cr) {
         grid_start_y += actual_title_height + vertical_spacing * 0.5;
     }
     
+    // Shared axis ranges and tick layouts
+    apply_shared_axes();
+    
     // Update subplot positions
     for (int i = 0; i < rows; ++i) {
         for (int j = 0; j < cols; ++j) {
@@ -817,7 +1753,7 @@ void SubplotManager::render_to_context(cairo_t* cr) {
     // Draw main title with calculated position
     if (!main_title.empty()) {
         cairo_set_source_rgb(cr, 0, 0, 0);
-        cairo_select_font_face(cr, "Arial", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+        fonts::select_font_face(cr, CAIRO_FONT_WEIGHT_BOLD);
         cairo_set_font_size(cr, 20);
         
         cairo_text_extents_t extents;
@@ -828,31 +1764,129 @@ void SubplotManager::render_to_context(cairo_t* cr) {
         cairo_show_text(cr, main_title.c_str());
     }
     
+    // Panels apply their own quality profile on top of the caller's settings
+    cairo_restore(cr);
+    cairo_save(cr);
+    
+    // Tiles are only pixel-exact on image targets at an integer device offset
+    cairo_matrix_t matrix;
+    cairo_get_matrix(cr, &matrix);
+    bool use_tiles = cairo_surface_get_type(cairo_get_target(cr)) == CAIRO_SURFACE_TYPE_IMAGE &&
+                     matrix.xx == 1.0 && matrix.yy == 1.0 && matrix.xy == 0.0 && matrix.yx == 0.0 &&
+                     matrix.x0 == std::floor(matrix.x0) && matrix.y0 == std::floor(matrix.y0);
+    
     // Render each subplot
     for (int i = 0; i < rows; ++i) {
         for (int j = 0; j < cols; ++j) {
             if (subplots[i][j]) {
-                subplots[i][j]->render_to_context(cr);
+                render_subplot(cr, i, j, use_tiles);
+            } else {
+                invalidate_tile(i, j);
             }
         }
     }
+    
+    cairo_restore(cr);
 }
 
-bool SubplotManager::save_png(const std::string& filename) {
-    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, total_width, total_height);
+void SubplotManager::render_subplot(cairo_t* cr, int row, int col, bool use_tile) {
+    trace::Scope subplot_scope("render_subplot", "render");
+    subplot_scope.arg("row", row);
+    subplot_scope.arg("col", col);
+    
+    PlotManager& plot = *subplots[row][col];
+    
+    // Progressive passes draw sampled data that must not end up in the cache
+    if (!use_tile || plot.progressive_stride != 1) {
+        plot.render_to_context(cr);
+        return;
+    }
+    
+    SubplotTile& tile = tiles[static_cast<size_t>(row) * cols + col];
+    uint64_t font_generation = fonts::generation();
+    bool placement_changed = tile.x_offset != plot.subplot_x_offset || tile.y_offset != plot.subplot_y_offset ||
+                             tile.scale != plot.subplot_width_scale;
+    bool current = tile.surface && tile.plot == &plot && tile.revision == plot.revision &&
+                   tile.quality == plot.render_quality && tile.font_generation == font_generation &&
+                   !placement_changed;
+    subplot_scope.arg("cached", current ? 1 : 0);
+    
+    if (!current) {
+        // Whole device pixels covering the subplot's canvas
+        int origin_x = static_cast<int>(std::floor(plot.subplot_x_offset));
+        int origin_y = static_cast<int>(std::floor(plot.subplot_y_offset));
+        int tile_width = static_cast<int>(std::ceil(plot.subplot_x_offset + plot.width * plot.subplot_width_scale)) - origin_x;
+        int tile_height = static_cast<int>(std::ceil(plot.subplot_y_offset + plot.height * plot.subplot_height_scale)) - origin_y;
+        
+        if (!tile.surface || placement_changed ||
+            cairo_image_surface_get_width(tile.surface.get()) != tile_width ||
+            cairo_image_surface_get_height(tile.surface.get()) != tile_height) {
+            tile.surface.reset(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, tile_width, tile_height));
+        }
+        
+        cairo_t* tile_cr = cairo_create(tile.surface.get());
+        cairo_set_operator(tile_cr, CAIRO_OPERATOR_CLEAR);
+        cairo_paint(tile_cr);
+        cairo_set_operator(tile_cr, CAIRO_OPERATOR_OVER);
+        cairo_translate(tile_cr, -origin_x, -origin_y);
+        plot.render_to_context(tile_cr);
+        cairo_destroy(tile_cr);
+        
+        tile.plot = &plot;
+        tile.revision = plot.revision;
+        tile.quality = plot.render_quality;
+        tile.font_generation = font_generation;
+        tile.x_offset = plot.subplot_x_offset;
+        tile.y_offset = plot.subplot_y_offset;
+        tile.scale = plot.subplot_width_scale;
+        tile.origin_x = origin_x;
+        tile.origin_y = origin_y;
+    }
+    
+    cairo_save(cr);
+    cairo_set_source_surface(cr, tile.surface.get(), tile.origin_x, tile.origin_y);
+    cairo_paint(cr);
+    cairo_restore(cr);
+}
+
+cairo_surface_t* SubplotManager::render_image_surface() {
+    cairo_surface_t* surface = SurfacePool::instance().acquire(total_width, total_height);
     cairo_t* cr = cairo_create(surface);
     
     render_to_context(cr);
     
-    cairo_status_t status = cairo_surface_write_to_png(surface, filename.c_str());
-    
     cairo_destroy(cr);
-    cairo_surface_destroy(surface);
+    return surface;
+}
+
+bool SubplotManager::save_png(const std::string& filename) {
+    PLOTLIB_TRACE_SCOPE("save_png", "export");
+    if (render_cache) {
+        // Go through the buffer so the encoded bytes can be cached and reused
+        std::vector<unsigned char> png_data;
+        return save_png_to_buffer(png_data) && write_output_file(filename, png_data.data(), png_data.size(), "PNG");
+    }
+    
+    cairo_surface_t* surface = render_image_surface();
+    
+    cairo_status_t status;
+    {
+        PLOTLIB_TRACE_SCOPE("encode_write_png", "io");
+        status = cairo_surface_write_to_png(surface, filename.c_str());
+    }
+    
+    SurfacePool::instance().release(surface);
     
     return status == CAIRO_STATUS_SUCCESS;
 }
 
 bool SubplotManager::save_svg(const std::string& filename) {
+    PLOTLIB_TRACE_SCOPE("save_svg", "export");
+    if (render_cache) {
+        std::string svg_data;
+        return save_svg_to_buffer(svg_data) && write_output_file(filename, svg_data.data(), svg_data.size(), "SVG");
+    }
+    
     cairo_surface_t* surface = cairo_svg_surface_create(filename.c_str(), total_width, total_height);
     cairo_t* cr = cairo_create(surface);
     
@@ -864,4 +1898,126 @@ bool SubplotManager::save_svg(const std::string& filename) {
     return true;
 }
 
-} // namespace plotlib 
\ No newline at end of file
+bool SubplotManager::render_to_buffer(std::vector<unsigned char>& pixels) {
+    PLOTLIB_TRACE_SCOPE("render_to_buffer", "export");
+    RenderKey key;
+    bool cacheable = render_cache && render_cache_key(RenderFormat::PIXELS, key);
+    if (cacheable && render_cache->lookup(key, pixels)) return true;
+    
+    cairo_surface_t* surface = render_image_surface();
+    bool success = copy_surface_pixels(surface, pixels);
+    SurfacePool::instance().release(surface);
+    
+    if (cacheable && success) render_cache->store(key, pixels);
+    return success;
+}
+
+bool SubplotManager::render_progressive(std::vector<unsigned char>& pixels, const ProgressCallback& callback) {
+    PLOTLIB_TRACE_SCOPE("render_progressive", "export");
+    size_t largest = 0;
+    for (const auto& row : subplots) {
+        for (const auto& subplot : row) {
+            if (subplot) largest = std::max(largest, subplot->sampled_point_count());
+        }
+    }
+    size_t strides[4];
+    int pass_count = choose_progressive_strides(largest, PlotManager::PROGRESSIVE_MIN_POINTS, strides);
+    
+    for (int pass = 0; pass < pass_count; ++pass) {
+        PLOTLIB_TRACE_SCOPE("progressive_pass", "render");
+        for (auto& row : subplots) {
+            for (auto& subplot : row) {
+                if (subplot) subplot->progressive_stride = strides[pass];
+            }
+        }
+        cairo_surface_t* surface = render_image_surface();
+        for (auto& row : subplots) {
+            for (auto& subplot : row) {
+                if (subplot) subplot->progressive_stride = 1;
+            }
+        }
+        
+        bool success = copy_surface_pixels(surface, pixels);
+        SurfacePool::instance().release(surface);
+        if (!success) return false;
+        
+        bool last_pass = pass + 1 == pass_count;
+        if (callback && !callback(pass + 1, pass_count) && !last_pass) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SubplotManager::save_png_to_buffer(std::vector<unsigned char>& png_data) {
+    PLOTLIB_TRACE_SCOPE("save_png_to_buffer", "export");
+    RenderKey key;
+    bool cacheable = render_cache && render_cache_key(RenderFormat::PNG, key);
+    if (cacheable && render_cache->lookup(key, png_data)) return true;
+    
+    cairo_surface_t* surface = render_image_surface();
+    
+    png_data.clear();
+    cairo_status_t status;
+    {
+        PLOTLIB_TRACE_SCOPE("encode_png", "encode");
+        status = cairo_surface_write_to_png_stream(surface, append_to_vector, &png_data);
+    }
+    
+    SurfacePool::instance().release(surface);
+    
+    bool success = status == CAIRO_STATUS_SUCCESS;
+    if (cacheable && success) render_cache->store(key, png_data);
+    return success;
+}
+
+bool SubplotManager::save_svg_to_buffer(std::string& svg_data) {
+    PLOTLIB_TRACE_SCOPE("save_svg_to_buffer", "export");
+    RenderKey key;
+    bool cacheable = render_cache && render_cache_key(RenderFormat::SVG, key);
+    std::vector<unsigned char> cached;
+    if (cacheable && render_cache->lookup(key, cached)) {
+        svg_data.assign(cached.begin(), cached.end());
+        return true;
+    }
+    
+    svg_data.clear();
+    cairo_surface_t* surface = cairo_svg_surface_create_for_stream(append_to_string, &svg_data, total_width, total_height);
+    cairo_t* cr = cairo_create(surface);
+    
+    render_to_context(cr);
+    
+    cairo_destroy(cr);
+    cairo_surface_finish(surface);
+    cairo_status_t status = cairo_surface_status(surface);
+    cairo_surface_destroy(surface);
+    
+    bool success = status == CAIRO_STATUS_SUCCESS;
+    if (cacheable && success) render_cache->store(key, std::vector<unsigned char>(svg_data.begin(), svg_data.end()));
+    return success;
+}
+
+void warm_up(int width, int height) {
+    PLOTLIB_TRACE_SCOPE("warm_up", "init");
+    trace::is_enabled();  // Reads PLOTLIB_TRACE
+    
+    cairo_surface_t* surface = SurfacePool::instance().acquire(width, height);
+    cairo_t* cr = cairo_create(surface);
+    
+    // Resolve both faces and fill the glyph caches for every size plots draw text at
+    static const char* const sample_text = "0123456789.-+eE abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    static const double font_sizes[] = {10, 12, 16, 20};
+    for (cairo_font_weight_t weight : {CAIRO_FONT_WEIGHT_NORMAL, CAIRO_FONT_WEIGHT_BOLD}) {
+        fonts::select_font_face(cr, weight);
+        for (double size : font_sizes) {
+            cairo_set_font_size(cr, size);
+            cairo_text_extents_t extents;
+            cairo_text_extents(cr, sample_text, &extents);
+        }
+    }
+    
+    cairo_destroy(cr);
+    SurfacePool::instance().release(surface);
+}
+
+} // namespace plotlib
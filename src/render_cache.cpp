@@ -0,0 +1,307 @@
+#include "render_cache.h"
+#include "fonts.h"
+#include "plot_manager.h"
+#include "snapshot.h"
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <unistd.h>
+
+namespace plotlib {
+
+namespace {
+
+#ifndef PLOTLIB_VERSION
+#define PLOTLIB_VERSION "unknown"
+#endif
+
+// Every cache file name starts with CACHE_FILE_FAMILY
+const char CACHE_FILE_FAMILY[] = "plc";
+
+/**
+ * @brief File name prefix of this build's cache entries
+ *
+ * Names the library and snapshot versions, so a disk tier shared across
+ * versions never serves another version's rendering. Other versions' files
+ * still count towards the disk limit and are evicted like any other.
+ */
+const std::string& cache_file_prefix() {
+    static const std::string prefix = std::string(CACHE_FILE_FAMILY) + "-" + PLOTLIB_VERSION + "-s" +
+                                      std::to_string(SNAPSHOT_VERSION) + "-";
+    return prefix;
+}
+
+const char* format_extension(RenderFormat format) {
+    switch (format) {
+        case RenderFormat::SVG: return ".svg";
+        case RenderFormat::PIXELS: return ".raw";
+        case RenderFormat::PNG:
+        default: return ".png";
+    }
+}
+
+bool is_cache_file_name(const std::string& name) {
+    if (name.compare(0, sizeof(CACHE_FILE_FAMILY) - 1, CACHE_FILE_FAMILY) != 0) return false;
+    if (name.size() < 4) return false;
+    std::string extension = name.substr(name.size() - 4);
+    return extension == ".png" || extension == ".svg" || extension == ".raw";
+}
+
+} // anonymous namespace
+
+RenderCache::RenderCache(size_t memory_limit_bytes, const std::string& disk_directory, size_t disk_limit_bytes)
+    : memory_limit(memory_limit_bytes), disk_directory(disk_directory), disk_limit(disk_limit_bytes) {
+    if (this->disk_directory.empty()) return;
+
+    std::error_code error;
+    std::filesystem::create_directories(this->disk_directory, error);
+    if (error) {
+        std::cerr << "Error: Cannot create render cache directory '" << this->disk_directory
+                  << "', disk cache disabled" << std::endl;
+        this->disk_directory.clear();
+        return;
+    }
+    scan_disk_directory();
+}
+
+std::string RenderCache::file_name(const RenderKey& key) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%016llx%016llx%s",
+                  static_cast<unsigned long long>(key.state_hash),
+                  static_cast<unsigned long long>(key.state_size), format_extension(key.format));
+    return cache_file_prefix() + name;
+}
+
+void RenderCache::scan_disk_directory() {
+    struct FoundFile {
+        std::filesystem::file_time_type modified;
+        std::string name;
+        size_t size;
+    };
+    std::vector<FoundFile> found;
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(disk_directory, error)) {
+        std::string name = entry.path().filename().string();
+        if (!is_cache_file_name(name) || !entry.is_regular_file(error)) continue;
+        found.push_back({entry.last_write_time(error), name, static_cast<size_t>(entry.file_size(error))});
+    }
+
+    // Most recently used first, matching disk_order
+    std::sort(found.begin(), found.end(), [](const FoundFile& a, const FoundFile& b) {
+        return a.modified > b.modified;
+    });
+    for (const auto& file : found) {
+        disk_order.push_back(file.name);
+        disk_index[file.name] = {std::prev(disk_order.end()), file.size};
+        stats.disk_bytes += file.size;
+    }
+    while (stats.disk_bytes > disk_limit && !disk_order.empty()) {
+        remove_disk_entry(disk_order.back());
+    }
+}
+
+void RenderCache::store_in_memory(const RenderKey& key, const std::vector<unsigned char>& bytes) {
+    if (bytes.size() > memory_limit) return;
+
+    auto existing = memory_index.find(key);
+    if (existing != memory_index.end()) {
+        stats.memory_bytes -= existing->second->bytes.size();
+        memory_order.erase(existing->second);
+        memory_index.erase(existing);
+    }
+
+    memory_order.push_front({key, bytes});
+    memory_index[key] = memory_order.begin();
+    stats.memory_bytes += bytes.size();
+
+    while (stats.memory_bytes > memory_limit) {
+        const MemoryEntry& oldest = memory_order.back();
+        stats.memory_bytes -= oldest.bytes.size();
+        memory_index.erase(oldest.key);
+        memory_order.pop_back();
+    }
+}
+
+void RenderCache::touch_disk_entry(const std::string& name, size_t size) {
+    auto existing = disk_index.find(name);
+    if (existing != disk_index.end()) {
+        stats.disk_bytes -= existing->second.size;
+        disk_order.erase(existing->second.position);
+    }
+    disk_order.push_front(name);
+    disk_index[name] = {disk_order.begin(), size};
+    stats.disk_bytes += size;
+}
+
+void RenderCache::remove_disk_entry(const std::string& name) {
+    auto existing = disk_index.find(name);
+    if (existing == disk_index.end()) return;
+
+    std::error_code error;
+    std::filesystem::remove(std::filesystem::path(disk_directory) / name, error);
+    stats.disk_bytes -= existing->second.size;
+    disk_order.erase(existing->second.position);
+    disk_index.erase(existing);
+}
+
+void RenderCache::store_on_disk(const std::string& name, const std::vector<unsigned char>& bytes) {
+    if (disk_directory.empty() || bytes.size() > disk_limit) return;
+    PLOTLIB_TRACE_SCOPE("render_cache_write", "io");
+
+    // Write to a private temporary file and rename, so concurrent readers never see partial files
+    static std::atomic<unsigned> temporary_counter{0};
+    std::filesystem::path path = std::filesystem::path(disk_directory) / name;
+    std::filesystem::path temporary = path;
+    temporary += ".tmp" + std::to_string(getpid()) + "-" + std::to_string(temporary_counter++);
+
+    FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) return;
+    bool success = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    success = std::fclose(file) == 0 && success;
+
+    std::error_code error;
+    if (success) std::filesystem::rename(temporary, path, error);
+    if (!success || error) {
+        std::filesystem::remove(temporary, error);
+        return;
+    }
+
+    touch_disk_entry(name, bytes.size());
+    while (stats.disk_bytes > disk_limit && disk_order.size() > 1) {
+        remove_disk_entry(disk_order.back());
+    }
+}
+
+bool RenderCache::load_from_disk(const std::string& name, std::vector<unsigned char>& bytes) {
+    if (disk_directory.empty()) return false;
+
+    // Also finds files stored by other processes since the directory was scanned
+    std::filesystem::path path = std::filesystem::path(disk_directory) / name;
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        if (disk_index.count(name)) remove_disk_entry(name);
+        return false;
+    }
+    PLOTLIB_TRACE_SCOPE("render_cache_read", "io");
+
+    bool success = std::fseek(file, 0, SEEK_END) == 0;
+    long size = success ? std::ftell(file) : -1;
+    success = size >= 0 && std::fseek(file, 0, SEEK_SET) == 0;
+    if (success) {
+        bytes.resize(static_cast<size_t>(size));
+        success = std::fread(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    }
+    std::fclose(file);
+    if (!success) return false;
+
+    // Keep the file's age in step with its use, for the LRU order of later scans
+    std::error_code error;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+    touch_disk_entry(name, bytes.size());
+    return true;
+}
+
+bool RenderCache::lookup(const RenderKey& key, std::vector<unsigned char>& bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto found = memory_index.find(key);
+    if (found != memory_index.end()) {
+        memory_order.splice(memory_order.begin(), memory_order, found->second);
+        bytes = found->second->bytes;
+        ++stats.memory_hits;
+        return true;
+    }
+
+    if (load_from_disk(file_name(key), bytes)) {
+        store_in_memory(key, bytes);
+        ++stats.disk_hits;
+        return true;
+    }
+
+    ++stats.misses;
+    return false;
+}
+
+void RenderCache::store(const RenderKey& key, const std::vector<unsigned char>& bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    store_in_memory(key, bytes);
+    store_on_disk(file_name(key), bytes);
+}
+
+void RenderCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    memory_order.clear();
+    memory_index.clear();
+    stats.memory_bytes = 0;
+    while (!disk_order.empty()) {
+        remove_disk_entry(disk_order.back());
+    }
+}
+
+RenderCache::Stats RenderCache::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+// Render cache keys
+
+void PlotManager::hash_external_inputs(SnapshotWriter& /*hasher*/) const {
+}
+
+bool PlotManager::render_cache_key(RenderFormat format, RenderKey& key) {
+    if (snapshot_type() == SnapshotPlotType::NONE) return false;
+    PLOTLIB_TRACE_SCOPE("render_cache_key", "export");
+    ensure_bounds();
+
+    SnapshotWriter hasher;
+    hasher.put_u32(static_cast<uint32_t>(snapshot_type()));
+    write_snapshot(hasher);
+    hash_external_inputs(hasher);
+    // Registered font files; the disk tier is shared between processes
+    hasher.put_string(fonts::registration_key());
+    // Placement inside a subplot grid changes the output but is not part of the snapshot
+    hasher.put_bool(is_subplot);
+    if (is_subplot) {
+        hasher.put_f64(subplot_x_offset);
+        hasher.put_f64(subplot_y_offset);
+        hasher.put_f64(subplot_width_scale);
+        hasher.put_f64(subplot_height_scale);
+    }
+
+    key.state_hash = hasher.digest();
+    key.state_size = hasher.size();
+    key.format = format;
+    return true;
+}
+
+bool SubplotManager::render_cache_key(RenderFormat format, RenderKey& key) {
+    for (const auto& row : subplots) {
+        for (const auto& plot : row) {
+            if (plot && plot->snapshot_type() == SnapshotPlotType::NONE) return false;
+        }
+    }
+    PLOTLIB_TRACE_SCOPE("render_cache_key", "export");
+    // Resolve own and shared axis ranges as rendering does, so the key is stable across renders
+    apply_shared_axes();
+
+    SnapshotWriter hasher;
+    hasher.put_u32(0);  // Distinguishes figures from single plots
+    write_snapshot(hasher);
+    for (const auto& row : subplots) {
+        for (const auto& plot : row) {
+            if (plot) plot->hash_external_inputs(hasher);
+        }
+    }
+    hasher.put_string(fonts::registration_key());
+
+    key.state_hash = hasher.digest();
+    key.state_size = hasher.size();
+    key.format = format;
+    return true;
+}
+
+} // namespace plotlib
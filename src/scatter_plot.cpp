@@ -1,9 +1,9 @@
 #include "scatter_plot.h"
+#include "snapshot.h"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <set>
-#include <map>
 
 namespace plotlib {
 
@@ -13,17 +13,58 @@ ScatterPlot::ScatterPlot(int width, int height) : PlotManager(width, height) {
 
 void ScatterPlot::set_default_marker_type(MarkerType marker_type) {
     default_marker_type = marker_type;
+    mark_modified(false);
 }
 
-std::vector<double> ScatterPlot::get_cluster_color(int cluster_label) {
+PlotStyle ScatterPlot::get_cluster_color(int cluster_label) {
     if (cluster_label == -1) {
-        return {1.0, 0.0, 0.0}; // Red for outliers
+        PlotStyle style;
+        style.r = 1.0; style.g = 0.0; style.b = 0.0; // Red for outliers
+        return style;
     }
     
     // Use auto_colors from PlotManager for consistency
-    std::string color_name = get_auto_color(cluster_label);
-    PlotStyle style = color_to_style(color_name, 3.0, 2.0);
-    return {style.r, style.g, style.b};
+    return color_to_style(auto_colors[cluster_label % auto_colors.size()], 3.0, 2.0);
+}
+
+void ScatterPlot::index_clusters(ClusterSeries& series) {
+    // Group points by label once; stable so each cluster keeps its input order
+    std::stable_sort(series.points.begin(), series.points.end(),
+                     [](const ClusterPoint& a, const ClusterPoint& b) { return a.cluster_label < b.cluster_label; });
+    
+    series.runs.clear();
+    size_t begin = 0;
+    while (begin < series.points.size()) {
+        int label = series.points[begin].cluster_label;
+        size_t end = begin;
+        while (end < series.points.size() && series.points[end].cluster_label == label) {
+            ++end;
+        }
+        
+        ClusterRun run;
+        run.cluster_label = label;
+        run.begin = begin;
+        run.end = end;
+        
+        // Name: custom if provided, otherwise "Outliers" / "Cluster <label + 1>"
+        if (!series.use_auto_naming && series.cluster_names.count(label) > 0) {
+            run.name = series.cluster_names.at(label);
+        } else {
+            run.name = (label == -1) ? "Outliers" : "Cluster " + std::to_string(label + 1);
+        }
+        
+        // Color: custom if provided, otherwise red outliers and auto-colored clusters
+        if (!series.use_auto_coloring && series.cluster_colors.count(label) > 0) {
+            run.legend_style = color_to_style(series.cluster_colors.at(label), 3.0, 2.0);
+        } else {
+            run.legend_style = get_cluster_color(label);
+            run.legend_style.point_size = 3.0;
+            run.legend_style.alpha = 0.8;
+        }
+        
+        series.runs.push_back(run);
+        begin = end;
+    }
 }
 
 void ScatterPlot::draw_data(cairo_t* cr) {
@@ -35,72 +76,28 @@ void ScatterPlot::draw_data(cairo_t* cr) {
 }
 
 void ScatterPlot::draw_points(cairo_t* cr) {
-    for (const auto& series : data_series) {
-        for (const auto& pt : series.points) {
-            double screen_x, screen_y;
-            transform_point(pt.x, pt.y, screen_x, screen_y);
-            
-            draw_marker(cr, screen_x, screen_y, default_marker_type, 
-                       series.style.point_size, series.style.r, series.style.g, 
-                       series.style.b, series.style.alpha);
-        }
+    for (auto& series : data_series) {
+        const float* screen = screen_coordinates(series.screen, series.x.data(), series.y.data(), series.size());
+        draw_marker_run(cr, screen, 0, series.size(), series_stride(series.size()), default_marker_type,
+                        series.style.point_size, series.style.r, series.style.g, series.style.b,
+                        series.style.alpha);
     }
 }
 
 void ScatterPlot::draw_cluster_points(cairo_t* cr) {
-    for (const auto& series : cluster_series) {
-        // Group points by cluster label for proper legend handling
-        std::map<int, std::vector<ClusterPoint>> clusters_by_label;
-        for (const auto& cluster_pt : series.points) {
-            clusters_by_label[cluster_pt.cluster_label].push_back(cluster_pt);
-        }
-        
-        // Draw outliers first (background) - Red cross (customizable if custom colors provided)
-        if (clusters_by_label.count(-1) > 0) {
-            for (const auto& cluster_pt : clusters_by_label[-1]) {
-                double screen_x, screen_y;
-                transform_point(cluster_pt.x, cluster_pt.y, screen_x, screen_y);
-                
-                // Get outlier color (red by default, or custom if provided)
-                std::vector<double> outlier_color;
-                if (!series.use_auto_coloring && series.cluster_colors.count(-1) > 0) {
-                    // Use custom color if provided
-                    PlotStyle custom_style = color_to_style(series.cluster_colors.at(-1), 3.0, 2.0);
-                    outlier_color = {custom_style.r, custom_style.g, custom_style.b};
-                } else {
-                    // Default red for outliers
-                    outlier_color = {1.0, 0.0, 0.0};
-                }
-                
-                draw_marker(cr, screen_x, screen_y, MarkerType::CROSS, 
-                           series.point_size, outlier_color[0], outlier_color[1], outlier_color[2], series.alpha);
-            }
-        }
+    for (auto& series : cluster_series) {
+        if (series.points.empty()) continue;
+        const float* screen = screen_coordinates(series.screen, &series.points[0].x, &series.points[0].y,
+                                                 series.points.size(), sizeof(ClusterPoint));
         
-        // Draw cluster points on top - Auto-colors or custom colors, circles
-        for (const auto& cluster_pair : clusters_by_label) {
-            int cluster_label = cluster_pair.first;
-            if (cluster_label == -1) continue; // Skip outliers (already drawn)
-            
-            // Get cluster color (auto or custom)
-            std::vector<double> cluster_color;
-            if (!series.use_auto_coloring && series.cluster_colors.count(cluster_label) > 0) {
-                // Use custom color if provided
-                PlotStyle custom_style = color_to_style(series.cluster_colors.at(cluster_label), 3.0, 2.0);
-                cluster_color = {custom_style.r, custom_style.g, custom_style.b};
-            } else {
-                // Use automatic coloring
-                cluster_color = get_cluster_color(cluster_label);
-            }
+        // Runs are in ascending label order: outliers (red crosses, or custom color)
+        // form the background, cluster circles are drawn on top
+        for (const auto& run : series.runs) {
+            MarkerType marker = (run.cluster_label == -1) ? MarkerType::CROSS : MarkerType::CIRCLE;
+            const PlotStyle& color = run.legend_style;
             
-            for (const auto& cluster_pt : cluster_pair.second) {
-                double screen_x, screen_y;
-                transform_point(cluster_pt.x, cluster_pt.y, screen_x, screen_y);
-                
-                // Fixed marker type for clusters: circle
-                draw_marker(cr, screen_x, screen_y, MarkerType::CIRCLE, 
-                           series.point_size, cluster_color[0], cluster_color[1], cluster_color[2], series.alpha);
-            }
+            draw_marker_run(cr, screen, run.begin, run.end, series_stride(run.end - run.begin), marker,
+                            series.point_size, color.r, color.g, color.b, series.alpha);
         }
     }
 }
@@ -148,65 +145,13 @@ void ScatterPlot::collect_legend_items(std::vector<LegendItem>& items) {
     // Start with base class items (data_series and reference_lines)
     PlotManager::collect_legend_items(items);
     
-    // Add cluster legend entries (independent sequence for each cluster series)
+    // Add cluster legend entries (independent sequence for each cluster series),
+    // outliers first as their run sorts first
     for (const auto& series : cluster_series) {
-        // Find all unique cluster labels in this series
-        std::set<int> unique_labels;
-        for (const auto& cluster_pt : series.points) {
-            unique_labels.insert(cluster_pt.cluster_label);
-        }
-        
-        // Create legend entry for outliers first (if present)
-        if (unique_labels.count(-1) > 0) {
-            std::string outlier_name = "Outliers";
-            if (!series.use_auto_naming && series.cluster_names.count(-1) > 0) {
-                outlier_name = series.cluster_names.at(-1);
-            }
-            
-            if (hidden_legend_items.find(outlier_name) == hidden_legend_items.end()) {
-                // Use same color logic as drawing
-                PlotStyle outlier_style;
-                if (!series.use_auto_coloring && series.cluster_colors.count(-1) > 0) {
-                    // Use custom color if provided
-                    outlier_style = color_to_style(series.cluster_colors.at(-1), 3.0, 2.0);
-                } else {
-                    // Default red for outliers
-                    outlier_style.point_size = 3.0;
-                    outlier_style.r = 1.0;
-                    outlier_style.g = 0.0;
-                    outlier_style.b = 0.0;
-                    outlier_style.alpha = 0.8;
-                }
-                items.emplace_back(outlier_name, outlier_style, LegendSymbolType::MARKER, MarkerType::CROSS);
-            }
-        }
-        
-        // Create legend entries for clusters (using actual cluster labels for consistency)
-        for (int label : unique_labels) {
-            if (label == -1) continue; // Skip outliers (already handled)
-            
-            // Use actual cluster label + 1 for naming to match user expectation (Cluster 1, Cluster 2, etc.)
-            std::string cluster_name = "Cluster " + std::to_string(label + 1);
-            if (!series.use_auto_naming && series.cluster_names.count(label) > 0) {
-                cluster_name = series.cluster_names.at(label);
-            }
-            
-            if (hidden_legend_items.find(cluster_name) == hidden_legend_items.end()) {
-                // Use same color logic as drawing
-                PlotStyle cluster_style;
-                if (!series.use_auto_coloring && series.cluster_colors.count(label) > 0) {
-                    // Use custom color if provided
-                    cluster_style = color_to_style(series.cluster_colors.at(label), 3.0, 2.0);
-                } else {
-                    // Use automatic coloring - use actual label for color consistency
-                    auto color = get_cluster_color(label);
-                    cluster_style.point_size = 3.0;
-                    cluster_style.r = color[0];
-                    cluster_style.g = color[1]; 
-                    cluster_style.b = color[2];
-                    cluster_style.alpha = 0.8;
-                }
-                items.emplace_back(cluster_name, cluster_style, LegendSymbolType::MARKER, MarkerType::CIRCLE);
+        for (const auto& run : series.runs) {
+            if (hidden_legend_items.find(run.name) == hidden_legend_items.end()) {
+                MarkerType marker = (run.cluster_label == -1) ? MarkerType::CROSS : MarkerType::CIRCLE;
+                items.emplace_back(run.name, run.legend_style, LegendSymbolType::MARKER, marker);
             }
         }
     }
@@ -238,7 +183,7 @@ void ScatterPlot::add_cluster_data(const std::vector<double>& x_values, const st
     if (names.empty()) {
         // Automatic naming: restart cluster sequence for each add_clusters call
         series.use_auto_naming = true;
-        // Names will be generated in draw_cluster_points: "Outliers", "Cluster 1", "Cluster 2", etc.
+        // Names are generated in index_clusters: "Outliers", "Cluster 1", "Cluster 2", etc.
     } else {
         // Custom naming provided
         series.use_auto_naming = false;
@@ -269,16 +214,19 @@ void ScatterPlot::add_cluster_data(const std::vector<double>& x_values, const st
     }
     
     // Add all points to the series
+    series.points.reserve(x_values.size());
     for (size_t i = 0; i < x_values.size(); ++i) {
         series.points.emplace_back(x_values[i], y_values[i], cluster_labels[i]);
     }
+    index_clusters(series);
     
-    cluster_series.push_back(series);
+    cluster_series.push_back(std::move(series));
     bounds_set = false;
+    mark_modified();
 }
 
 // Beginner-friendly convenience methods
-void ScatterPlot::add_scatter(const std::vector<double>& x_values, const std::vector<double>& y_values,
+void ScatterPlot::add_scatter(const DataColumn& x_values, const DataColumn& y_values,
                              const std::string& name, const std::string& color_name) {
     if (x_values.size() != y_values.size()) {
         std::cerr << "Error: X and Y vectors must have the same size" << std::endl;
@@ -286,32 +234,34 @@ void ScatterPlot::add_scatter(const std::vector<double>& x_values, const std::ve
     }
     
     DataSeries series(name);
-    for (size_t i = 0; i < x_values.size(); ++i) {
-        series.points.emplace_back(x_values[i], y_values[i]);
-    }
+    series.x = x_values;
+    series.y = y_values;
     series.style = color_to_style(color_name, 3.0, 2.0);
     
-    data_series.push_back(series);
+    data_series.push_back(std::move(series));
     bounds_set = false;
+    mark_modified();
 }
 
-void ScatterPlot::add_scatter(const std::vector<double>& x_values, const std::vector<double>& y_values,
+void ScatterPlot::add_scatter(const DataColumn& x_values, const DataColumn& y_values,
                              const std::string& name) {
+    std::string color = get_auto_color(data_series.size());
+    add_scatter(x_values, y_values, name, color);
+}
+
+void ScatterPlot::add_scatter(const std::vector<double>& x_values, const std::vector<double>& y_values,
+                             const std::string& name, const std::string& color_name) {
     if (x_values.size() != y_values.size()) {
         std::cerr << "Error: X and Y vectors must have the same size" << std::endl;
         return;
     }
-    
-    DataSeries series(name);
-    for (size_t i = 0; i < x_values.size(); ++i) {
-        series.points.emplace_back(x_values[i], y_values[i]);
-    }
-    
+    add_scatter(DataColumn(x_values), DataColumn(y_values), name, color_name);
+}
+
+void ScatterPlot::add_scatter(const std::vector<double>& x_values, const std::vector<double>& y_values,
+                             const std::string& name) {
     std::string color = get_auto_color(data_series.size());
-    series.style = color_to_style(color, 3.0, 2.0);
-    
-    data_series.push_back(series);
-    bounds_set = false;
+    add_scatter(x_values, y_values, name, color);
 }
 
 void ScatterPlot::add_scatter(const std::vector<double>& x_values, const std::vector<double>& y_values) {
@@ -348,7 +298,7 @@ bool ScatterPlot::is_plot_empty() const {
     // Check if all regular data series have empty points
     bool has_regular_data = false;
     for (const auto& series : data_series) {
-        if (!series.points.empty()) {
+        if (series.size() > 0) {
             has_regular_data = true;
             break;
         }
@@ -366,4 +316,132 @@ bool ScatterPlot::is_plot_empty() const {
     return !has_regular_data && !has_cluster_data;
 }
 
+size_t ScatterPlot::sampled_point_count() const {
+    size_t largest = PlotManager::sampled_point_count();
+    for (const auto& series : cluster_series) {
+        for (const auto& run : series.runs) {
+            largest = std::max(largest, run.end - run.begin);
+        }
+    }
+    return largest;
+}
+
+bool ScatterPlot::collect_html_series(std::vector<HtmlSeries>& series) {
+    // Same order as draw_data(): clusters (outliers first), then regular points
+    for (const auto& cluster : cluster_series) {
+        for (const auto& run : cluster.runs) {
+            HtmlSeries entry;
+            entry.marker = (run.cluster_label == -1) ? MarkerType::CROSS : MarkerType::CIRCLE;
+            entry.style = run.legend_style;
+            entry.style.point_size = cluster.point_size;
+            entry.style.alpha = cluster.alpha;
+            entry.x.reserve(run.end - run.begin);
+            entry.y.reserve(run.end - run.begin);
+            for (size_t i = run.begin; i < run.end; ++i) {
+                entry.x.push_back(static_cast<float>(cluster.points[i].x - min_x));
+                entry.y.push_back(static_cast<float>(cluster.points[i].y - min_y));
+            }
+            series.push_back(std::move(entry));
+        }
+    }
+    
+    for (const auto& data : data_series) {
+        HtmlSeries entry;
+        entry.marker = default_marker_type;
+        entry.style = data.style;
+        entry.x.reserve(data.size());
+        entry.y.reserve(data.size());
+        const double* xs = data.x.data();
+        const double* ys = data.y.data();
+        for (size_t i = 0; i < data.size(); ++i) {
+            entry.x.push_back(static_cast<float>(xs[i] - min_x));
+            entry.y.push_back(static_cast<float>(ys[i] - min_y));
+        }
+        series.push_back(std::move(entry));
+    }
+    return true;
+}
+
+SnapshotPlotType ScatterPlot::snapshot_type() const {
+    return SnapshotPlotType::SCATTER;
+}
+
+void ScatterPlot::write_snapshot(SnapshotWriter& writer) const {
+    PlotManager::write_snapshot(writer);
+    writer.put_u32(static_cast<uint32_t>(default_marker_type));
+    
+    writer.put_u64(cluster_series.size());
+    for (const auto& cluster : cluster_series) {
+        writer.put_string(cluster.name);
+        writer.put_f64(cluster.point_size);
+        writer.put_f64(cluster.alpha);
+        writer.put_bool(cluster.use_auto_naming);
+        writer.put_bool(cluster.use_auto_coloring);
+        for (const auto* labels : {&cluster.cluster_names, &cluster.cluster_colors}) {
+            writer.put_u64(labels->size());
+            for (const auto& entry : *labels) {
+                writer.put_u32(static_cast<uint32_t>(entry.first));
+                writer.put_string(entry.second);
+            }
+        }
+        
+        // Points are already grouped by label; the resolved runs avoid regrouping on load
+        writer.put_array(cluster.points);
+        writer.put_u64(cluster.runs.size());
+        for (const auto& run : cluster.runs) {
+            writer.put_u32(static_cast<uint32_t>(run.cluster_label));
+            writer.put_u64(run.begin);
+            writer.put_u64(run.end);
+            writer.put_style(run.legend_style);
+            writer.put_string(run.name);
+        }
+    }
+}
+
+bool ScatterPlot::read_snapshot(SnapshotReader& reader) {
+    if (!PlotManager::read_snapshot(reader)) return false;
+    uint32_t marker = reader.get_u32();
+    if (marker > static_cast<uint32_t>(MarkerType::TRIANGLE)) {
+        reader.fail();
+        return false;
+    }
+    default_marker_type = static_cast<MarkerType>(marker);
+    
+    cluster_series.clear();
+    uint64_t series_count = reader.get_count(sizeof(uint64_t));
+    cluster_series.reserve(series_count);
+    for (uint64_t i = 0; i < series_count && reader.ok(); ++i) {
+        ClusterSeries cluster(reader.get_string());
+        cluster.point_size = reader.get_f64();
+        cluster.alpha = reader.get_f64();
+        cluster.use_auto_naming = reader.get_bool();
+        cluster.use_auto_coloring = reader.get_bool();
+        for (auto* labels : {&cluster.cluster_names, &cluster.cluster_colors}) {
+            uint64_t label_count = reader.get_count(sizeof(uint32_t) + sizeof(uint64_t));
+            for (uint64_t j = 0; j < label_count; ++j) {
+                int label = static_cast<int>(reader.get_u32());
+                (*labels)[label] = reader.get_string();
+            }
+        }
+        
+        reader.get_array(cluster.points);
+        uint64_t run_count = reader.get_count(sizeof(uint32_t) + 2 * sizeof(uint64_t));
+        cluster.runs.reserve(run_count);
+        for (uint64_t j = 0; j < run_count && reader.ok(); ++j) {
+            ClusterRun run;
+            run.cluster_label = static_cast<int>(reader.get_u32());
+            run.begin = reader.get_u64();
+            run.end = reader.get_u64();
+            run.legend_style = reader.get_style();
+            run.name = reader.get_string();
+            if (run.begin > run.end || run.end > cluster.points.size()) reader.fail();
+            cluster.runs.push_back(std::move(run));
+        }
+        cluster_series.push_back(std::move(cluster));
+    }
+    
+    mark_modified();
+    return reader.ok();
+}
+
 } // namespace plotlib
@@ -0,0 +1,347 @@
+#include "series_pyramid.h"
+#include "trace.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace plotlib {
+
+namespace {
+
+const char PYRAMID_MAGIC[8] = {'P', 'L', 'P', 'Y', 'R', 'M', 'D', '1'};
+const uint32_t PYRAMID_VERSION = 1;
+const uint64_t SECTION_ALIGNMENT = 4096;
+
+uint64_t align_offset(uint64_t offset) {
+    return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+}
+
+bool pad_to(FILE* file, uint64_t offset) {
+    static const char zeros[SECTION_ALIGNMENT] = {};
+    long position = std::ftell(file);
+    if (position < 0) return false;
+    uint64_t remaining = offset - static_cast<uint64_t>(position);
+    return remaining == 0 || std::fwrite(zeros, 1, remaining, file) == remaining;
+}
+
+void merge_bucket(PyramidBucket& target, uint32_t& count, const PyramidBucket& bucket) {
+    if (count == 0) {
+        target = bucket;
+    } else {
+        target.x_last = bucket.x_last;
+        target.y_last = bucket.y_last;
+        target.y_min = std::min(target.y_min, bucket.y_min);
+        target.y_max = std::max(target.y_max, bucket.y_max);
+    }
+    ++count;
+}
+
+} // namespace
+
+// PyramidFileWriter implementation
+
+PyramidFileWriter::PyramidFileWriter(const std::string& filename, uint32_t block_points, uint32_t fanout)
+    : filename(filename), block_points(std::max<uint32_t>(1, block_points)), fanout(std::max<uint32_t>(2, fanout)) {
+    file = std::fopen(filename.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error: Cannot open pyramid file '" << filename << "' for writing" << std::endl;
+        return;
+    }
+
+    // Reserve space for the header; it is written last
+    if (!pad_to(file, align_offset(sizeof(PyramidFileHeader)))) {
+        failed = true;
+    }
+    block.reserve(this->block_points);
+}
+
+PyramidFileWriter::~PyramidFileWriter() {
+    if (!finished) {
+        finish();
+    }
+    close_temporaries();
+}
+
+void PyramidFileWriter::close_temporaries() {
+    for (auto& level : levels) {
+        if (level.file) {
+            std::fclose(level.file);
+            level.file = nullptr;
+        }
+    }
+}
+
+void PyramidFileWriter::push_bucket(size_t level, const PyramidBucket& bucket) {
+    if (level >= static_cast<size_t>(PyramidFileHeader::MAX_LEVELS)) return;
+
+    if (levels.size() <= level) {
+        levels.resize(level + 1);
+    }
+    LevelState& state = levels[level];
+    if (!state.file) {
+        state.file = std::tmpfile();
+        if (!state.file) {
+            std::cerr << "Error: Cannot create temporary file for pyramid level " << level << std::endl;
+            failed = true;
+            return;
+        }
+    }
+
+    if (std::fwrite(&bucket, sizeof(PyramidBucket), 1, state.file) != 1) {
+        failed = true;
+        return;
+    }
+    ++state.entries;
+
+    // Accumulate into the next level and emit it once `fanout` buckets are merged
+    if (levels.size() <= level + 1) {
+        levels.resize(level + 2);
+    }
+    LevelState& next = levels[level + 1];
+    merge_bucket(next.partial, next.partial_count, bucket);
+    if (next.partial_count == fanout) {
+        PyramidBucket complete = next.partial;
+        next.partial_count = 0;
+        push_bucket(level + 1, complete);
+    }
+}
+
+void PyramidFileWriter::write_block() {
+    if (block.empty()) return;
+
+    if (std::fwrite(block.data(), sizeof(Point2D), block.size(), file) != block.size()) {
+        std::cerr << "Error: Failed writing pyramid file '" << filename << "'" << std::endl;
+        failed = true;
+        return;
+    }
+
+    PyramidBucket bucket;
+    bucket.x_first = block.front().x;
+    bucket.x_last = block.back().x;
+    bucket.y_first = block.front().y;
+    bucket.y_last = block.back().y;
+    bucket.y_min = bucket.y_max = block.front().y;
+    for (const auto& pt : block) {
+        bucket.y_min = std::min(bucket.y_min, pt.y);
+        bucket.y_max = std::max(bucket.y_max, pt.y);
+    }
+
+    block.clear();
+    push_bucket(0, bucket);
+}
+
+bool PyramidFileWriter::append(const double* x_values, const double* y_values, size_t count) {
+    if (!is_open() || finished) return false;
+
+    for (size_t i = 0; i < count; ++i) {
+        double x = x_values[i];
+        double y = y_values[i];
+
+        if (point_count == 0) {
+            min_x = max_x = x;
+            min_y = max_y = y;
+        } else {
+            if (x < max_x) {
+                std::cerr << "Error: Pyramid series X values must be non-decreasing" << std::endl;
+                failed = true;
+                return false;
+            }
+            max_x = x;
+            min_y = std::min(min_y, y);
+            max_y = std::max(max_y, y);
+        }
+
+        block.emplace_back(x, y);
+        ++point_count;
+        if (block.size() == block_points) {
+            write_block();
+            if (failed) return false;
+        }
+    }
+    return true;
+}
+
+bool PyramidFileWriter::append(const std::vector<double>& x_values, const std::vector<double>& y_values) {
+    if (x_values.size() != y_values.size()) {
+        std::cerr << "Error: X and Y vectors must have the same size" << std::endl;
+        return false;
+    }
+    return append(x_values.data(), y_values.data(), x_values.size());
+}
+
+bool PyramidFileWriter::finish() {
+    if (finished) return !failed;
+    PLOTLIB_TRACE_SCOPE("write_pyramid_levels", "io");
+    finished = true;
+    if (!file) return false;
+
+    write_block();
+
+    // Flush partial buckets upwards until a level holds a single bucket
+    size_t level_count = 0;
+    for (size_t level = 0; level < levels.size() && !failed; ++level) {
+        level_count = level + 1;
+        if (levels[level].entries <= 1) break;
+
+        LevelState& next = levels[level + 1];
+        if (next.partial_count > 0) {
+            PyramidBucket complete = next.partial;
+            next.partial_count = 0;
+            push_bucket(level + 1, complete);
+        }
+    }
+
+    PyramidFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, PYRAMID_MAGIC, sizeof(header.magic));
+    header.version = PYRAMID_VERSION;
+    header.block_points = block_points;
+    header.fanout = fanout;
+    header.level_count = static_cast<uint32_t>(level_count);
+    header.point_count = point_count;
+    header.min_x = min_x;
+    header.max_x = max_x;
+    header.min_y = min_y;
+    header.max_y = max_y;
+    header.raw_offset = align_offset(sizeof(PyramidFileHeader));
+
+    // Copy each level from its temporary file to an aligned section of the output
+    uint64_t offset = header.raw_offset + point_count * sizeof(Point2D);
+    std::vector<char> copy_buffer(1 << 16);
+    for (size_t level = 0; level < level_count && !failed; ++level) {
+        offset = align_offset(offset);
+        if (!pad_to(file, offset)) {
+            failed = true;
+            break;
+        }
+        header.level_offsets[level] = offset;
+        header.level_sizes[level] = levels[level].entries;
+
+        FILE* temp = levels[level].file;
+        std::rewind(temp);
+        size_t bytes;
+        while ((bytes = std::fread(copy_buffer.data(), 1, copy_buffer.size(), temp)) > 0) {
+            if (std::fwrite(copy_buffer.data(), 1, bytes, file) != bytes) {
+                failed = true;
+                break;
+            }
+        }
+        offset += levels[level].entries * sizeof(PyramidBucket);
+    }
+    close_temporaries();
+
+    if (!failed) {
+        failed = std::fseek(file, 0, SEEK_SET) != 0 ||
+                 std::fwrite(&header, sizeof(header), 1, file) != 1;
+    }
+    if (std::fclose(file) != 0) {
+        failed = true;
+    }
+    file = nullptr;
+
+    if (failed) {
+        std::cerr << "Error: Failed writing pyramid file '" << filename << "'" << std::endl;
+    }
+    return !failed;
+}
+
+// SeriesPyramid implementation
+
+SeriesPyramid::~SeriesPyramid() {
+    if (mapping) {
+        munmap(const_cast<unsigned char*>(mapping), mapping_size);
+    }
+}
+
+std::shared_ptr<SeriesPyramid> SeriesPyramid::open(const std::string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot open pyramid file '" << filename << "'" << std::endl;
+        return nullptr;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(PyramidFileHeader)) {
+        std::cerr << "Error: '" << filename << "' is not a pyramid file" << std::endl;
+        ::close(fd);
+        return nullptr;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        std::cerr << "Error: Cannot map pyramid file '" << filename << "'" << std::endl;
+        return nullptr;
+    }
+
+    std::shared_ptr<SeriesPyramid> pyramid(new SeriesPyramid());
+    pyramid->mapping = static_cast<const unsigned char*>(address);
+    pyramid->mapping_size = size;
+#ifdef __APPLE__
+    pyramid->modified_ns = static_cast<int64_t>(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+    pyramid->modified_ns = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+    pyramid->header = reinterpret_cast<const PyramidFileHeader*>(address);
+
+    // Validate the header against the actual file size before trusting any offset
+    const PyramidFileHeader& header = *pyramid->header;
+    bool valid = std::memcmp(header.magic, PYRAMID_MAGIC, sizeof(header.magic)) == 0 &&
+                 header.version == PYRAMID_VERSION &&
+                 header.block_points > 0 && header.fanout > 1 &&
+                 header.level_count <= static_cast<uint32_t>(PyramidFileHeader::MAX_LEVELS) &&
+                 header.raw_offset <= size &&
+                 header.point_count <= (size - header.raw_offset) / sizeof(Point2D);
+    for (uint32_t level = 0; valid && level < header.level_count; ++level) {
+        valid = header.level_offsets[level] <= size &&
+                header.level_sizes[level] <= (size - header.level_offsets[level]) / sizeof(PyramidBucket);
+    }
+    if (!valid) {
+        std::cerr << "Error: '" << filename << "' is not a valid pyramid file" << std::endl;
+        return nullptr;
+    }
+
+    return pyramid;
+}
+
+bool SeriesPyramid::write(const std::string& filename, const std::vector<Point2D>& points,
+                          uint32_t block_points, uint32_t fanout) {
+    PyramidFileWriter writer(filename, block_points, fanout);
+    if (!writer.is_open()) return false;
+
+    std::vector<double> x_chunk, y_chunk;
+    const size_t chunk_size = 1 << 16;
+    for (size_t start = 0; start < points.size(); start += chunk_size) {
+        size_t end = std::min(points.size(), start + chunk_size);
+        x_chunk.clear();
+        y_chunk.clear();
+        for (size_t i = start; i < end; ++i) {
+            x_chunk.push_back(points[i].x);
+            y_chunk.push_back(points[i].y);
+        }
+        if (!writer.append(x_chunk, y_chunk)) return false;
+    }
+    return writer.finish();
+}
+
+uint64_t SeriesPyramid::level_span(uint32_t level) const {
+    uint64_t span = header->block_points;
+    for (uint32_t i = 0; i < level; ++i) {
+        span *= header->fanout;
+    }
+    return span;
+}
+
+uint64_t SeriesPyramid::lower_bound(double value) const {
+    const Point2D* points = raw_points();
+    const Point2D* found = std::lower_bound(points, points + header->point_count, value,
+                                            [](const Point2D& pt, double x) { return pt.x < x; });
+    return static_cast<uint64_t>(found - points);
+}
+
+} // namespace plotlib
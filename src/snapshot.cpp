@@ -0,0 +1,580 @@
+#include "snapshot.h"
+#include "histogram_plot.h"
+#include "line_plot.h"
+#include "scatter_plot.h"
+#include "trace.h"
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace plotlib {
+
+namespace {
+
+const char SNAPSHOT_MAGIC[8] = {'P', 'L', 'S', 'N', 'A', 'P', '0', '1'};
+constexpr uint32_t SNAPSHOT_CONTENT_PLOT = 1;      ///< One plot record follows the header
+constexpr uint32_t SNAPSHOT_CONTENT_SUBPLOTS = 2;  ///< A SubplotManager grid follows the header
+constexpr size_t SNAPSHOT_HEADER_SIZE = sizeof(SNAPSHOT_MAGIC) + 2 * sizeof(uint32_t);
+
+// 64-bit multiply-rotate hash with four independent lanes for long columns
+constexpr uint64_t HASH_PRIME_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t HASH_PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t HASH_PRIME_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t HASH_PRIME_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t HASH_PRIME_5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotate_left(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t read_word(const unsigned char* bytes) {
+    uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+inline uint64_t hash_round(uint64_t accumulator, uint64_t input) {
+    accumulator += input * HASH_PRIME_2;
+    return rotate_left(accumulator, 31) * HASH_PRIME_1;
+}
+
+uint64_t hash_bytes(const unsigned char* data, size_t size, uint64_t seed) {
+    const unsigned char* position = data;
+    const unsigned char* end = data + size;
+    uint64_t hash;
+    if (size >= 32) {
+        uint64_t lanes[4] = {seed + HASH_PRIME_1 + HASH_PRIME_2, seed + HASH_PRIME_2, seed, seed - HASH_PRIME_1};
+        for (; end - position >= 32; position += 32) {
+            lanes[0] = hash_round(lanes[0], read_word(position));
+            lanes[1] = hash_round(lanes[1], read_word(position + 8));
+            lanes[2] = hash_round(lanes[2], read_word(position + 16));
+            lanes[3] = hash_round(lanes[3], read_word(position + 24));
+        }
+        hash = rotate_left(lanes[0], 1) + rotate_left(lanes[1], 7) + rotate_left(lanes[2], 12) + rotate_left(lanes[3], 18);
+    } else {
+        hash = seed + HASH_PRIME_5;
+    }
+    hash += size;
+    for (; end - position >= 8; position += 8) {
+        hash ^= hash_round(0, read_word(position));
+        hash = rotate_left(hash, 27) * HASH_PRIME_1 + HASH_PRIME_4;
+    }
+    for (; position < end; ++position) {
+        hash ^= *position * HASH_PRIME_5;
+        hash = rotate_left(hash, 11) * HASH_PRIME_1;
+    }
+    hash ^= hash >> 33;
+    hash *= HASH_PRIME_2;
+    hash ^= hash >> 29;
+    hash *= HASH_PRIME_3;
+    return hash ^ (hash >> 32);
+}
+
+/**
+ * @brief Read-only mapping of a snapshot file
+ */
+class MappedSnapshot {
+private:
+    const unsigned char* mapping = nullptr;
+    size_t mapping_size = 0;
+
+public:
+    explicit MappedSnapshot(const std::string& filename) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Error: Cannot open snapshot file '" << filename << "'" << std::endl;
+            return;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < SNAPSHOT_HEADER_SIZE) {
+            std::cerr << "Error: '" << filename << "' is not a snapshot file" << std::endl;
+            ::close(fd);
+            return;
+        }
+        size_t size = static_cast<size_t>(info.st_size);
+        void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (address == MAP_FAILED) {
+            std::cerr << "Error: Cannot map snapshot file '" << filename << "'" << std::endl;
+            return;
+        }
+        mapping = static_cast<const unsigned char*>(address);
+        mapping_size = size;
+    }
+
+    ~MappedSnapshot() {
+        if (mapping) munmap(const_cast<unsigned char*>(mapping), mapping_size);
+    }
+
+    MappedSnapshot(const MappedSnapshot&) = delete;
+    MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+
+    bool is_open() const { return mapping != nullptr; }
+    const unsigned char* data() const { return mapping; }
+    size_t size() const { return mapping_size; }
+};
+
+void write_header(SnapshotWriter& writer, uint32_t content) {
+    uint64_t magic;
+    std::memcpy(&magic, SNAPSHOT_MAGIC, sizeof(magic));
+    writer.put_u64(magic);
+    writer.put_u32(SNAPSHOT_VERSION);
+    writer.put_u32(content);
+}
+
+bool read_header(SnapshotReader& reader, uint32_t content, const std::string& filename) {
+    uint64_t magic = reader.get_u64();
+    uint32_t version = reader.get_u32();
+    uint32_t file_content = reader.get_u32();
+    if (std::memcmp(&magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0 || version != SNAPSHOT_VERSION) {
+        std::cerr << "Error: '" << filename << "' is not a snapshot file" << std::endl;
+        return false;
+    }
+    if (file_content != content) {
+        std::cerr << "Error: Snapshot '" << filename << "' holds a "
+                  << (file_content == SNAPSHOT_CONTENT_SUBPLOTS ? "subplot figure" : "single plot") << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Finish a snapshot file, reporting write errors
+ */
+bool close_snapshot(FILE* file, const SnapshotWriter& writer, const std::string& filename) {
+    bool ok = writer.ok();
+    if (std::fclose(file) != 0) ok = false;
+    if (!ok) {
+        std::cerr << "Error: Failed writing snapshot file '" << filename << "'" << std::endl;
+    }
+    return ok;
+}
+
+} // anonymous namespace
+
+// SnapshotWriter implementation
+
+void SnapshotWriter::put_bytes(const void* data, size_t size) {
+    if (failed || size == 0) return;
+    if (!file) {
+        // Chain each field into the running hash; counts precede arrays, so field boundaries are unambiguous
+        hash = hash_bytes(static_cast<const unsigned char*>(data), size, hash);
+    } else if (std::fwrite(data, 1, size, file) != size) {
+        failed = true;
+        return;
+    }
+    offset += size;
+}
+
+void SnapshotWriter::align(size_t alignment) {
+    static const unsigned char zeros[8] = {};
+    size_t padding = (alignment - offset % alignment) % alignment;
+    put_bytes(zeros, padding);
+}
+
+void SnapshotWriter::put_string(const std::string& value) {
+    put_u64(value.size());
+    put_bytes(value.data(), value.size());
+}
+
+void SnapshotWriter::put_style(const PlotStyle& style) {
+    put_f64(style.point_size);
+    put_f64(style.line_width);
+    put_f64(style.r);
+    put_f64(style.g);
+    put_f64(style.b);
+    put_f64(style.alpha);
+    put_string(style.label);
+}
+
+void SnapshotWriter::put_column(const DataColumn& column) {
+    if (file && !column.empty()) {
+        auto inserted = written_columns.emplace(column.data(), written_columns.size() + 1);
+        if (!inserted.second) {
+            put_u64(inserted.first->second);
+            return;
+        }
+    }
+    put_u64(0);
+    put_array(column.vector());
+}
+
+// SnapshotReader implementation
+
+const unsigned char* SnapshotReader::take(size_t bytes) {
+    if (failed || bytes > size - offset) {
+        failed = true;
+        return nullptr;
+    }
+    const unsigned char* position = data + offset;
+    offset += bytes;
+    return position;
+}
+
+void SnapshotReader::align(size_t alignment) {
+    take((alignment - offset % alignment) % alignment);
+}
+
+uint32_t SnapshotReader::get_u32() {
+    uint32_t value = 0;
+    if (const unsigned char* bytes = take(sizeof(value))) std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+uint64_t SnapshotReader::get_u64() {
+    uint64_t value = 0;
+    if (const unsigned char* bytes = take(sizeof(value))) std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+double SnapshotReader::get_f64() {
+    double value = 0.0;
+    if (const unsigned char* bytes = take(sizeof(value))) std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+std::string SnapshotReader::get_string() {
+    uint64_t length = get_u64();
+    if (failed || length > size - offset) {
+        failed = true;
+        return std::string();
+    }
+    const unsigned char* bytes = take(length);
+    return std::string(reinterpret_cast<const char*>(bytes), length);
+}
+
+PlotStyle SnapshotReader::get_style() {
+    PlotStyle style;
+    style.point_size = get_f64();
+    style.line_width = get_f64();
+    style.r = get_f64();
+    style.g = get_f64();
+    style.b = get_f64();
+    style.alpha = get_f64();
+    style.label = get_string();
+    return style;
+}
+
+DataColumn SnapshotReader::get_column() {
+    uint64_t reference = get_u64();
+    if (reference > 0) {
+        if (reference > columns.size()) {
+            failed = true;
+            return DataColumn();
+        }
+        return columns[reference - 1];
+    }
+
+    std::vector<double> values;
+    get_array(values);
+    DataColumn column(std::move(values));
+    if (!column.empty()) columns.push_back(column);
+    return column;
+}
+
+uint64_t SnapshotReader::get_count(size_t min_record_size) {
+    uint64_t count = get_u64();
+    if (failed || count > (size - offset) / min_record_size) {
+        failed = true;
+        return 0;
+    }
+    return count;
+}
+
+// PlotManager snapshot support
+
+SnapshotPlotType PlotManager::snapshot_type() const {
+    return SnapshotPlotType::NONE;
+}
+
+void PlotManager::write_snapshot(SnapshotWriter& writer) const {
+    writer.put_u32(static_cast<uint32_t>(width));
+    writer.put_u32(static_cast<uint32_t>(height));
+    writer.put_f64(margin_left);
+    writer.put_f64(margin_right);
+    writer.put_f64(margin_top);
+    writer.put_f64(margin_bottom);
+
+    writer.put_string(title);
+    writer.put_string(x_label);
+    writer.put_string(y_label);
+
+    writer.put_bool(bounds_set);
+    if (bounds_set) {
+        writer.put_f64(min_x);
+        writer.put_f64(max_x);
+        writer.put_f64(min_y);
+        writer.put_f64(max_y);
+        // The plot's own range, which a subplot falls back to when axes stop being shared
+        writer.put_f64(data_min_x);
+        writer.put_f64(data_max_x);
+        writer.put_f64(data_min_y);
+        writer.put_f64(data_max_y);
+    }
+
+    writer.put_bool(show_legend);
+    writer.put_u64(hidden_legend_items.size());
+    for (const auto& item : hidden_legend_items) {
+        writer.put_string(item);
+    }
+    writer.put_u32(static_cast<uint32_t>(render_quality));
+    writer.put_bool(show_x_tick_labels);
+    writer.put_bool(show_y_tick_labels);
+
+    writer.put_u64(data_series.size());
+    for (const auto& series : data_series) {
+        writer.put_string(series.name);
+        writer.put_style(series.style);
+        writer.put_column(series.x);
+        writer.put_column(series.y);
+    }
+
+    writer.put_u64(reference_lines.size());
+    for (const auto& line : reference_lines) {
+        writer.put_bool(line.is_vertical);
+        writer.put_f64(line.value);
+        writer.put_style(line.style);
+        writer.put_string(line.label);
+    }
+
+    writer.put_u64(annotations.size());
+    for (const auto& annotation : annotations) {
+        writer.put_f64(annotation.x);
+        writer.put_f64(annotation.y);
+        writer.put_style(annotation.style);
+        writer.put_string(annotation.text);
+    }
+}
+
+bool PlotManager::read_snapshot(SnapshotReader& reader) {
+    int snapshot_width = static_cast<int>(reader.get_u32());
+    int snapshot_height = static_cast<int>(reader.get_u32());
+    if (snapshot_width <= 0 || snapshot_height <= 0) {
+        reader.fail();
+        return false;
+    }
+    width = snapshot_width;
+    height = snapshot_height;
+    margin_left = reader.get_f64();
+    margin_right = reader.get_f64();
+    margin_top = reader.get_f64();
+    margin_bottom = reader.get_f64();
+
+    title = reader.get_string();
+    x_label = reader.get_string();
+    y_label = reader.get_string();
+
+    bounds_set = reader.get_bool();
+    if (bounds_set) {
+        min_x = reader.get_f64();
+        max_x = reader.get_f64();
+        min_y = reader.get_f64();
+        max_y = reader.get_f64();
+        data_min_x = reader.get_f64();
+        data_max_x = reader.get_f64();
+        data_min_y = reader.get_f64();
+        data_max_y = reader.get_f64();
+    }
+
+    show_legend = reader.get_bool();
+    hidden_legend_items.clear();
+    uint64_t hidden_count = reader.get_count(sizeof(uint64_t));
+    for (uint64_t i = 0; i < hidden_count; ++i) {
+        hidden_legend_items.insert(reader.get_string());
+    }
+    uint32_t quality = reader.get_u32();
+    if (quality > static_cast<uint32_t>(RenderQuality::DRAFT)) reader.fail();
+    render_quality = static_cast<RenderQuality>(quality);
+    show_x_tick_labels = reader.get_bool();
+    show_y_tick_labels = reader.get_bool();
+
+    data_series.clear();
+    uint64_t series_count = reader.get_count(sizeof(uint64_t));
+    data_series.reserve(series_count);
+    for (uint64_t i = 0; i < series_count && reader.ok(); ++i) {
+        DataSeries series(reader.get_string());
+        series.style = reader.get_style();
+        series.x = reader.get_column();
+        series.y = reader.get_column();
+        if (series.x.size() != series.y.size()) reader.fail();
+        data_series.push_back(std::move(series));
+    }
+
+    reference_lines.clear();
+    uint64_t line_count = reader.get_count(sizeof(uint32_t));
+    reference_lines.reserve(line_count);
+    for (uint64_t i = 0; i < line_count && reader.ok(); ++i) {
+        bool is_vertical = reader.get_bool();
+        double value = reader.get_f64();
+        PlotStyle style = reader.get_style();
+        // Assign the style after construction so the default-style substitution does not apply
+        ReferenceLine line(is_vertical, value, reader.get_string());
+        line.style = style;
+        reference_lines.push_back(std::move(line));
+    }
+
+    annotations.clear();
+    uint64_t annotation_count = reader.get_count(2 * sizeof(double));
+    annotations.reserve(annotation_count);
+    for (uint64_t i = 0; i < annotation_count && reader.ok(); ++i) {
+        double x = reader.get_f64();
+        double y = reader.get_f64();
+        PlotStyle style = reader.get_style();
+        annotations.emplace_back(x, y, reader.get_string(), style);
+    }
+
+    mark_modified();
+    return reader.ok();
+}
+
+std::unique_ptr<PlotManager> PlotManager::read_snapshot_plot(SnapshotPlotType type, SnapshotReader& reader) {
+    std::unique_ptr<PlotManager> plot;
+    switch (type) {
+        case SnapshotPlotType::SCATTER:
+            plot = std::make_unique<ScatterPlot>();
+            break;
+        case SnapshotPlotType::LINE:
+            plot = std::make_unique<LinePlot>();
+            break;
+        case SnapshotPlotType::HISTOGRAM:
+            plot = std::make_unique<HistogramPlot>();
+            break;
+        default:
+            reader.fail();
+            return nullptr;
+    }
+    if (!plot->read_snapshot(reader) || !reader.ok()) {
+        reader.fail();
+        return nullptr;
+    }
+    return plot;
+}
+
+bool PlotManager::save_snapshot(const std::string& filename) const {
+    PLOTLIB_TRACE_SCOPE("save_snapshot", "io");
+    SnapshotPlotType type = snapshot_type();
+    if (type == SnapshotPlotType::NONE) {
+        std::cerr << "Error: This plot type does not support snapshots" << std::endl;
+        return false;
+    }
+
+    FILE* file = std::fopen(filename.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error: Cannot open snapshot file '" << filename << "' for writing" << std::endl;
+        return false;
+    }
+    SnapshotWriter writer(file);
+    write_header(writer, SNAPSHOT_CONTENT_PLOT);
+    writer.put_u32(static_cast<uint32_t>(type));
+    write_snapshot(writer);
+    return close_snapshot(file, writer, filename);
+}
+
+std::unique_ptr<PlotManager> PlotManager::load_snapshot(const std::string& filename) {
+    PLOTLIB_TRACE_SCOPE("load_snapshot", "io");
+    MappedSnapshot mapped(filename);
+    if (!mapped.is_open()) return nullptr;
+
+    SnapshotReader reader(mapped.data(), mapped.size());
+    if (!read_header(reader, SNAPSHOT_CONTENT_PLOT, filename)) return nullptr;
+
+    SnapshotPlotType type = static_cast<SnapshotPlotType>(reader.get_u32());
+    std::unique_ptr<PlotManager> plot = read_snapshot_plot(type, reader);
+    if (!plot) {
+        std::cerr << "Error: Snapshot '" << filename << "' is invalid" << std::endl;
+    }
+    return plot;
+}
+
+// SubplotManager snapshot support
+
+void SubplotManager::write_snapshot(SnapshotWriter& writer) const {
+    writer.put_u32(static_cast<uint32_t>(rows));
+    writer.put_u32(static_cast<uint32_t>(cols));
+    writer.put_u32(static_cast<uint32_t>(total_width));
+    writer.put_u32(static_cast<uint32_t>(total_height));
+    writer.put_f64(spacing);
+    writer.put_string(main_title);
+    writer.put_u32(static_cast<uint32_t>(render_quality));
+    writer.put_bool(share_x);
+    writer.put_bool(share_y);
+
+    for (const auto& row : subplots) {
+        for (const auto& plot : row) {
+            if (!plot) {
+                writer.put_u32(static_cast<uint32_t>(SnapshotPlotType::NONE));
+                continue;
+            }
+            writer.put_u32(static_cast<uint32_t>(plot->snapshot_type()));
+            plot->write_snapshot(writer);
+        }
+    }
+}
+
+bool SubplotManager::save_snapshot(const std::string& filename) const {
+    PLOTLIB_TRACE_SCOPE("save_snapshot", "io");
+    for (const auto& row : subplots) {
+        for (const auto& plot : row) {
+            if (plot && plot->snapshot_type() == SnapshotPlotType::NONE) {
+                std::cerr << "Error: A subplot type does not support snapshots" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    FILE* file = std::fopen(filename.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error: Cannot open snapshot file '" << filename << "' for writing" << std::endl;
+        return false;
+    }
+    SnapshotWriter writer(file);
+    write_header(writer, SNAPSHOT_CONTENT_SUBPLOTS);
+    write_snapshot(writer);
+    return close_snapshot(file, writer, filename);
+}
+
+std::unique_ptr<SubplotManager> SubplotManager::load_snapshot(const std::string& filename) {
+    PLOTLIB_TRACE_SCOPE("load_snapshot", "io");
+    MappedSnapshot mapped(filename);
+    if (!mapped.is_open()) return nullptr;
+
+    SnapshotReader reader(mapped.data(), mapped.size());
+    if (!read_header(reader, SNAPSHOT_CONTENT_SUBPLOTS, filename)) return nullptr;
+
+    int rows = static_cast<int>(reader.get_u32());
+    int cols = static_cast<int>(reader.get_u32());
+    int width = static_cast<int>(reader.get_u32());
+    int height = static_cast<int>(reader.get_u32());
+    double spacing = reader.get_f64();
+    // Every cell needs at least its type tag
+    if (!reader.ok() || rows <= 0 || cols <= 0 || width <= 0 || height <= 0 ||
+        static_cast<uint64_t>(rows) * cols > mapped.size() / sizeof(uint32_t)) {
+        std::cerr << "Error: Snapshot '" << filename << "' is invalid" << std::endl;
+        return nullptr;
+    }
+
+    auto manager = std::make_unique<SubplotManager>(rows, cols, width, height, spacing);
+    manager->main_title = reader.get_string();
+    uint32_t quality = reader.get_u32();
+    if (quality > static_cast<uint32_t>(RenderQuality::DRAFT)) reader.fail();
+    manager->render_quality = static_cast<RenderQuality>(quality);
+    manager->share_x = reader.get_bool();
+    manager->share_y = reader.get_bool();
+
+    for (int row = 0; row < rows && reader.ok(); ++row) {
+        for (int col = 0; col < cols && reader.ok(); ++col) {
+            SnapshotPlotType type = static_cast<SnapshotPlotType>(reader.get_u32());
+            if (type == SnapshotPlotType::NONE) continue;
+            manager->subplots[row][col] = PlotManager::read_snapshot_plot(type, reader);
+        }
+    }
+    if (!reader.ok()) {
+        std::cerr << "Error: Snapshot '" << filename << "' is invalid" << std::endl;
+        return nullptr;
+    }
+    return manager;
+}
+
+} // namespace plotlib
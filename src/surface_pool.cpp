@@ -0,0 +1,61 @@
+#include "surface_pool.h"
+
+namespace plotlib {
+
+SurfacePool::SurfacePool(size_t max_surfaces) : max_surfaces(max_surfaces) {
+    // Reserve up front so release() never allocates
+    free_surfaces.reserve(max_surfaces);
+}
+
+SurfacePool::~SurfacePool() {
+    clear();
+}
+
+SurfacePool& SurfacePool::instance() {
+    static SurfacePool pool;
+    return pool;
+}
+
+cairo_surface_t* SurfacePool::acquire(int width, int height) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < free_surfaces.size(); ++i) {
+            cairo_surface_t* surface = free_surfaces[i];
+            if (cairo_image_surface_get_width(surface) == width &&
+                cairo_image_surface_get_height(surface) == height) {
+                free_surfaces[i] = free_surfaces.back();
+                free_surfaces.pop_back();
+                return surface;
+            }
+        }
+    }
+    return cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+}
+
+void SurfacePool::release(cairo_surface_t* surface) {
+    if (!surface) return;
+
+    if (cairo_surface_status(surface) == CAIRO_STATUS_SUCCESS) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (free_surfaces.size() < max_surfaces) {
+            free_surfaces.push_back(surface);
+            return;
+        }
+    }
+    cairo_surface_destroy(surface);
+}
+
+void SurfacePool::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (cairo_surface_t* surface : free_surfaces) {
+        cairo_surface_destroy(surface);
+    }
+    free_surfaces.clear();
+}
+
+size_t SurfacePool::size() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return free_surfaces.size();
+}
+
+} // namespace plotlib
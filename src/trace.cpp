@@ -0,0 +1,198 @@
+#include "trace.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <vector>
+#include <unistd.h>
+
+namespace plotlib {
+namespace trace {
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    uint64_t start_us;
+    uint64_t duration_us;
+    uint32_t thread_id;
+    int arg_count;
+    const char* arg_keys[Scope::MAX_ARGS];
+    long long arg_values[Scope::MAX_ARGS];
+};
+
+struct ThreadName {
+    uint32_t thread_id;
+    std::string name;
+};
+
+std::atomic<bool> enabled{false};
+std::atomic<uint32_t> next_thread_id{1};
+std::mutex trace_mutex;
+std::vector<TraceEvent> events;       ///< Guarded by trace_mutex
+std::vector<ThreadName> thread_names; ///< Guarded by trace_mutex
+std::string trace_filename;           ///< Guarded by trace_mutex
+
+const auto clock_epoch = std::chrono::steady_clock::now();
+
+uint32_t current_thread_id() {
+    thread_local uint32_t id = next_thread_id.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+void write_json_string(FILE* file, const char* text) {
+    std::fputc('"', file);
+    for (const char* c = text; *c; ++c) {
+        unsigned char ch = static_cast<unsigned char>(*c);
+        if (ch == '"' || ch == '\\') {
+            std::fputc('\\', file);
+            std::fputc(ch, file);
+        } else if (ch < 0x20) {
+            std::fprintf(file, "\\u%04x", ch);
+        } else {
+            std::fputc(ch, file);
+        }
+    }
+    std::fputc('"', file);
+}
+
+void stop_at_exit() {
+    stop();
+}
+
+/**
+ * @brief Start tracing once if PLOTLIB_TRACE names an output file
+ */
+void init_from_environment() {
+    static const bool initialized = [] {
+        const char* filename = std::getenv("PLOTLIB_TRACE");
+        if (filename && *filename && start(filename)) {
+            std::atexit(stop_at_exit);
+        }
+        return true;
+    }();
+    (void)initialized;
+}
+
+} // namespace
+
+bool start(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    if (enabled.load()) {
+        std::cerr << "Warning: Trace already active, writing to '" << trace_filename << "'" << std::endl;
+        return false;
+    }
+    trace_filename = filename;
+    events.clear();
+    events.reserve(4096);
+    enabled.store(true);
+    return true;
+}
+
+bool stop() {
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    if (!enabled.load()) return false;
+    enabled.store(false);
+
+    FILE* file = std::fopen(trace_filename.c_str(), "w");
+    if (!file) {
+        std::cerr << "Error: Cannot open trace file '" << trace_filename << "' for writing" << std::endl;
+        events.clear();
+        return false;
+    }
+
+    long pid = static_cast<long>(getpid());
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    for (const auto& thread : thread_names) {
+        std::fprintf(file, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%ld,\"tid\":%u,\"args\":{\"name\":",
+                     first ? "" : ",\n", pid, thread.thread_id);
+        write_json_string(file, thread.name.c_str());
+        std::fprintf(file, "}}");
+        first = false;
+    }
+    for (const auto& event : events) {
+        std::fprintf(file, "%s{\"ph\":\"X\",\"name\":", first ? "" : ",\n");
+        write_json_string(file, event.name);
+        std::fprintf(file, ",\"cat\":");
+        write_json_string(file, event.category);
+        std::fprintf(file, ",\"pid\":%ld,\"tid\":%u,\"ts\":%llu,\"dur\":%llu", pid, event.thread_id,
+                     static_cast<unsigned long long>(event.start_us),
+                     static_cast<unsigned long long>(event.duration_us));
+        if (event.arg_count > 0) {
+            std::fprintf(file, ",\"args\":{");
+            for (int i = 0; i < event.arg_count; ++i) {
+                if (i > 0) std::fputc(',', file);
+                write_json_string(file, event.arg_keys[i]);
+                std::fprintf(file, ":%lld", event.arg_values[i]);
+            }
+            std::fputc('}', file);
+        }
+        std::fputc('}', file);
+        first = false;
+    }
+    std::fprintf(file, "\n]}\n");
+
+    bool success = std::fclose(file) == 0;
+    events.clear();
+    if (!success) {
+        std::cerr << "Error: Failed writing trace file '" << trace_filename << "'" << std::endl;
+    }
+    return success;
+}
+
+bool is_enabled() {
+    init_from_environment();
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void set_thread_name(const std::string& name) {
+    uint32_t thread_id = current_thread_id();
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    for (auto& thread : thread_names) {
+        if (thread.thread_id == thread_id) {
+            thread.name = name;
+            return;
+        }
+    }
+    thread_names.push_back({thread_id, name});
+}
+
+uint64_t now_us() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - clock_epoch).count());
+}
+
+Scope::Scope(const char* scope_name, const char* scope_category)
+    : name(scope_name), category(scope_category), active(is_enabled()) {
+    if (active) {
+        start_us = now_us();
+    }
+}
+
+Scope::~Scope() {
+    if (!active) return;
+
+    TraceEvent event;
+    event.name = name;
+    event.category = category;
+    event.start_us = start_us;
+    event.duration_us = now_us() - start_us;
+    event.thread_id = current_thread_id();
+    event.arg_count = arg_count;
+    for (int i = 0; i < arg_count; ++i) {
+        event.arg_keys[i] = arg_keys[i];
+        event.arg_values[i] = arg_values[i];
+    }
+
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    if (enabled.load(std::memory_order_relaxed)) {
+        events.push_back(event);
+    }
+}
+
+} // namespace trace
+} // namespace plotlib
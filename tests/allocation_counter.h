@@ -0,0 +1,56 @@
+/**
+ * @file allocation_counter.h
+ * @brief Global operator new replacement that counts heap allocations
+ *
+ * Include this header from exactly one translation unit of a test executable.
+ * Counting is off until an AllocationScope is active, so allocations made by
+ * the test framework itself are not recorded.
+ */
+
+#ifndef PLOTLIB_TESTS_ALLOCATION_COUNTER_H
+#define PLOTLIB_TESTS_ALLOCATION_COUNTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace alloc_counter {
+
+inline std::atomic<bool> counting{false};
+inline std::atomic<size_t> allocations{0};
+
+/**
+ * @brief Counts every operator new call made while the scope is alive
+ */
+class AllocationScope {
+public:
+    AllocationScope() {
+        allocations = 0;
+        counting = true;
+    }
+    ~AllocationScope() { counting = false; }
+
+    size_t count() const { return allocations.load(); }
+};
+
+inline void* allocate(std::size_t size) {
+    if (counting.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace alloc_counter
+
+void* operator new(std::size_t size) { return alloc_counter::allocate(size); }
+void* operator new[](std::size_t size) { return alloc_counter::allocate(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+#endif // PLOTLIB_TESTS_ALLOCATION_COUNTER_H
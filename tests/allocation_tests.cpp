@@ -0,0 +1,184 @@
+#include "scatter_plot.h"
+#include "line_plot.h"
+#include "histogram_plot.h"
+#include "surface_pool.h"
+#include "allocation_counter.h"
+#include <iostream>
+#include <vector>
+#include <string>
+
+// Steady-state allocation tests
+//
+// Re-rendering an unchanged plot, or one that only had points appended, must
+// not call operator new. Each case renders once to warm the caches, then counts
+// allocations of a second render_to_context into a pooled surface.
+// (Cairo's own C allocations are not counted.)
+
+// Simple test framework
+int test_count = 0;
+int passed_tests = 0;
+
+void test_assert(bool condition, const std::string& test_name) {
+    test_count++;
+    if (condition) {
+        std::cout << "✅ PASS: " << test_name << std::endl;
+        passed_tests++;
+    } else {
+        std::cout << "❌ FAIL: " << test_name << std::endl;
+    }
+}
+
+// Expose render_to_context of the plot types under test
+template<typename PlotType>
+class Renderable : public PlotType {
+public:
+    using PlotType::PlotType;
+    using PlotType::render_to_context;
+};
+
+/**
+ * @brief Render twice into the same pooled surface and count allocations of the second render
+ */
+template<typename PlotType>
+size_t count_rerender_allocations(PlotType& plot, int width, int height) {
+    cairo_surface_t* surface = plotlib::SurfacePool::instance().acquire(width, height);
+    cairo_t* cr = cairo_create(surface);
+
+    plot.render_to_context(cr);
+
+    size_t allocations;
+    {
+        alloc_counter::AllocationScope scope;
+        plot.render_to_context(cr);
+        allocations = scope.count();
+    }
+
+    cairo_destroy(cr);
+    plotlib::SurfacePool::instance().release(surface);
+    return allocations;
+}
+
+void check_rerender(size_t allocations, const std::string& name) {
+    test_assert(allocations == 0, name + " re-render allocates nothing (" + std::to_string(allocations) + " allocations)");
+}
+
+void test_scatter_rerender() {
+    Renderable<plotlib::ScatterPlot> plot(800, 600);
+    plot.set_labels("Scatter", "X", "Y");
+    plot.add_scatter({1, 2, 3, 4}, {2, 3, 1, 4}, "First series with a long name", "blue");
+    plot.add_scatter({1.5, 2.5}, {3, 2}, "Second", "red");
+    plot.add_clusters({0, 1, 2, 3, 4, 5}, {5, 4, 3, 2, 1, 0}, {0, 1, -1, 0, 1, 2});
+    plot.add_horizontal_line(2.5, "Threshold level for alerts", "orange");
+    check_rerender(count_rerender_allocations(plot, 800, 600), "Scatter plot with clusters and legend");
+}
+
+void test_line_append_rerender() {
+    Renderable<plotlib::LinePlot> plot(800, 600);
+    plot.set_labels("Streaming", "Time", "Value");
+    plot.set_default_show_markers(true);
+
+    std::vector<double> x, y;
+    for (int i = 0; i < 100; ++i) {
+        x.push_back(i);
+        y.push_back((i % 7) * 0.5);
+    }
+    plot.add_line(x, y, "Sensor A", "blue");
+    plot.add_line(x, y, "Sensor B", "green");
+    plot.add_vertical_line(50, "Deployment", "red");
+    check_rerender(count_rerender_allocations(plot, 800, 600), "Line plot");
+
+    // Appending grows the series storage but must not invalidate render caches
+    for (int i = 0; i < 10; ++i) {
+        plot.append_to_series(0, {100.0 + i}, {1.0 + i * 0.1});
+    }
+    cairo_surface_t* surface = plotlib::SurfacePool::instance().acquire(800, 600);
+    cairo_t* cr = cairo_create(surface);
+    size_t allocations;
+    {
+        alloc_counter::AllocationScope scope;
+        plot.render_to_context(cr);
+        allocations = scope.count();
+    }
+    cairo_destroy(cr);
+    plotlib::SurfacePool::instance().release(surface);
+    check_rerender(allocations, "Line plot after append");
+}
+
+void test_annotated_rerender() {
+    Renderable<plotlib::LinePlot> plot(800, 600);
+    plot.add_line({0, 1, 2, 3, 4}, {1, 3, 2, 4, 3}, "Signal", "blue");
+    const char* colors[] = {"red", "orange", "purple"};
+    for (int i = 0; i < 60; ++i) {
+        // Close together, so some labels are culled as overlapping
+        plot.add_annotation(i * 0.07, 1.0 + (i % 5) * 0.5, "Event " + std::to_string(i), colors[i % 3]);
+    }
+    check_rerender(count_rerender_allocations(plot, 800, 600), "Annotated line plot");
+}
+
+void test_histogram_rerender() {
+    Renderable<plotlib::HistogramPlot> continuous(800, 600);
+    continuous.add_histogram({1.0, 2.0, 2.5, 3.0, 3.1, 3.2, 4.0, 5.5}, "Values", "green", 6);
+    check_rerender(count_rerender_allocations(continuous, 800, 600), "Continuous histogram");
+
+    Renderable<plotlib::HistogramPlot> discrete(800, 600);
+    discrete.add_histogram({5, 12, 7}, {"Apples", "Bananas", "Cherries"});
+    discrete.add_horizontal_line(8.0, "Target", "red");
+    check_rerender(count_rerender_allocations(discrete, 800, 600), "Discrete histogram");
+}
+
+void test_empty_plot_rerender() {
+    Renderable<plotlib::ScatterPlot> plot(800, 600);
+    plot.set_labels("Nothing", "X", "Y");
+    check_rerender(count_rerender_allocations(plot, 800, 600), "Empty plot");
+}
+
+void test_subplot_rerender() {
+    plotlib::SubplotManager manager(2, 2, 1200, 900);
+    manager.set_main_title("Dashboard");
+    manager.get_subplot<plotlib::ScatterPlot>(0, 0).add_scatter({1, 2, 3}, {3, 1, 2}, "Points");
+    manager.get_subplot<plotlib::LinePlot>(0, 1).add_line({1, 2, 3}, {1, 2, 3}, "Trend");
+    manager.get_subplot<plotlib::HistogramPlot>(1, 0).add_histogram({1, 2, 2, 3, 3, 3}, "Values");
+    manager.get_subplot<plotlib::ScatterPlot>(1, 1);
+    check_rerender(count_rerender_allocations(manager, 1200, 900), "Subplot dashboard");
+}
+
+void test_buffer_rerender() {
+    plotlib::ScatterPlot plot(640, 480);
+    plot.add_scatter({1, 2, 3}, {1, 4, 9}, "Squares", "purple");
+
+    std::vector<unsigned char> pixels;
+    plot.render_to_buffer(pixels);
+
+    size_t allocations;
+    {
+        alloc_counter::AllocationScope scope;
+        plot.render_to_buffer(pixels);
+        allocations = scope.count();
+    }
+    check_rerender(allocations, "render_to_buffer");
+}
+
+int main() {
+    std::cout << "=== PlotLib Allocation Tests ===" << std::endl;
+    std::cout << "Checking steady-state re-renders...\n" << std::endl;
+
+    test_scatter_rerender();
+    test_line_append_rerender();
+    test_annotated_rerender();
+    test_histogram_rerender();
+    test_empty_plot_rerender();
+    test_subplot_rerender();
+    test_buffer_rerender();
+
+    // Print results
+    std::cout << "\n=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed_tests << "/" << test_count << " tests" << std::endl;
+
+    if (passed_tests == test_count) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ Some tests failed!" << std::endl;
+        return 1;
+    }
+}
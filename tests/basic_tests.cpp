@@ -1,10 +1,21 @@
 #include "scatter_plot.h"
 #include "line_plot.h"
 #include "histogram_plot.h"
+#include "series_pyramid.h"
+#include "trace.h"
+#include "fonts.h"
+#include "apng_writer.h"
+#include "snapshot.h"
+#include "render_cache.h"
 #include <iostream>
 #include <vector>
 #include <cassert>
 #include <filesystem>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <zlib.h>
 
 // Simple test framework
 int test_count = 0;
@@ -182,6 +193,1203 @@ void test_automatic_colors() {
     }
 }
 
+void test_pyramid_file_round_trip() {
+    try {
+        std::filesystem::create_directories("test_output");
+        const std::string pyramid_file = "test_output/test_series.plpyr";
+        
+        // Stream 100k points in chunks, as a caller with data larger than RAM would
+        {
+            plotlib::PyramidFileWriter writer(pyramid_file, 1024, 8);
+            std::vector<double> x_chunk, y_chunk;
+            for (int chunk = 0; chunk < 10; ++chunk) {
+                x_chunk.clear();
+                y_chunk.clear();
+                for (int i = 0; i < 10000; ++i) {
+                    double x = chunk * 10000 + i;
+                    x_chunk.push_back(x);
+                    y_chunk.push_back(std::sin(x * 0.001));
+                }
+                writer.append(x_chunk, y_chunk);
+            }
+            test_assert(writer.finish(), "Pyramid file writing");
+        }
+        
+        auto pyramid = plotlib::SeriesPyramid::open(pyramid_file);
+        test_assert(pyramid != nullptr, "Pyramid file mapping");
+        if (pyramid) {
+            test_assert(pyramid->point_count() == 100000, "Pyramid point count");
+            test_assert(pyramid->level_size(0) == 98 && pyramid->level_size(pyramid->level_count() - 1) == 1,
+                        "Pyramid level layout");
+            test_assert(pyramid->min_x() == 0.0 && pyramid->max_x() == 99999.0, "Pyramid bounds");
+            test_assert(pyramid->raw_points()[12345].x == 12345.0, "Pyramid raw block access");
+        }
+        
+        plotlib::LinePlot plot(400, 300);
+        test_assert(plot.add_line_pyramid(pyramid_file, "History", "blue"), "Pyramid series added to LinePlot");
+        test_assert(plot.save_png("test_output/test_pyramid.png"), "Pyramid series rendering");
+        
+        std::filesystem::remove_all("test_output");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "Pyramid file round trip");
+    }
+}
+
+void test_trace_output() {
+    try {
+        std::filesystem::create_directories("test_output");
+        const std::string trace_file = "test_output/test_trace.json";
+        
+        test_assert(plotlib::trace::start(trace_file), "Trace recording starts");
+        
+        plotlib::SubplotManager manager(1, 2, 800, 400);
+        manager.get_subplot<plotlib::ScatterPlot>(0, 0).add_scatter({1, 2, 3}, {1, 4, 9}, "Points");
+        manager.get_subplot<plotlib::HistogramPlot>(0, 1).add_histogram({1, 2, 2, 3, 3, 3}, "Values");
+        std::vector<unsigned char> png_data;
+        manager.save_png_to_buffer(png_data);
+        
+        test_assert(plotlib::trace::stop(), "Trace file written");
+        test_assert(!plotlib::trace::is_enabled(), "Trace recording stops");
+        
+        std::ifstream file(trace_file);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        std::string json = contents.str();
+        test_assert(json.find("\"traceEvents\"") != std::string::npos &&
+                    json.find("\"render_subplot\"") != std::string::npos &&
+                    json.find("\"calculate_counts\"") != std::string::npos &&
+                    json.find("\"encode_png\"") != std::string::npos &&
+                    json.find("\"tid\"") != std::string::npos,
+                    "Trace contains render, binning and encode events");
+        
+        file.close();
+        std::filesystem::remove_all("test_output");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "Trace output");
+    }
+}
+
+// Counts drawn markers and exposes the draft sampling stride
+class DraftProbe : public plotlib::ScatterPlot {
+public:
+    using plotlib::ScatterPlot::ScatterPlot;
+    using plotlib::ScatterPlot::series_stride;
+    using plotlib::ScatterPlot::DRAFT_MAX_POINTS;
+    size_t markers = 0;
+    void draw_marker(cairo_t* cr, double x, double y, plotlib::MarkerType type, double size,
+                     double r, double g, double b, double alpha) override {
+        ++markers;
+        plotlib::ScatterPlot::draw_marker(cr, x, y, type, size, r, g, b, alpha);
+    }
+};
+
+void test_render_quality() {
+    try {
+        const size_t point_count = 50000;
+        std::vector<double> x(point_count), y(point_count);
+        for (size_t i = 0; i < point_count; ++i) {
+            x[i] = static_cast<double>(i);
+            y[i] = std::sin(i * 0.01);
+        }
+        
+        DraftProbe plot(400, 300);
+        plot.set_legend_enabled(false);
+        plot.add_scatter(x, y, "Points", "blue");
+        test_assert(plot.get_render_quality() == plotlib::RenderQuality::FINAL, "Final quality is the default");
+        
+        std::vector<unsigned char> pixels;
+        // Opaque duplicates are skipped, so drawn plus skipped markers count the sampled points
+        test_assert(plot.series_stride(point_count) == 1 && plot.render_to_buffer(pixels) &&
+                    plot.markers + plot.get_skipped_marker_count() == point_count, "Final quality draws every point");
+        
+        plot.set_render_quality(plotlib::RenderQuality::DRAFT);
+        plot.markers = 0;
+        test_assert(plot.series_stride(point_count) == 3 && plot.series_stride(DraftProbe::DRAFT_MAX_POINTS) == 1 &&
+                    plot.render_to_buffer(pixels) &&
+                    plot.markers + plot.get_skipped_marker_count() == (point_count + 2) / 3,
+                    "Draft quality samples large series");
+        
+        // The figure quality reaches existing and new panels, but a panel may override it
+        plotlib::SubplotManager manager(1, 2, 800, 300);
+        auto probe = std::make_unique<DraftProbe>(800, 600);
+        probe->set_legend_enabled(false);
+        probe->add_scatter(x, y, "Points", "blue");
+        DraftProbe& panel = *probe;
+        manager.set_subplot(0, 0, std::move(probe));
+        manager.set_render_quality(plotlib::RenderQuality::DRAFT);
+        auto& added = manager.get_subplot<plotlib::LinePlot>(0, 1);
+        added.add_line({1, 2, 3}, {1, 2, 3}, "Trend");
+        test_assert(manager.get_render_quality() == plotlib::RenderQuality::DRAFT &&
+                    panel.get_render_quality() == plotlib::RenderQuality::DRAFT &&
+                    added.get_render_quality() == plotlib::RenderQuality::DRAFT, "Figure quality applies to panels");
+        
+        panel.markers = 0;
+        test_assert(manager.render_to_buffer(pixels) &&
+                    panel.markers + panel.get_skipped_marker_count() == (point_count + 2) / 3,
+                    "Subplot draft render samples panels");
+        
+        panel.set_render_quality(plotlib::RenderQuality::FINAL);
+        panel.markers = 0;
+        test_assert(manager.render_to_buffer(pixels) && panel.markers + panel.get_skipped_marker_count() == point_count &&
+                    panel.get_render_quality() == plotlib::RenderQuality::FINAL, "Panel quality overrides the figure");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "Render quality");
+    }
+}
+
+void test_progressive_render() {
+    try {
+        // A large series is refined over several passes
+        plotlib::ScatterPlot plot(400, 300);
+        std::vector<double> x, y;
+        for (int i = 0; i < 100000; ++i) {
+            x.push_back(i);
+            y.push_back((i * 37) % 1000);
+        }
+        plot.add_scatter(x, y, "Large", "blue");
+        
+        std::vector<unsigned char> pixels;
+        std::vector<int> passes;
+        int reported_count = 0;
+        bool completed = plot.render_progressive(pixels, [&](int pass, int pass_count) {
+            passes.push_back(pass);
+            reported_count = pass_count;
+            return true;
+        });
+        test_assert(completed && reported_count == 4 && passes.size() == 4 && passes.back() == 4,
+                    "Progressive render runs all passes");
+        test_assert(pixels.size() == 400u * 300u * 4u, "Progressive render fills the buffer");
+        
+        // Cancelling after the first pass stops refinement
+        int calls = 0;
+        bool cancelled_completed = plot.render_progressive(pixels, [&](int, int) {
+            ++calls;
+            return false;
+        });
+        test_assert(!cancelled_completed && calls == 1, "Progressive render can be cancelled");
+        
+        // Small plots are complete after one pass
+        plotlib::LinePlot small(400, 300);
+        small.add_line({1, 2, 3}, {1, 4, 9}, "Small");
+        int small_passes = 0;
+        test_assert(small.render_progressive(pixels, [&](int, int pass_count) {
+            small_passes = pass_count;
+            return true;
+        }) && small_passes == 1, "Small plot renders in a single pass");
+        
+        plotlib::SubplotManager manager(1, 2, 800, 300);
+        manager.get_subplot<plotlib::ScatterPlot>(0, 0).add_scatter(x, y, "Large");
+        manager.get_subplot<plotlib::LinePlot>(0, 1).add_line({1, 2, 3}, {1, 2, 3}, "Trend");
+        int subplot_passes = 0;
+        test_assert(manager.render_progressive(pixels, [&](int pass, int) {
+            subplot_passes = pass;
+            return true;
+        }) && subplot_passes == 4 && pixels.size() == 800u * 300u * 4u, "Subplot progressive render");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "Progressive render");
+    }
+}
+
+size_t count_occurrences(const std::string& text, const std::string& pattern) {
+    size_t count = 0;
+    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+void test_subplot_tile_cache() {
+    try {
+        auto build = [](plotlib::SubplotManager& manager) {
+            manager.set_main_title("Dashboard");
+            manager.get_subplot<plotlib::ScatterPlot>(0, 0).add_scatter({1, 2, 3}, {3, 1, 2}, "Points");
+            manager.get_subplot<plotlib::LinePlot>(0, 1).add_line({1, 2, 3}, {1, 2, 3}, "Trend");
+            manager.get_subplot<plotlib::HistogramPlot>(1, 0).add_histogram({1, 2, 2, 3, 3, 3}, "Values");
+            manager.get_subplot<plotlib::ScatterPlot>(1, 1);
+        };
+        
+        plotlib::SubplotManager manager(2, 2, 1200, 900);
+        build(manager);
+        std::vector<unsigned char> pixels;
+        manager.render_to_buffer(pixels);
+        
+        // Only the changed panel is redrawn
+        std::filesystem::create_directories("test_output");
+        const std::string trace_file = "test_output/test_tiles.json";
+        plotlib::trace::start(trace_file);
+        manager.get_subplot<plotlib::ScatterPlot>(0, 0).add_scatter({4, 5}, {1, 1}, "More");
+        manager.render_to_buffer(pixels);
+        plotlib::trace::stop();
+        
+        std::ifstream file(trace_file);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        std::string json = contents.str();
+        test_assert(count_occurrences(json, "\"cached\":0") == 1 && count_occurrences(json, "\"cached\":1") == 3,
+                    "Only the modified subplot is re-rendered");
+        
+        // A font change redraws every panel
+        plotlib::fonts::reset();
+        plotlib::trace::start(trace_file);
+        manager.render_to_buffer(pixels);
+        plotlib::trace::stop();
+        std::ifstream font_file(trace_file);
+        std::stringstream font_contents;
+        font_contents << font_file.rdbuf();
+        test_assert(count_occurrences(font_contents.str(), "\"cached\":0") == 4, "Font changes invalidate tiles");
+        
+        // Composited tiles match a render from scratch
+        plotlib::SubplotManager fresh(2, 2, 1200, 900);
+        build(fresh);
+        fresh.get_subplot<plotlib::ScatterPlot>(0, 0).add_scatter({4, 5}, {1, 1}, "More");
+        std::vector<unsigned char> fresh_pixels;
+        fresh.render_to_buffer(fresh_pixels);
+        test_assert(pixels == fresh_pixels, "Cached tiles match a fresh render");
+        
+        file.close();
+        std::filesystem::remove_all("test_output");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "Subplot tile cache");
+    }
+}
+
+// Exposes the axis state a SubplotManager assigns to its subplots
+class AxisProbe : public plotlib::ScatterPlot {
+public:
+    using plotlib::ScatterPlot::ScatterPlot;
+    double x_min() const { return min_x; }
+    double x_max() const { return max_x; }
+    double y_min() const { return min_y; }
+    double y_max() const { return max_y; }
+    bool x_labels() const { return show_x_tick_labels; }
+    bool y_labels() const { return show_y_tick_labels; }
+};
+
+void test_shared_axes() {
+    try {
+        plotlib::SubplotManager manager(2, 2, 1200, 900);
+        for (int row = 0; row < 2; ++row) {
+            for (int col = 0; col < 2; ++col) {
+                manager.set_subplot(row, col, std::make_unique<AxisProbe>(800, 600));
+                double scale = 1.0 + row * 2 + col;
+                manager.get_subplot<AxisProbe>(row, col).add_scatter({0, 10 * scale}, {0, scale}, "Data");
+            }
+        }
+        manager.set_sharex(true);
+        manager.set_sharey(true);
+        std::vector<unsigned char> pixels;
+        manager.render_to_buffer(pixels);
+        
+        auto& top_left = manager.get_subplot<AxisProbe>(0, 0);
+        auto& top_right = manager.get_subplot<AxisProbe>(0, 1);
+        auto& bottom_left = manager.get_subplot<AxisProbe>(1, 0);
+        auto& bottom_right = manager.get_subplot<AxisProbe>(1, 1);
+        
+        test_assert(top_left.x_min() == bottom_left.x_min() && top_left.x_max() == bottom_left.x_max() &&
+                    top_right.x_max() == bottom_right.x_max() && top_left.x_max() != top_right.x_max(),
+                    "Columns share the x range");
+        test_assert(top_left.y_max() == top_right.y_max() && bottom_left.y_max() == bottom_right.y_max() &&
+                    top_left.y_max() != bottom_left.y_max(),
+                    "Rows share the y range");
+        test_assert(!top_left.x_labels() && top_left.y_labels() && bottom_left.x_labels() &&
+                    !top_right.y_labels() && bottom_right.x_labels() && !bottom_right.y_labels(),
+                    "Only outer subplots show tick labels");
+        
+        // Turning sharing off restores each subplot's own axes
+        manager.set_sharex(false);
+        manager.set_sharey(false);
+        manager.render_to_buffer(pixels);
+        test_assert(top_left.x_max() < bottom_left.x_max() && top_left.x_labels() && top_right.y_labels(),
+                    "Unshared subplots use their own ranges and labels");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "Shared axes");
+    }
+}
+
+void test_fonts_and_warm_up() {
+    try {
+        plotlib::warm_up();
+        test_assert(!plotlib::fonts::register_font_file("no_such_font.ttf"), "Missing font file is rejected");
+        
+        // Use a system font if one is available in this environment
+        const std::string font_file = "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf";
+        if (plotlib::fonts::has_freetype() && std::filesystem::exists(font_file)) {
+            test_assert(plotlib::fonts::register_font_file(font_file), "Font file registration");
+        }
+        
+        plotlib::ScatterPlot plot(400, 300);
+        plot.set_labels("Fonts", "X", "Y");
+        plot.add_scatter({1, 2, 3}, {1, 2, 3}, "Points");
+        std::vector<unsigned char> pixels;
+        test_assert(plot.render_to_buffer(pixels), "Render with shared font faces");
+        
+        plotlib::fonts::reset();
+        test_assert(plot.render_to_buffer(pixels), "Render after font reset");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "Fonts and warm-up");
+    }
+}
+
+// Records the bars of each merged pixel-column pass
+class ColumnBarProbe : public plotlib::HistogramPlot {
+public:
+    using plotlib::HistogramPlot::HistogramPlot;
+    std::vector<std::pair<bool, size_t>> passes; ///< (use_min, bars) per call
+    size_t add_pixel_column_bars(cairo_t* cr, const plotlib::HistogramData& hist_data, double pixel_width, bool use_min) override {
+        size_t bars = plotlib::HistogramPlot::add_pixel_column_bars(cr, hist_data, pixel_width, use_min);
+        passes.emplace_back(use_min, bars);
+        return bars;
+    }
+};
+
+void test_sub_pixel_histogram() {
+    try {
+        std::vector<double> values;
+        for (int i = 0; i < 50000; ++i) {
+            values.push_back(std::sin(i * 0.37) * 3.0 + std::sin(i * 0.011));
+        }
+        
+        ColumnBarProbe plot(800, 600);
+        plot.add_histogram(values, "Fine", "blue", 20000);
+        std::vector<unsigned char> pixels;
+        test_assert(plot.render_to_buffer(pixels), "Histogram with sub-pixel bins renders");
+        
+        // At most one bar per pixel column of the 800-pixel canvas
+        test_assert(plot.passes.size() == 1 && !plot.passes[0].first &&
+                    plot.passes[0].second > 100 && plot.passes[0].second <= 800,
+                    "Sub-pixel bins are merged per pixel column");
+        
+        plot.set_bin_envelope(true);
+        plot.passes.clear();
+        test_assert(plot.render_to_buffer(pixels), "Histogram with min/max envelope renders");
+        test_assert(plot.passes.size() == 2 && !plot.passes[0].first && plot.passes[1].first &&
+                    plot.passes[1].second == plot.passes[0].second, "Envelope adds a min-count pass");
+        
+        // Bins wider than a pixel are drawn one bar each
+        ColumnBarProbe coarse(800, 600);
+        coarse.add_histogram(values, "Coarse", "blue", 50);
+        test_assert(coarse.render_to_buffer(pixels) && coarse.passes.empty(), "Wide bins are not merged");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "Sub-pixel histogram");
+    }
+}
+
+class LegendProbe : public plotlib::HistogramPlot {
+public:
+    using plotlib::HistogramPlot::HistogramPlot;
+    std::vector<plotlib::LegendItem> legend_items() {
+        std::vector<plotlib::LegendItem> items;
+        collect_legend_items(items);
+        return items;
+    }
+};
+
+void test_large_discrete_histogram() {
+    try {
+        std::vector<int> counts(50000);
+        for (size_t i = 0; i < counts.size(); ++i) {
+            counts[i] = static_cast<int>(i % 97);
+        }
+        
+        LegendProbe large(800, 600);
+        large.add_histogram(counts);
+        std::vector<unsigned char> pixels;
+        test_assert(large.render_to_buffer(pixels), "Discrete histogram with 50000 categories renders");
+        test_assert(large.legend_items().size() == 1, "Large discrete histogram has one legend entry per series");
+        
+        LegendProbe small(800, 600);
+        small.add_histogram(std::vector<int>{3, 5, 2, 7});
+        small.hide_legend_item("idx 2");
+        auto items = small.legend_items();
+        test_assert(items.size() == 3 && items[0].label == "idx 1" && items[1].label == "idx 3",
+                    "Small discrete histogram keeps per-category legend entries");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "Large discrete histogram");
+    }
+}
+
+template<typename T>
+std::vector<unsigned char> render_integer_histogram(size_t count, int modulus, int bin_count) {
+    std::vector<T> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = static_cast<T>((i * 7919) % modulus);
+    }
+    plotlib::HistogramPlot plot(400, 300);
+    plot.add_integer_histogram(values, "Values", "blue", bin_count);
+    std::vector<unsigned char> pixels;
+    plot.render_to_buffer(pixels);
+    return pixels;
+}
+
+void test_integer_histogram() {
+    try {
+        // Same values through the 8/16-bit table path and the direct-index path
+        auto small_u8 = render_integer_histogram<uint8_t>(5000, 200, 0);
+        auto small_i16 = render_integer_histogram<int16_t>(5000, 200, 0);
+        auto small_i64 = render_integer_histogram<int64_t>(5000, 200, 0);
+        test_assert(!small_u8.empty() && small_u8 == small_i16 && small_u8 == small_i64,
+                    "Integer histogram is identical for all value types");
+        
+        // Large arrays are counted in parallel
+        auto large_u16 = render_integer_histogram<uint16_t>(2000000, 1000, 50);
+        auto large_i32 = render_integer_histogram<int32_t>(2000000, 1000, 50);
+        auto large_u64 = render_integer_histogram<uint64_t>(2000000, 1000, 50);
+        test_assert(!large_u16.empty() && large_u16 == large_i32 && large_u16 == large_u64,
+                    "Parallel integer histogram is identical for all value types");
+        
+        plotlib::HistogramPlot plot(400, 300);
+        plot.add_integer_histogram(std::vector<int8_t>{-128, -1, 0, 127}, "Signed");
+        plot.add_integer_histogram(std::vector<uint64_t>{0, UINT64_MAX}, "Full range", 4);
+        std::vector<unsigned char> pixels;
+        test_assert(plot.render_to_buffer(pixels), "Integer histogram with extreme values renders");
+        
+        // A full 64-bit span in a single bin must not wrap the bin width to zero
+        plotlib::HistogramPlot full_range(400, 300);
+        full_range.add_integer_histogram(std::vector<int64_t>{INT64_MIN, 0, INT64_MAX}, "Signed 64-bit", 1);
+        full_range.add_integer_histogram(std::vector<uint64_t>{0, UINT64_MAX}, "Unsigned 64-bit", 1);
+        test_assert(full_range.render_to_buffer(pixels), "Full-range 64-bit values in one bin");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "Integer histogram");
+    }
+}
+
+uint32_t read_u32(const std::vector<unsigned char>& data, size_t offset) {
+    return (uint32_t(data[offset]) << 24) | (uint32_t(data[offset + 1]) << 16) |
+           (uint32_t(data[offset + 2]) << 8) | uint32_t(data[offset + 3]);
+}
+
+void test_apng_export() {
+    try {
+        std::filesystem::create_directories("test_output");
+        const std::string filename = "test_output/animation.png";
+        
+        plotlib::ScatterPlot plot(400, 300);
+        plot.add_scatter({0.0, 1.0, 2.0}, {0.0, 1.0, 0.5}, "Test", "red");
+        std::vector<unsigned char> pixels;
+        plot.render_to_buffer(pixels);
+        
+        // Second frame changes a 10x5 block at (100, 50); the third repeats it
+        std::vector<unsigned char> changed = pixels;
+        for (int y = 50; y < 55; ++y) {
+            for (int x = 100; x < 110; ++x) {
+                changed[(y * 400 + x) * 4] ^= 0xff;
+            }
+        }
+        
+        {
+            plotlib::ApngWriter writer(filename, 400, 300, 50);
+            test_assert(writer.is_open(), "APNG writer opens output file");
+            writer.add_frame(plot);
+            writer.add_frame(changed);
+            writer.add_frame(changed);
+            test_assert(writer.get_frame_count() == 2, "Repeated APNG frame is merged into the previous one");
+            test_assert(writer.finish(), "APNG file is finished");
+        }
+        
+        std::ifstream in(filename, std::ios::binary);
+        std::vector<unsigned char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        
+        // Walk the chunks, checking CRCs and collecting frame controls
+        bool crc_ok = data.size() > 8;
+        uint32_t frame_count = 0;
+        std::vector<size_t> frame_controls;
+        size_t offset = 8;
+        std::string last_type;
+        while (crc_ok && offset + 12 <= data.size()) {
+            uint32_t length = read_u32(data, offset);
+            std::string type(data.begin() + offset + 4, data.begin() + offset + 8);
+            uLong crc = crc32(0L, data.data() + offset + 4, length + 4);
+            crc_ok = crc == read_u32(data, offset + 8 + length);
+            if (type == "acTL") frame_count = read_u32(data, offset + 8);
+            if (type == "fcTL") frame_controls.push_back(offset + 8);
+            last_type = type;
+            offset += length + 12;
+        }
+        test_assert(crc_ok && last_type == "IEND" && offset == data.size(), "APNG chunks are well formed");
+        test_assert(frame_count == 2 && frame_controls.size() == 2, "APNG frame count is written");
+        if (frame_controls.size() == 2) {
+            size_t second = frame_controls[1];
+            test_assert(read_u32(data, second + 4) == 10 && read_u32(data, second + 8) == 5 &&
+                        read_u32(data, second + 12) == 100 && read_u32(data, second + 16) == 50,
+                        "APNG delta frame covers only the changed rectangle");
+            test_assert(data[second + 20] == 0 && data[second + 21] == 100,
+                        "Repeated APNG frame extends the delay");
+        }
+        
+        std::filesystem::remove(filename);
+        std::filesystem::remove("test_output");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "APNG export");
+    }
+}
+
+void test_html_export() {
+    try {
+        plotlib::ScatterPlot scatter(400, 300);
+        std::vector<double> x_values(3000), y_values(3000);
+        for (size_t i = 0; i < x_values.size(); ++i) {
+            x_values[i] = std::sin(i * 0.1) * i;
+            y_values[i] = std::cos(i * 0.1) * i;
+        }
+        scatter.add_scatter(x_values, y_values, "Spiral", "blue");
+        scatter.set_title("Spiral <3000 points>");
+        
+        std::string html;
+        test_assert(scatter.save_html_to_buffer(html), "Scatter plot exports HTML");
+        test_assert(html.find("<canvas") != std::string::npos && html.find("marker:'circle'") != std::string::npos,
+                    "HTML export draws scatter data on a canvas");
+        test_assert(html.find("<title>Spiral &lt;3000 points&gt;</title>") != std::string::npos,
+                    "HTML export escapes the title");
+        
+        // 3000 float32 values encode to 16000 base64 characters
+        size_t column = html.find(",x:'");
+        size_t column_end = column == std::string::npos ? column : html.find('\'', column + 4);
+        test_assert(column_end != std::string::npos && column_end - (column + 4) == 16000,
+                    "HTML export embeds float32 columns");
+        
+        plotlib::HistogramPlot histogram(400, 300);
+        histogram.add_histogram(x_values, "Values", "green", 20);
+        test_assert(histogram.save_html_to_buffer(html) && html.find("<canvas") == std::string::npos &&
+                    html.find("data:image/png;base64,") != std::string::npos,
+                    "Histogram HTML export embeds a single image");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "HTML export");
+    }
+}
+
+void test_snapshot_round_trip() {
+    try {
+        std::filesystem::create_directories("test_output");
+        const std::string plot_file = "test_output/test_plot.plsnap";
+        const std::string figure_file = "test_output/test_figure.plsnap";
+        
+        std::vector<double> x_values(5000), y_values(5000);
+        std::vector<int> labels(5000);
+        for (size_t i = 0; i < x_values.size(); ++i) {
+            x_values[i] = std::sin(i * 0.01) * i;
+            y_values[i] = std::cos(i * 0.01) * i;
+            labels[i] = static_cast<int>(i % 4) - 1;
+        }
+        
+        plotlib::SubplotManager figure(2, 2, 800, 600);
+        figure.set_main_title("Dashboard");
+        figure.set_sharex(true);
+        auto& scatter = figure.get_subplot<plotlib::ScatterPlot>(0, 0);
+        scatter.add_clusters(x_values, y_values, labels, {"Noise", "A", "B", "C"});
+        scatter.add_vertical_line(10.0, "Threshold", "red");
+        scatter.hide_legend_item("B");
+        auto& line = figure.get_subplot<plotlib::LinePlot>(0, 1);
+        line.add_line(x_values, y_values, "Spiral", "green");
+        line.set_bounds(-100, 100, -100, 100);
+        std::vector<int> counts(300);
+        for (size_t i = 0; i < counts.size(); ++i) counts[i] = static_cast<int>(i * 7 % 50);
+        figure.get_subplot<plotlib::HistogramPlot>(1, 0).add_histogram(counts);
+        
+        std::vector<unsigned char> expected, actual;
+        test_assert(figure.render_to_buffer(expected), "Render figure before snapshot");
+        test_assert(figure.save_snapshot(figure_file), "Save figure snapshot");
+        auto restored = plotlib::SubplotManager::load_snapshot(figure_file);
+        test_assert(restored != nullptr && restored->get_rows() == 2 && restored->get_sharex(),
+                    "Load figure snapshot");
+        test_assert(restored && restored->render_to_buffer(actual) && actual == expected,
+                    "Restored figure renders identically");
+        
+        plotlib::HistogramPlot histogram(400, 300);
+        histogram.set_labels("Values", "Value", "Count");
+        histogram.add_histogram(x_values, "Values", "purple", 25);
+        test_assert(histogram.render_to_buffer(expected) && histogram.save_snapshot(plot_file),
+                    "Save plot snapshot");
+        auto plot = plotlib::PlotManager::load_snapshot(plot_file);
+        test_assert(dynamic_cast<plotlib::HistogramPlot*>(plot.get()) != nullptr, "Load plot snapshot type");
+        test_assert(plot && plot->render_to_buffer(actual) && actual == expected,
+                    "Restored plot renders identically");
+        
+        test_assert(plotlib::PlotManager::load_snapshot(figure_file) == nullptr &&
+                    plotlib::SubplotManager::load_snapshot(plot_file) == nullptr,
+                    "Snapshot content kind is checked");
+        std::filesystem::resize_file(plot_file, std::filesystem::file_size(plot_file) / 2);
+        test_assert(plotlib::PlotManager::load_snapshot(plot_file) == nullptr, "Truncated snapshot is rejected");
+        
+        // Cells with computed bounds keep their own ranges after a reload, shared or not
+        plotlib::SubplotManager grid(1, 2, 800, 400);
+        grid.get_subplot<plotlib::LinePlot>(0, 0).add_line({1, 2, 3, 4}, {1, 4, 2, 3}, "Small", "blue");
+        grid.get_subplot<plotlib::LinePlot>(0, 1).add_line({10, 20, 30, 40}, {10, 40, 20, 30}, "Large", "red");
+        test_assert(grid.render_to_buffer(expected) && grid.save_snapshot(figure_file), "Save grid snapshot");
+        auto reloaded = plotlib::SubplotManager::load_snapshot(figure_file);
+        test_assert(reloaded && reloaded->render_to_buffer(actual) && actual == expected,
+                    "Restored grid renders identically");
+        bool ranges_match = reloaded != nullptr;
+        for (int col = 0; col < 2 && reloaded; ++col) {
+            for (bool x_axis : {true, false}) {
+                double min_before, max_before, min_after, max_after;
+                grid.get_subplot<plotlib::LinePlot>(0, col).get_axis_range(x_axis, min_before, max_before);
+                reloaded->get_subplot<plotlib::LinePlot>(0, col).get_axis_range(x_axis, min_after, max_after);
+                ranges_match = ranges_match && min_before == min_after && max_before == max_after &&
+                               max_after > min_after;
+            }
+        }
+        test_assert(ranges_match, "Restored grid keeps each panel's axis ranges");
+        if (reloaded) {
+            reloaded->set_sharey(true);
+            reloaded->set_sharey(false);
+            double min_y = 0, max_y = 0;
+            reloaded->render_to_buffer(actual);
+            reloaded->get_subplot<plotlib::LinePlot>(0, 1).get_axis_range(false, min_y, max_y);
+            test_assert(min_y == 8.5 && max_y == 41.5, "Unsharing a restored axis returns to the panel's own range");
+        }
+        
+        std::filesystem::remove(plot_file);
+        std::filesystem::remove(figure_file);
+        std::filesystem::remove("test_output");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "Snapshot round trip");
+    }
+}
+
+void test_render_cache() {
+    try {
+        const std::string cache_dir = "test_output/render_cache";
+        std::filesystem::remove_all(cache_dir);
+        auto cache = std::make_shared<plotlib::RenderCache>(64u << 20, cache_dir, 16u << 20);
+        
+        std::vector<double> values(20000);
+        for (size_t i = 0; i < values.size(); ++i) values[i] = std::sin(i * 0.37) * 50.0 + (i % 13);
+        plotlib::HistogramPlot first(400, 300);
+        first.set_render_cache(cache);
+        first.add_histogram(values, "Values", "blue", 30);
+        
+        std::vector<unsigned char> rendered, cached;
+        test_assert(first.save_png_to_buffer(rendered) && first.save_png_to_buffer(cached) && cached == rendered,
+                    "Cached PNG matches the rendered PNG");
+        auto stats = cache->get_stats();
+        test_assert(stats.misses == 1 && stats.memory_hits == 1, "Second identical render is a memory hit");
+        
+        // Keys depend on content, not on the plot instance
+        plotlib::HistogramPlot second(400, 300);
+        second.set_render_cache(cache);
+        second.add_histogram(values, "Values", "blue", 30);
+        test_assert(second.save_png_to_buffer(cached) && cached == rendered && cache->get_stats().memory_hits == 2,
+                    "Identical plot state shares cache entries");
+        second.set_title("Changed");
+        test_assert(second.save_png_to_buffer(cached) && cache->get_stats().misses == 2,
+                    "Changed plot state misses the cache");
+        std::string svg;
+        test_assert(first.save_svg_to_buffer(svg) && cache->get_stats().misses == 3, "Formats are cached separately");
+        
+        // A new cache over the same directory serves earlier renders from disk
+        auto reopened = std::make_shared<plotlib::RenderCache>(64u << 20, cache_dir, 16u << 20);
+        first.set_render_cache(reopened);
+        test_assert(first.save_png_to_buffer(cached) && cached == rendered && reopened->get_stats().disk_hits == 1,
+                    "Disk tier survives the cache instance");
+        
+        // Entries of another library or snapshot version are never served, but still count towards the limit
+        for (const auto& entry : std::filesystem::directory_iterator(cache_dir)) {
+            std::string name = entry.path().filename().string();
+            std::filesystem::rename(entry.path(), cache_dir + "/plc-0.9.0-s6-" + name.substr(name.rfind('-') + 1));
+        }
+        auto upgraded = std::make_shared<plotlib::RenderCache>(64u << 20, cache_dir, 16u << 20);
+        size_t stale_bytes = upgraded->get_stats().disk_bytes;
+        first.set_render_cache(upgraded);
+        test_assert(stale_bytes > 0 && first.save_png_to_buffer(cached) && cached == rendered &&
+                    upgraded->get_stats().disk_hits == 0 && upgraded->get_stats().misses == 1,
+                    "Other versions' disk entries are not served");
+        upgraded->clear();
+        first.set_render_cache(cache);
+        
+        // Tier limits
+        auto small = std::make_shared<plotlib::RenderCache>(rendered.size() - 1, cache_dir + "_small", rendered.size());
+        first.set_render_cache(small);
+        first.save_png_to_buffer(cached);
+        second.save_png_to_buffer(cached);
+        stats = small->get_stats();
+        test_assert(stats.memory_bytes == 0 && stats.disk_bytes <= rendered.size(), "Cache tiers respect size limits");
+        
+        plotlib::SubplotManager figure(1, 2, 600, 300);
+        figure.set_render_cache(cache);
+        figure.get_subplot<plotlib::HistogramPlot>(0, 0).add_histogram(values, "Values", "green", 20);
+        std::vector<unsigned char> pixels, cached_pixels;
+        test_assert(figure.render_to_buffer(pixels) && figure.render_to_buffer(cached_pixels) && pixels == cached_pixels,
+                    "Figure render buffers are cached");
+        
+        // Rewriting a pyramid file under the same name changes the key
+        const std::string pyramid_file = "test_output/cached.plpyr";
+        std::vector<plotlib::Point2D> points(5000);
+        for (size_t i = 0; i < points.size(); ++i) points[i] = plotlib::Point2D(i, std::sin(i * 0.01));
+        plotlib::SeriesPyramid::write(pyramid_file, points);
+        plotlib::LinePlot before(400, 300);
+        before.set_render_cache(cache);
+        before.add_line_pyramid(pyramid_file, "History", "blue");
+        size_t misses = cache->get_stats().misses;
+        test_assert(before.save_png_to_buffer(cached) && cache->get_stats().misses == misses + 1,
+                    "Pyramid plot is rendered once");
+        for (auto& point : points) point.y = -point.y;
+        plotlib::SeriesPyramid::write(pyramid_file, points);
+        plotlib::LinePlot after(400, 300);
+        after.set_render_cache(cache);
+        after.add_line_pyramid(pyramid_file, "History", "blue");
+        test_assert(after.save_png_to_buffer(cached) && cache->get_stats().misses == misses + 2,
+                    "Rewritten pyramid file misses the cache");
+        std::filesystem::remove(pyramid_file);
+        
+        small->clear();
+        cache->clear();
+        test_assert(cache->get_stats().disk_bytes == 0 && cache->get_stats().memory_bytes == 0, "Cache clear");
+        std::filesystem::remove_all(cache_dir);
+        std::filesystem::remove_all(cache_dir + "_small");
+        std::filesystem::remove("test_output");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "Render cache");
+    }
+}
+
+void test_shared_data_columns() {
+    try {
+        std::filesystem::create_directories("test_output");
+        const size_t count = 10000;
+        std::vector<double> timestamps(count), cpu(count), memory(count);
+        for (size_t i = 0; i < count; ++i) {
+            timestamps[i] = static_cast<double>(i);
+            cpu[i] = std::sin(i * 0.01) * 40.0 + 50.0;
+            memory[i] = std::cos(i * 0.02) * 20.0 + 60.0;
+        }
+        plotlib::DataColumn time(std::move(timestamps));
+        plotlib::DataColumn cpu_column(cpu);
+        
+        plotlib::LinePlot line(400, 300);
+        line.add_line(time, cpu_column, "CPU", "blue");
+        line.add_line(time, plotlib::DataColumn(memory), "Memory", "red");
+        plotlib::ScatterPlot scatter(400, 300);
+        scatter.add_scatter(time, cpu_column, "CPU");
+        plotlib::HistogramPlot histogram(400, 300);
+        histogram.add_histogram(cpu_column, "CPU", "blue", 20);
+        test_assert(time.use_count() == 4 && cpu_column.use_count() == 4,
+                    "Series and plots share column storage");
+        
+        // Streaming appends detach the series from the shared column
+        plotlib::LinePlot streaming(400, 300);
+        streaming.add_line(time, cpu_column, "CPU", "blue");
+        test_assert(streaming.append_to_series(0, {1e6}, {1.0}) && time.use_count() == 4 && time.size() == count,
+                    "Appending to a shared column leaves other holders unchanged");
+        
+        // Shared columns are stored once and stay shared on load
+        const std::string shared_file = "test_output/shared_columns.plsnap";
+        const std::string copied_file = "test_output/copied_columns.plsnap";
+        std::vector<unsigned char> expected, actual;
+        test_assert(line.render_to_buffer(expected) && line.save_snapshot(shared_file), "Save shared column snapshot");
+        plotlib::LinePlot copied(400, 300);
+        copied.add_line(plotlib::DataColumn(time.vector()), cpu_column, "CPU", "blue");
+        copied.add_line(plotlib::DataColumn(time.vector()), plotlib::DataColumn(memory), "Memory", "red");
+        test_assert(copied.save_snapshot(copied_file), "Save copied column snapshot");
+        test_assert(std::filesystem::file_size(shared_file) + count * sizeof(double) / 2 <
+                    std::filesystem::file_size(copied_file), "Shared column is written once");
+        auto restored = plotlib::PlotManager::load_snapshot(shared_file);
+        test_assert(restored && restored->render_to_buffer(actual) && actual == expected,
+                    "Shared column snapshot renders identically");
+        
+        std::filesystem::remove(shared_file);
+        std::filesystem::remove(copied_file);
+        std::filesystem::remove("test_output");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "Shared data columns");
+    }
+}
+
+void test_annotation_layer() {
+    try {
+        std::filesystem::create_directories("test_output");
+        std::vector<double> values(1000);
+        for (size_t i = 0; i < values.size(); ++i) values[i] = (i * 37) % 100;
+        LegendProbe plot(800, 600);
+        plot.add_histogram(values, "Latency", "blue", 20);
+        for (int i = 0; i < 2000; ++i) plot.add_vertical_line(i * 0.05, "Deploy", "red");
+        plot.add_horizontal_line(10.0, "Target", "green");
+        auto items = plot.legend_items();
+        test_assert(items.size() == 2 && items[0].label == "Deploy" && items[1].label == "Target",
+                    "Reference lines sharing a label share one legend entry");
+        
+        // Labels stacked on one point collide; labels elsewhere and off the plot are independent
+        for (int i = 0; i < 500; ++i) plot.add_annotation(50.0, 10.0, "Event " + std::to_string(i));
+        plot.add_annotation(10.0, 40.0, "Separate", "red");
+        plot.add_annotation(1e6, 10.0, "Off plot");
+        std::vector<unsigned char> expected, actual;
+        test_assert(plot.render_to_buffer(expected) && plot.get_annotation_count() == 502 &&
+                    plot.get_drawn_annotation_count() == 2, "Overlapping and off-plot annotations are culled");
+        
+        const std::string snapshot_file = "test_output/annotations.plsnap";
+        test_assert(plot.save_snapshot(snapshot_file), "Save annotated snapshot");
+        auto restored = plotlib::PlotManager::load_snapshot(snapshot_file);
+        test_assert(restored && restored->get_annotation_count() == 502 && restored->render_to_buffer(actual) &&
+                    actual == expected, "Annotations survive snapshots");
+        
+        plot.clear_annotations();
+        test_assert(plot.render_to_buffer(actual) && plot.get_drawn_annotation_count() == 0, "Clear annotations");
+        std::filesystem::remove(snapshot_file);
+        std::filesystem::remove("test_output");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "Annotation layer");
+    }
+}
+
+void test_compressed_line_series() {
+    try {
+        std::filesystem::create_directories("test_output");
+        // Regular telemetry: 10 s timestamps with occasional jitter, a gauge in steps of 0.5
+        const size_t count = 100000;
+        std::vector<double> timestamps(count), values(count);
+        for (size_t i = 0; i < count; ++i) {
+            timestamps[i] = 1700000000.0 + i * 10.0 + (i % 1000 == 0 ? 1.0 : 0.0);
+            values[i] = std::round((50.0 + 20.0 * std::sin(i * 0.001)) * 2.0) / 2.0;
+        }
+        plotlib::CompressedSeries series;
+        series.append(timestamps.data(), values.data(), 60000);
+        series.append(timestamps.data() + 60000, values.data() + 60000, count - 60000);
+        series.shrink_to_fit();
+        test_assert(series.size() == count && series.is_sorted() &&
+                    series.memory_bytes() * 3 < count * 2 * sizeof(double),
+                    "Regular telemetry compresses several-fold");
+        
+        // Non-integer X, NaN and negative zero take the XOR path and decode bit for bit
+        std::vector<double> mixed_x = {0.1, 0.2, 0.30000000000000004, -0.0, 5.0, 7.0, 1e300};
+        std::vector<double> mixed_y = {1.0, std::nan(""), -0.0, 1e-300, 3.5, 3.5, -2.0};
+        series.append(mixed_x.data(), mixed_y.data(), mixed_x.size());
+        std::vector<double> decoded_x, decoded_y, xs(plotlib::CompressedSeries::BLOCK_POINTS),
+            ys(plotlib::CompressedSeries::BLOCK_POINTS);
+        for (size_t b = 0; b < series.block_count(); ++b) {
+            size_t n = series.decode_block(b, xs.data(), ys.data());
+            decoded_x.insert(decoded_x.end(), xs.begin(), xs.begin() + n);
+            decoded_y.insert(decoded_y.end(), ys.begin(), ys.begin() + n);
+        }
+        timestamps.insert(timestamps.end(), mixed_x.begin(), mixed_x.end());
+        values.insert(values.end(), mixed_y.begin(), mixed_y.end());
+        test_assert(decoded_x.size() == timestamps.size() && !series.is_sorted() &&
+                    std::memcmp(decoded_x.data(), timestamps.data(), timestamps.size() * sizeof(double)) == 0 &&
+                    std::memcmp(decoded_y.data(), values.data(), values.size() * sizeof(double)) == 0,
+                    "Compressed series decode losslessly");
+        
+        // Small series draw every point, like add_line
+        std::vector<double> x = {1, 2, 3, 4, 5}, y = {2.5, 1.0, 4.25, 3.0, 5.5};
+        plotlib::LinePlot plain(400, 300), compressed(400, 300);
+        plain.add_line(x, y, "Series", "blue");
+        compressed.add_compressed_line(x, y, "Series", "blue");
+        std::vector<unsigned char> expected, actual;
+        test_assert(plain.render_to_buffer(expected) && compressed.render_to_buffer(actual) && actual == expected,
+                    "Compressed line renders like add_line");
+        
+        plotlib::LinePlot history(800, 400);
+        history.add_compressed_line(std::vector<double>(timestamps.begin(), timestamps.begin() + count),
+                                    std::vector<double>(values.begin(), values.begin() + count), "History");
+        test_assert(history.append_to_compressed_line(0, {1800000000.0}, {42.0}) &&
+                    history.get_compressed_line(0).size() == count + 1 && !history.append_to_compressed_line(1, {}, {}),
+                    "Append to compressed line");
+        
+        const std::string snapshot_file = "test_output/compressed.plsnap";
+        test_assert(history.render_to_buffer(expected) && history.save_snapshot(snapshot_file),
+                    "Save compressed line snapshot");
+        auto restored = plotlib::PlotManager::load_snapshot(snapshot_file);
+        test_assert(restored && restored->render_to_buffer(actual) && actual == expected,
+                    "Compressed lines survive snapshots");
+        std::filesystem::remove(snapshot_file);
+        std::filesystem::remove("test_output");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "Compressed line series");
+    }
+}
+
+class TransformCounter : public plotlib::ScatterPlot {
+public:
+    using plotlib::ScatterPlot::ScatterPlot;
+    size_t transforms = 0;
+    void transform_point(double data_x, double data_y, double& screen_x, double& screen_y) override {
+        ++transforms;
+        plotlib::ScatterPlot::transform_point(data_x, data_y, screen_x, screen_y);
+    }
+};
+
+void test_screen_coordinate_cache() {
+    try {
+        std::vector<double> x(2000), y(2000);
+        std::vector<int> labels(1000);
+        for (size_t i = 0; i < x.size(); ++i) {
+            x[i] = std::sin(i * 0.1) * i;
+            y[i] = std::cos(i * 0.1) * i;
+        }
+        for (size_t i = 0; i < labels.size(); ++i) labels[i] = static_cast<int>(i % 3) - 1;
+        
+        TransformCounter plot(600, 400);
+        plot.add_scatter(x, y, "Points", "blue");
+        plot.add_clusters(std::vector<double>(x.begin(), x.begin() + 1000),
+                          std::vector<double>(y.begin(), y.begin() + 1000), labels);
+        std::vector<unsigned char> first, restyled;
+        test_assert(plot.render_to_buffer(first) && plot.transforms >= 3000, "First render transforms every point");
+        
+        // Style and label changes keep the view, so points are not transformed again
+        plot.transforms = 0;
+        plot.set_title("Renamed");
+        plot.hide_legend_item("Points");
+        test_assert(plot.render_to_buffer(restyled) && plot.transforms < 100,
+                    "Style-only re-render skips the transform stage");
+        plot.show_all_legend_items();
+        plot.set_title("");
+        test_assert(plot.render_to_buffer(restyled) && restyled == first, "Cached coordinates render identically");
+        
+        // Points appended inside the current bounds are transformed on their own
+        plot.transforms = 0;
+        plot.append_to_series(0, {1.0, 2.0}, {1.0, -2.0});
+        test_assert(plot.render_to_buffer(restyled) && plot.transforms < 100, "Appends transform only new points");
+        
+        // A new view transforms everything again
+        plot.transforms = 0;
+        plot.set_bounds(-1000, 1000, -1000, 1000);
+        test_assert(plot.render_to_buffer(restyled) && plot.transforms >= 3000, "Changed bounds invalidate the cache");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "Screen coordinate cache");
+    }
+}
+
+class MarkerCounter : public plotlib::ScatterPlot {
+public:
+    using plotlib::ScatterPlot::ScatterPlot;
+    size_t markers = 0;
+    void draw_marker(cairo_t* cr, double x, double y, plotlib::MarkerType type, double size,
+                     double r, double g, double b, double alpha) override {
+        ++markers;
+        plotlib::ScatterPlot::draw_marker(cr, x, y, type, size, r, g, b, alpha);
+    }
+};
+
+void test_opaque_marker_dedup() {
+    try {
+        // 100 distinct positions, each repeated 50 times
+        std::vector<double> x, y;
+        for (int repeat = 0; repeat < 50; ++repeat) {
+            for (int i = 0; i < 100; ++i) {
+                x.push_back(i % 10);
+                y.push_back(i / 10);
+            }
+        }
+        
+        MarkerCounter plot(400, 300);
+        plot.set_legend_enabled(false);  // Count data markers only
+        plot.add_scatter(x, y, "Dense", "blue");
+        std::vector<unsigned char> translucent, opaque, repeated;
+        test_assert(plot.render_to_buffer(translucent) && plot.markers == x.size() &&
+                    plot.get_skipped_marker_count() == 0, "Translucent markers are all drawn");
+        
+        test_assert(!plot.set_series_alpha(1, 1.0) && !plot.set_series_alpha(0, 1.5), "Invalid alpha is rejected");
+        test_assert(plot.set_series_alpha(0, 1.0), "Series alpha set");
+        plot.markers = 0;
+        test_assert(plot.render_to_buffer(opaque) && plot.markers == 100 &&
+                    plot.get_skipped_marker_count() == x.size() - 100, "Opaque duplicates are skipped");
+        
+        // The occupancy bitmap is cleared after each pass
+        plot.markers = 0;
+        test_assert(plot.render_to_buffer(repeated) && plot.markers == 100 && repeated == opaque,
+                    "Re-render draws the same markers");
+        
+        // A second series is deduplicated on its own, so it still paints over the first
+        plot.add_scatter(x, y, "Overlay", "red");
+        plot.set_series_alpha(1, 1.0);
+        plot.markers = 0;
+        test_assert(plot.render_to_buffer(repeated) && plot.markers == 200, "Each series keeps its own markers");
+        
+        // Distinct sub-pixel positions are all kept
+        MarkerCounter spread(400, 300);
+        spread.set_legend_enabled(false);
+        std::vector<double> sx, sy;
+        for (int i = 0; i < 1000; ++i) {
+            sx.push_back(i);
+            sy.push_back(i % 7);
+        }
+        spread.add_scatter(sx, sy, "Spread", "green");
+        spread.set_series_alpha(0, 1.0);
+        test_assert(spread.render_to_buffer(repeated) && spread.markers + spread.get_skipped_marker_count() == 1000 &&
+                    spread.markers > 900, "Separated markers are not merged");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "Opaque marker deduplication");
+    }
+}
+
+// Largest distance of a vertex of xy from the simplified polyline through kept
+double simplification_error(const std::vector<float>& xy, const std::vector<size_t>& kept) {
+    double worst = 0.0;
+    for (size_t k = 1; k < kept.size(); ++k) {
+        double ax = xy[2 * kept[k - 1]], ay = xy[2 * kept[k - 1] + 1];
+        double bx = xy[2 * kept[k]], by = xy[2 * kept[k] + 1];
+        for (size_t i = kept[k - 1] + 1; i < kept[k]; ++i) {
+            double dx = bx - ax, dy = by - ay;
+            double t = std::max(0.0, std::min(1.0, ((xy[2 * i] - ax) * dx + (xy[2 * i + 1] - ay) * dy) /
+                                                   (dx * dx + dy * dy)));
+            worst = std::max(worst, std::hypot(ax + t * dx - xy[2 * i], ay + t * dy - xy[2 * i + 1]));
+        }
+    }
+    return worst;
+}
+
+void test_path_simplification() {
+    try {
+        plotlib::PathSimplifier simplifier;
+        
+        std::vector<float> straight;
+        for (int i = 0; i < 1000; ++i) {
+            straight.push_back(10.0f + i * 0.5f);
+            straight.push_back(20.0f + i * 0.25f);
+        }
+        const std::vector<size_t>& line = simplifier.simplify(straight.data(), 1000, 0.1);
+        test_assert(line.size() == 2 && line[0] == 0 && line[1] == 999, "Collinear vertices collapse to endpoints");
+        
+        // 100k samples of a wave across 700 pixels
+        std::vector<float> wave;
+        for (int i = 0; i < 100000; ++i) {
+            wave.push_back(50.0f + i * 0.007f);
+            wave.push_back(static_cast<float>(300.0 + 120.0 * std::sin(i * 0.0005) + 30.0 * std::sin(i * 0.0041)));
+        }
+        std::vector<size_t> kept = simplifier.simplify(wave.data(), 100000, 0.1);
+        test_assert(kept.size() > 10 && kept.size() < 5000 && kept.front() == 0 && kept.back() == 99999,
+                    "Dense wave keeps few vertices");
+        test_assert(simplification_error(wave, kept) <= 0.1 + 1e-4, "Simplified wave stays within tolerance");
+        test_assert(simplifier.simplify(wave.data(), 100000, 0.0).size() > kept.size(), "Zero tolerance keeps more");
+        
+        // Non-finite vertices stay in place, so path breaks are unchanged
+        straight[2 * 500 + 1] = std::nanf("");
+        const std::vector<size_t>& broken = simplifier.simplify(straight.data(), 1000, 0.1);
+        test_assert(broken.size() == 5 && broken[1] == 499 && broken[2] == 500 && broken[3] == 501,
+                    "Non-finite vertex splits the path");
+        
+        plotlib::LinePlot plot(800, 600);
+        bool rejected = false;
+        try {
+            plot.set_vector_tolerance(-1.0);
+        } catch (const std::invalid_argument&) {
+            rejected = true;
+        }
+        test_assert(rejected && plot.get_vector_tolerance() == 0.1, "Negative tolerance is rejected");
+        
+        std::vector<double> x(20000), y(20000);
+        for (size_t i = 0; i < x.size(); ++i) {
+            x[i] = i;
+            y[i] = std::sin(i * 0.001);
+        }
+        plot.add_line(x, y, "Wave", "blue");
+        plot.set_vector_tolerance(0.25);
+        std::string svg, full_svg;
+        test_assert(plot.save_svg_to_buffer(svg), "Simplified SVG export");
+        plot.set_vector_tolerance(0.0);
+        test_assert(plot.save_svg_to_buffer(full_svg) && svg.size() * 4 < full_svg.size(),
+                    "Simplified SVG is much smaller than the full path");
+        plot.set_vector_tolerance(0.25);
+        
+        // Pyramid-backed and compressed series are simplified too, not pixel-column decimated
+        std::filesystem::create_directories("test_output");
+        const std::string pyramid_file = "test_output/vector_tolerance.plpyr";
+        std::vector<plotlib::Point2D> points(x.size());
+        for (size_t i = 0; i < points.size(); ++i) points[i] = plotlib::Point2D(x[i], y[i]);
+        plotlib::SeriesPyramid::write(pyramid_file, points);
+        for (int kind = 0; kind < 2; ++kind) {
+            plotlib::LinePlot stored(800, 600);
+            if (kind == 0) {
+                stored.add_line_pyramid(pyramid_file, "Wave", "blue");
+            } else {
+                stored.add_compressed_line(x, y, "Wave", "blue");
+            }
+            std::string simplified, full;
+            bool exported = stored.save_svg_to_buffer(simplified);
+            stored.set_vector_tolerance(0.0);
+            exported = exported && stored.save_svg_to_buffer(full);
+            test_assert(exported && simplified.size() * 4 < full.size(),
+                        kind == 0 ? "Pyramid series is simplified in SVG" : "Compressed series is simplified in SVG");
+        }
+        std::filesystem::remove(pyramid_file);
+        
+        const std::string snapshot_file = "test_output/vector_tolerance.plsnap";
+        test_assert(plot.save_snapshot(snapshot_file), "Save line snapshot with tolerance");
+        auto restored = plotlib::PlotManager::load_snapshot(snapshot_file);
+        auto* restored_line = dynamic_cast<plotlib::LinePlot*>(restored.get());
+        test_assert(restored_line && restored_line->get_vector_tolerance() == 0.25, "Tolerance survives snapshots");
+        std::filesystem::remove(snapshot_file);
+        std::filesystem::remove("test_output");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "Path simplification");
+    }
+}
+
+class LineMarkerCounter : public plotlib::LinePlot {
+public:
+    using plotlib::LinePlot::LinePlot;
+    std::vector<double> xs;
+    void draw_marker(cairo_t* cr, double x, double y, plotlib::MarkerType type, double size,
+                     double r, double g, double b, double alpha) override {
+        xs.push_back(x);
+        plotlib::LinePlot::draw_marker(cr, x, y, type, size, r, g, b, alpha);
+    }
+};
+
+void test_marker_thinning() {
+    try {
+        std::vector<double> x(10000), y(10000);
+        for (size_t i = 0; i < x.size(); ++i) {
+            x[i] = i;
+            y[i] = 0.5;
+        }
+        
+        LineMarkerCounter plot(800, 600);
+        plot.set_legend_enabled(false);
+        plot.set_default_show_markers(true);
+        plot.add_line(x, y, "Dense", "blue");
+        std::vector<unsigned char> pixels;
+        test_assert(plot.is_marker_thinning_enabled() && plot.render_to_buffer(pixels) &&
+                    plot.xs.size() > 20 && plot.xs.size() < 300, "Dense line markers are thinned");
+        bool separated = true;
+        for (size_t i = 1; i < plot.xs.size(); ++i) {
+            if (plot.xs[i] - plot.xs[i - 1] < 2 * 3.0 - 1e-9) separated = false;
+        }
+        test_assert(separated && plot.get_skipped_marker_count() == x.size() - plot.xs.size(),
+                    "Thinned markers are a diameter apart");
+        
+        plot.set_marker_thinning(false);
+        plot.xs.clear();
+        test_assert(plot.render_to_buffer(pixels) && plot.xs.size() == x.size(), "Thinning can be disabled");
+        
+        // Sparse series keep every marker
+        LineMarkerCounter sparse(800, 600);
+        sparse.set_legend_enabled(false);
+        sparse.set_default_show_markers(true);
+        sparse.add_line({0, 1, 2, 3, 4, 5}, {0, 1, 0, 1, 0, 1}, "Sparse", "red");
+        test_assert(sparse.render_to_buffer(pixels) && sparse.xs.size() == 6, "Sparse markers are all drawn");
+        
+        std::filesystem::create_directories("test_output");
+        const std::string snapshot_file = "test_output/marker_thinning.plsnap";
+        test_assert(plot.save_snapshot(snapshot_file), "Save line snapshot without thinning");
+        auto restored = plotlib::PlotManager::load_snapshot(snapshot_file);
+        auto* restored_line = dynamic_cast<plotlib::LinePlot*>(restored.get());
+        test_assert(restored_line && !restored_line->is_marker_thinning_enabled(), "Thinning setting survives snapshots");
+        std::filesystem::remove(snapshot_file);
+        std::filesystem::remove("test_output");
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        test_assert(false, "Marker thinning");
+    }
+}
+
 int main() {
     std::cout << "=== PlotLib Basic Tests ===" << std::endl;
     std::cout << "Running basic functionality tests...\n" << std::endl;
@@ -196,6 +1404,27 @@ int main() {
     test_cluster_visualization();
     test_file_output();
     test_automatic_colors();
+    test_pyramid_file_round_trip();
+    test_trace_output();
+    test_render_quality();
+    test_progressive_render();
+    test_subplot_tile_cache();
+    test_shared_axes();
+    test_fonts_and_warm_up();
+    test_sub_pixel_histogram();
+    test_large_discrete_histogram();
+    test_integer_histogram();
+    test_apng_export();
+    test_html_export();
+    test_snapshot_round_trip();
+    test_render_cache();
+    test_shared_data_columns();
+    test_annotation_layer();
+    test_compressed_line_series();
+    test_screen_coordinate_cache();
+    test_opaque_marker_dedup();
+    test_path_simplification();
+    test_marker_thinning();
     
     // Print results
     std::cout << "\n=== Test Results ===" << std::endl;
@@ -0,0 +1,404 @@
+#include "scatter_plot.h"
+#include "line_plot.h"
+#include "histogram_plot.h"
+#include "allocation_counter.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+#include <filesystem>
+
+// Golden-image and performance-budget regression suite
+//
+// Every case renders a fixed plot into an in-memory buffer and compares it with
+// tests/golden/<case>.png using a per-channel tolerance. Each case also checks
+// the number of heap allocations of the first render and, when enabled, the
+// best render time of several repeated renders against its budget. Time budgets
+// depend on the machine, so they are off by default.
+//
+// Environment variables:
+//   PLOTLIB_UPDATE_GOLDEN=1   write the current output as the new golden images
+//   PLOTLIB_REQUIRE_GOLDEN=1  fail cases without a golden image (reference platform)
+//   PLOTLIB_SKIP_GOLDEN=1     skip image comparison (platforms other than the reference image)
+//   PLOTLIB_TIME_BUDGETS=1    check render time budgets
+//   PLOTLIB_BUDGET_SCALE=<x>  multiply all time budgets (e.g. 4 for Debug builds)
+//
+// Once the golden directory holds any recorded image, a case without one fails.
+
+#ifndef PLOTLIB_GOLDEN_DIR
+#define PLOTLIB_GOLDEN_DIR "golden"
+#endif
+
+// Simple test framework
+int test_count = 0;
+int passed_tests = 0;
+
+void test_assert(bool condition, const std::string& test_name) {
+    test_count++;
+    if (condition) {
+        std::cout << "✅ PASS: " << test_name << std::endl;
+        passed_tests++;
+    } else {
+        std::cout << "❌ FAIL: " << test_name << std::endl;
+    }
+}
+
+// Pixel comparison settings
+const int CHANNEL_TOLERANCE = 16;            // Max per-channel difference (0-255) for a matching pixel
+const double MAX_MISMATCH_FRACTION = 0.005;  // Max fraction of pixels allowed to exceed the tolerance
+const int TIMED_RENDERS = 3;                 // Repeated renders; the fastest one is checked
+
+/**
+ * @brief Type-erased handle for anything with render_to_buffer()
+ */
+struct Renderable {
+    virtual ~Renderable() = default;
+    virtual bool render(std::vector<unsigned char>& pixels) = 0;
+    virtual int width() const = 0;
+    virtual int height() const = 0;
+};
+
+template<typename PlotType>
+struct PlotRenderable : Renderable {
+    std::unique_ptr<PlotType> plot;
+
+    explicit PlotRenderable(std::unique_ptr<PlotType> p) : plot(std::move(p)) {}
+    bool render(std::vector<unsigned char>& pixels) override { return plot->render_to_buffer(pixels); }
+    int width() const override { return plot->get_width(); }
+    int height() const override { return plot->get_height(); }
+};
+
+template<typename PlotType>
+std::unique_ptr<Renderable> make_renderable(std::unique_ptr<PlotType> plot) {
+    return std::make_unique<PlotRenderable<PlotType>>(std::move(plot));
+}
+
+/**
+ * @brief How run_case treats the golden image of a case
+ */
+enum class GoldenMode {
+    OPTIONAL,  ///< Compare when a golden exists, otherwise skip (no goldens recorded yet)
+    REQUIRE,   ///< Compare, and fail when the golden is missing
+    UPDATE,    ///< Record the current output as the golden
+    SKIP       ///< Do not compare (non-reference platforms)
+};
+
+struct RegressionCase {
+    std::string name;                                    ///< Case name, also the golden file name
+    double time_budget_ms;                               ///< Budget for the fastest repeated render
+    size_t allocation_budget;                            ///< Budget for heap allocations of the first render
+    std::function<std::unique_ptr<Renderable>()> build;  ///< Builds the plot (not measured)
+};
+
+// Deterministic data (no std:: distributions, whose output differs between standard libraries)
+std::vector<double> wave(size_t count, double frequency, double phase, double scale) {
+    std::vector<double> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = scale * std::sin(frequency * i + phase) + 0.3 * scale * std::sin(7.3 * frequency * i);
+    }
+    return values;
+}
+
+std::vector<double> ramp(size_t count, double step) {
+    std::vector<double> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = i * step;
+    }
+    return values;
+}
+
+std::vector<RegressionCase> build_corpus() {
+    std::vector<RegressionCase> corpus;
+
+    corpus.push_back({"scatter_basic", 100.0, 200, [] {
+        auto plot = std::make_unique<plotlib::ScatterPlot>(800, 600);
+        plot->set_labels("Scatter", "X", "Y");
+        plot->add_scatter(ramp(50, 0.2), wave(50, 0.3, 0.0, 2.0), "Series A", "blue");
+        plot->add_scatter(ramp(50, 0.2), wave(50, 0.2, 1.0, 1.5), "Series B", "red");
+        return make_renderable(std::move(plot));
+    }});
+
+    corpus.push_back({"scatter_dense", 400.0, 200, [] {
+        auto plot = std::make_unique<plotlib::ScatterPlot>(800, 600);
+        plot->set_labels("Dense Scatter", "X", "Y");
+        plot->add_scatter(wave(20000, 0.0137, 0.5, 5.0), wave(20000, 0.0071, 0.0, 3.0), "Dense", "green");
+        return make_renderable(std::move(plot));
+    }});
+
+    corpus.push_back({"scatter_dense_draft", 150.0, 200, [] {
+        auto plot = std::make_unique<plotlib::ScatterPlot>(800, 600);
+        plot->set_labels("Dense Scatter (Draft)", "X", "Y");
+        plot->set_render_quality(plotlib::RenderQuality::DRAFT);
+        plot->add_scatter(wave(100000, 0.0137, 0.5, 5.0), wave(100000, 0.0071, 0.0, 3.0), "Dense", "green");
+        return make_renderable(std::move(plot));
+    }});
+
+    corpus.push_back({"scatter_clusters", 150.0, 400, [] {
+        auto plot = std::make_unique<plotlib::ScatterPlot>(800, 600);
+        plot->set_labels("Clusters", "X", "Y");
+        std::vector<double> x = wave(600, 0.05, 0.0, 4.0);
+        std::vector<double> y = wave(600, 0.031, 0.7, 4.0);
+        std::vector<int> labels(600);
+        for (size_t i = 0; i < labels.size(); ++i) {
+            labels[i] = (i % 17 == 0) ? -1 : static_cast<int>(i % 3);
+        }
+        plot->add_clusters(x, y, labels);
+        return make_renderable(std::move(plot));
+    }});
+
+    corpus.push_back({"line_markers_reference_lines", 100.0, 300, [] {
+        auto plot = std::make_unique<plotlib::LinePlot>(800, 600);
+        plot->set_labels("Lines", "Time", "Value");
+        plot->set_default_show_markers(true);
+        plot->add_line(ramp(40, 0.25), wave(40, 0.25, 0.0, 1.0), "Signal", "purple");
+        plot->add_line(ramp(40, 0.25), wave(40, 0.15, 2.0, 0.8), "Baseline", "orange");
+        plot->add_horizontal_line(0.5, "Threshold", "red");
+        plot->add_vertical_line(5.0, "Event", "black");
+        return make_renderable(std::move(plot));
+    }});
+
+    corpus.push_back({"line_long_series", 300.0, 200, [] {
+        auto plot = std::make_unique<plotlib::LinePlot>(1200, 400);
+        plot->set_labels("Long Series", "Sample", "Value");
+        plot->add_line(ramp(100000, 1.0), wave(100000, 0.0007, 0.0, 10.0), "Telemetry", "blue");
+        return make_renderable(std::move(plot));
+    }});
+
+    corpus.push_back({"histogram_continuous", 100.0, 200, [] {
+        auto plot = std::make_unique<plotlib::HistogramPlot>(800, 600);
+        plot->set_labels("Distribution", "Value", "Frequency");
+        plot->add_histogram(wave(5000, 0.37, 0.0, 3.0), "Values", "green", 40);
+        return make_renderable(std::move(plot));
+    }});
+
+    corpus.push_back({"histogram_fine_bins", 100.0, 200, [] {
+        auto plot = std::make_unique<plotlib::HistogramPlot>(800, 600);
+        plot->set_labels("Fine-Grained Distribution", "Value", "Frequency");
+        plot->set_bin_envelope(true);
+        plot->add_histogram(wave(200000, 0.37, 0.0, 3.0), "Values", "blue", 100000);
+        return make_renderable(std::move(plot));
+    }});
+
+    corpus.push_back({"histogram_discrete", 100.0, 300, [] {
+        auto plot = std::make_unique<plotlib::HistogramPlot>(800, 600);
+        plot->set_labels("Categories", "Category", "Count");
+        plot->add_histogram({12, 30, 7, 22, 15}, {"Alpha", "Beta", "Gamma", "Delta", "Epsilon"});
+        plot->add_horizontal_line(20.0, "Target", "red");
+        return make_renderable(std::move(plot));
+    }});
+
+    corpus.push_back({"empty_plot", 50.0, 100, [] {
+        auto plot = std::make_unique<plotlib::ScatterPlot>(800, 600);
+        plot->set_labels("Nothing Here", "X", "Y");
+        return make_renderable(std::move(plot));
+    }});
+
+    corpus.push_back({"subplot_dashboard", 300.0, 1000, [] {
+        auto manager = std::make_unique<plotlib::SubplotManager>(2, 2, 1200, 900);
+        manager->set_main_title("Dashboard");
+        auto& scatter = manager->get_subplot<plotlib::ScatterPlot>(0, 0);
+        scatter.set_labels("Scatter", "X", "Y");
+        scatter.add_scatter(ramp(200, 0.05), wave(200, 0.1, 0.0, 1.0), "Points", "blue");
+        auto& line = manager->get_subplot<plotlib::LinePlot>(0, 1);
+        line.set_labels("Line", "T", "V");
+        line.add_line(ramp(500, 0.02), wave(500, 0.05, 0.3, 2.0), "Trace", "red");
+        auto& hist = manager->get_subplot<plotlib::HistogramPlot>(1, 0);
+        hist.set_labels("Histogram", "Value", "Frequency");
+        hist.add_histogram(wave(2000, 0.77, 0.0, 1.0), "Values", "orange", 25);
+        auto& empty = manager->get_subplot<plotlib::ScatterPlot>(1, 1);
+        empty.set_labels("Empty", "X", "Y");
+        return make_renderable(std::move(manager));
+    }});
+
+    return corpus;
+}
+
+bool write_png(const std::string& filename, std::vector<unsigned char>& pixels, int width, int height) {
+    cairo_surface_t* surface = cairo_image_surface_create_for_data(pixels.data(), CAIRO_FORMAT_ARGB32,
+                                                                   width, height, width * 4);
+    cairo_status_t status = cairo_surface_write_to_png(surface, filename.c_str());
+    cairo_surface_destroy(surface);
+    return status == CAIRO_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Compare a rendered buffer against a golden PNG
+ * @return Fraction of pixels exceeding the channel tolerance, or -1 if the golden is unusable
+ */
+double compare_with_golden(const std::string& golden_file, const std::vector<unsigned char>& pixels,
+                           int width, int height, std::vector<unsigned char>& diff_mask) {
+    cairo_surface_t* golden = cairo_image_surface_create_from_png(golden_file.c_str());
+    if (cairo_surface_status(golden) != CAIRO_STATUS_SUCCESS ||
+        cairo_image_surface_get_width(golden) != width ||
+        cairo_image_surface_get_height(golden) != height) {
+        cairo_surface_destroy(golden);
+        return -1.0;
+    }
+
+    // PNGs without alpha load as RGB24, whose alpha byte is undefined
+    bool compare_alpha = cairo_image_surface_get_format(golden) == CAIRO_FORMAT_ARGB32;
+    const unsigned char* golden_data = cairo_image_surface_get_data(golden);
+    int golden_stride = cairo_image_surface_get_stride(golden);
+
+    diff_mask.assign(pixels.size(), 0);
+    size_t mismatches = 0;
+    for (int row = 0; row < height; ++row) {
+        const uint32_t* expected = reinterpret_cast<const uint32_t*>(golden_data + static_cast<size_t>(row) * golden_stride);
+        const uint32_t* actual = reinterpret_cast<const uint32_t*>(pixels.data() + static_cast<size_t>(row) * width * 4);
+        uint32_t* diff = reinterpret_cast<uint32_t*>(diff_mask.data() + static_cast<size_t>(row) * width * 4);
+
+        for (int col = 0; col < width; ++col) {
+            int max_delta = 0;
+            for (int shift = 0; shift < (compare_alpha ? 32 : 24); shift += 8) {
+                int delta = std::abs(static_cast<int>((expected[col] >> shift) & 0xff) -
+                                     static_cast<int>((actual[col] >> shift) & 0xff));
+                max_delta = std::max(max_delta, delta);
+            }
+            if (max_delta > CHANNEL_TOLERANCE) {
+                ++mismatches;
+                diff[col] = 0xffff0000;  // Opaque red marks a mismatching pixel
+            } else {
+                diff[col] = 0xffffffff;
+            }
+        }
+    }
+
+    cairo_surface_destroy(golden);
+    return static_cast<double>(mismatches) / (static_cast<double>(width) * height);
+}
+
+/**
+ * @brief Whether the golden directory holds any recorded image
+ */
+bool goldens_recorded() {
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(PLOTLIB_GOLDEN_DIR, error)) {
+        if (entry.path().extension() == ".png") return true;
+    }
+    return false;
+}
+
+void run_case(const RegressionCase& test_case, GoldenMode golden_mode, bool check_time, double budget_scale) {
+    std::unique_ptr<Renderable> plot = test_case.build();
+    int width = plot->width();
+    int height = plot->height();
+
+    std::vector<unsigned char> pixels;
+    pixels.reserve(static_cast<size_t>(width) * height * 4);
+
+    // First render: allocation budget
+    bool rendered;
+    size_t allocations;
+    {
+        alloc_counter::AllocationScope scope;
+        rendered = plot->render(pixels);
+        allocations = scope.count();
+    }
+    test_assert(rendered, test_case.name + ": render to buffer");
+    if (!rendered) return;
+
+    test_assert(allocations <= test_case.allocation_budget,
+                test_case.name + ": allocation budget (" + std::to_string(allocations) + " <= " +
+                std::to_string(test_case.allocation_budget) + ")");
+
+    // Repeated renders: time budget on the fastest one
+    if (check_time) {
+        double best_ms = 0.0;
+        for (int i = 0; i < TIMED_RENDERS; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            plot->render(pixels);
+            auto end = std::chrono::steady_clock::now();
+            double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+            best_ms = (i == 0) ? elapsed : std::min(best_ms, elapsed);
+        }
+        double time_budget = test_case.time_budget_ms * budget_scale;
+        test_assert(best_ms <= time_budget,
+                    test_case.name + ": render time budget (" + std::to_string(best_ms) + " ms <= " +
+                    std::to_string(time_budget) + " ms)");
+    }
+
+    // Golden image comparison
+    std::string golden_file = std::string(PLOTLIB_GOLDEN_DIR) + "/" + test_case.name + ".png";
+    if (golden_mode == GoldenMode::UPDATE) {
+        test_assert(write_png(golden_file, pixels, width, height), test_case.name + ": golden image updated");
+        return;
+    }
+    if (golden_mode == GoldenMode::SKIP) {
+        return;
+    }
+    if (!std::filesystem::exists(golden_file)) {
+        if (golden_mode == GoldenMode::REQUIRE) {
+            test_assert(false, test_case.name + ": golden image exists (run with PLOTLIB_UPDATE_GOLDEN=1 to record)");
+        } else {
+            std::cout << "⚠️  SKIP: " << test_case.name << ": no golden image (run with PLOTLIB_UPDATE_GOLDEN=1 to record)" << std::endl;
+        }
+        return;
+    }
+
+    std::vector<unsigned char> diff_mask;
+    double mismatch = compare_with_golden(golden_file, pixels, width, height, diff_mask);
+    bool matches = mismatch >= 0.0 && mismatch <= MAX_MISMATCH_FRACTION;
+    test_assert(matches, test_case.name + ": matches golden image (" +
+                (mismatch < 0.0 ? std::string("unreadable or size mismatch") :
+                 std::to_string(mismatch * 100.0) + "% pixels differ)"));
+
+    if (!matches) {
+        // Keep the actual output and a diff mask next to the test binary for review
+        std::filesystem::create_directories("regression_output");
+        write_png("regression_output/" + test_case.name + ".png", pixels, width, height);
+        if (!diff_mask.empty()) {
+            write_png("regression_output/" + test_case.name + ".diff.png", diff_mask, width, height);
+        }
+    }
+}
+
+int main() {
+    std::cout << "=== PlotLib Regression Tests ===" << std::endl;
+
+    const char* update_env = std::getenv("PLOTLIB_UPDATE_GOLDEN");
+    const char* require_env = std::getenv("PLOTLIB_REQUIRE_GOLDEN");
+    const char* skip_env = std::getenv("PLOTLIB_SKIP_GOLDEN");
+    GoldenMode golden_mode = GoldenMode::OPTIONAL;
+    if (update_env != nullptr && std::string(update_env) == "1") {
+        golden_mode = GoldenMode::UPDATE;
+    } else if (skip_env != nullptr && std::string(skip_env) == "1") {
+        golden_mode = GoldenMode::SKIP;
+        std::cout << "Skipping golden image comparison (PLOTLIB_SKIP_GOLDEN=1)\n" << std::endl;
+    } else if ((require_env != nullptr && std::string(require_env) == "1") || goldens_recorded()) {
+        golden_mode = GoldenMode::REQUIRE;
+    }
+
+    const char* time_env = std::getenv("PLOTLIB_TIME_BUDGETS");
+    bool check_time = time_env != nullptr && std::string(time_env) == "1";
+
+    double budget_scale = 1.0;
+    if (const char* scale_env = std::getenv("PLOTLIB_BUDGET_SCALE")) {
+        budget_scale = std::max(0.01, std::atof(scale_env));
+    }
+
+    if (golden_mode == GoldenMode::UPDATE) {
+        std::filesystem::create_directories(PLOTLIB_GOLDEN_DIR);
+        std::cout << "Recording golden images in " << PLOTLIB_GOLDEN_DIR << "\n" << std::endl;
+    }
+
+    for (const auto& test_case : build_corpus()) {
+        run_case(test_case, golden_mode, check_time, budget_scale);
+    }
+
+    // Print results
+    std::cout << "\n=== Test Results ===" << std::endl;
+    std::cout << "Passed: " << passed_tests << "/" << test_count << " tests" << std::endl;
+
+    if (passed_tests == test_count) {
+        std::cout << "🎉 All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "❌ Some tests failed!" << std::endl;
+        return 1;
+    }
+}